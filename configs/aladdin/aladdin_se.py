@@ -71,6 +71,8 @@ def addAladdinOptions(parser):
         help="Aladdin accelerator configuration file.")
     parser.add_option("--aladdin-debugger", action="store_true",
         help="Run the Aladdin debugger on accelerator initialization.")
+    parser.add_option("--iommu", action="store_true",
+        help="Add an IOMMU that accelerators can translate through.")
 
 def get_processes(options):
     """Interprets provided options and returns a list of processes"""
@@ -287,6 +289,8 @@ if options.accel_cfg_file:
     datapaths.append(datapath)
   for datapath in datapaths:
     setattr(system, datapath.acceleratorName, datapath)
+  if options.iommu:
+    system.iommu = IOMMU()
 
 if options.simpoint_profile:
     if not CpuConfig.is_atomic_cpu(TestCPUClass):
@@ -714,7 +714,8 @@ def makeDistRoot(testSystem,
                  sync_start,
                  linkspeed,
                  linkdelay,
-                 dumpfile):
+                 dumpfile,
+                 transport = 'tcp'):
     self = Root(full_system = True)
     self.testsys = testSystem
 
@@ -725,7 +726,8 @@ def makeDistRoot(testSystem,
                                    server_name = server_name,
                                    server_port = server_port,
                                    sync_start = sync_start,
-                                   sync_repeat = sync_repeat)
+                                   sync_repeat = sync_repeat,
+                                   dist_transport = transport)
 
     if hasattr(testSystem, 'realview'):
         self.etherlink.int0 = Parent.testsys.realview.ethernet.interface
@@ -211,6 +211,12 @@ def add_options(parser):
     parser.add_argument("--num-lanes-per-link", default=16, action="store",
                         type=int, help="Number of lanes per each link")
 
+    # Packets crossing a serial link within this window are sent from a
+    # single event, trading event count for header-delay annotated timing
+    parser.add_argument("--link-batch-window", default='0ns', type=str,
+                        help="Serialization window within which the serial\
+                        links send packets together")
+
     # Number of serial links [1]
     parser.add_argument("--num-serial-links", default=4, action="store",
                         type=int, help="Number of serial links")
@@ -234,7 +240,8 @@ def add_options(parser):
     parser.add_argument("--enable-link-monitor", action="store_true",
                         help="The link monitors")
 
-    # link aggregator enable - put a cross between buffers & links
+    # link aggregator enable - put an HMC controller between the port and
+    # the serial links, spreading the requests over them (arch "same" only)
     parser.add_argument("--enable-link-aggr", action="store_true", help="The\
                         crossbar between port and Link Controller")
 
@@ -336,10 +343,30 @@ def config_hmc_host_ctrl(opt, system):
                      resp_size=opt.link_buffer_size_rsp,
                      num_lanes=opt.num_lanes_per_link,
                      link_speed=opt.serial_link_speed,
+                     batch_window=opt.link_batch_window,
                      delay=opt.total_ctrl_latency) for i in
           xrange(opt.num_serial_links)]
     system.hmc_host.seriallink = sl
 
+    # Link aggregator spreading the requests over the serial links, which
+    # must all cover the whole cube. Its per-vault stats rely on the vault
+    # geometry of the device
+    if opt.enable_link_aggr:
+        if opt.arch != "same":
+            fatal("The link aggregator needs serial links with the same "
+                  "range, use --arch=same")
+        system.hmc_host.link_aggr = HMCController(
+            num_vaults=opt.hmc_dev_num_vaults,
+            vault_size=opt.hmc_dev_vault_size,
+            width=opt.xbar_width,
+            frontend_latency=opt.xbar_frontend_latency,
+            forward_latency=opt.xbar_forward_latency,
+            response_latency=opt.xbar_response_latency)
+        clk = opt.link_controller_frequency
+        vd = VoltageDomain(voltage='1V')
+        scd = SrcClockDomain(clock=clk, voltage_domain=vd)
+        system.hmc_host.link_aggr.clk_domain = scd
+
     # enable global monitor
     if opt.enable_global_monitor:
         system.hmc_host.lmonitor = [CommMonitor() for i in
@@ -378,6 +405,11 @@ def config_hmc_host_ctrl(opt, system):
         for i in xrange(opt.num_links_controllers):
             if opt.enable_global_monitor:
                 hh.lmonitor[i].master = hh.seriallink[i].slave
+            if opt.enable_link_aggr:
+                if opt.enable_global_monitor:
+                    hh.link_aggr.master = hh.lmonitor[i].slave
+                else:
+                    hh.link_aggr.master = hh.seriallink[i].slave
 
     return system
 
@@ -217,6 +217,10 @@ def addCommonOptions(parser):
                       default=2200,
                       action="store", type="int",
                       help="Message server listen port\nDEFAULT: 2200")
+    parser.add_option("--dist-transport",
+                      default="tcp", type="choice", choices=["tcp", "shm"],
+                      help="Transport among dist-gem5 processes, shm if "\
+                      "they all run on the same host\nDEFAULT: tcp")
     parser.add_option("--dist-sync-repeat",
                       default="0us",
                       action="store", type="string",
@@ -341,7 +341,8 @@ elif len(bm) == 1 and options.dist:
                         options.dist_sync_start,
                         options.ethernet_linkspeed,
                         options.ethernet_linkdelay,
-                        options.etherdump);
+                        options.etherdump,
+                        options.dist_transport);
 elif len(bm) == 1:
     root = Root(full_system=True, system=test_sys)
 else:
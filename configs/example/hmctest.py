@@ -82,11 +82,21 @@ def build_system(options):
         system.system_port = system.membus.slave
     if options.arch == "same":
         hh = system.hmc_host
-        for i in xrange(options.num_links_controllers):
-            if options.enable_global_monitor:
-                system.tgen[i].port = hh.lmonitor[i].slave
-            else:
-                system.tgen[i].port = hh.seriallink[i].slave
+        if options.enable_link_aggr:
+            # the link aggregator has a single slave port
+            system.tgen_xbar = NoncoherentXBar(width=options.xbar_width,
+                                               frontend_latency=1,
+                                               forward_latency=1,
+                                               response_latency=1)
+            for i in xrange(options.num_tgen):
+                system.tgen[i].port = system.tgen_xbar.slave
+            system.tgen_xbar.master = hh.link_aggr.slave
+        else:
+            for i in xrange(options.num_links_controllers):
+                if options.enable_global_monitor:
+                    system.tgen[i].port = hh.lmonitor[i].slave
+                else:
+                    system.tgen[i].port = hh.seriallink[i].slave
     # set up the root SimObject
     root = Root(full_system=False, system=system)
     return root
@@ -62,6 +62,9 @@ parser.add_option("-a", "--atomic", action="store_true",
                   help="Use atomic (non-timing) mode")
 parser.add_option("-b", "--blocking", action="store_true",
                   help="Use blocking caches")
+parser.add_option("--mshrs", type="int", default=4,
+                  help="Number of MSHRs in the L1 caches, scaled for "
+                  "each additional level [default: %default]")
 parser.add_option("-l", "--maxloads", metavar="N", default=0,
                   help="Stop after N loads")
 parser.add_option("-m", "--maxtick", type="int", default=m5.MaxTick,
@@ -187,7 +190,7 @@ proto_l1 = Cache(size = '32kB', assoc = 4,
 if options.blocking:
      proto_l1.mshrs = 1
 else:
-     proto_l1.mshrs = 4
+     proto_l1.mshrs = options.mshrs
 
 cache_proto = [proto_l1]
 
@@ -150,7 +150,7 @@ namespace HsailISA
 
         // if all work-items have completed, then wave-front is done
         if (w->initMask.none()) {
-            w->status = Wavefront::S_STOPPED;
+            w->setStatus(Wavefront::S_STOPPED);
 
             int32_t refCount = w->computeUnit->getLds().
                                    decreaseRefCounter(w->dispatchId, w->wgId);
@@ -184,7 +184,7 @@ namespace HsailISA
                 setFlag(GlobalSegment);
                 // Notify Memory System of Kernel Completion
                 // Kernel End = isKernel + isRelease
-                w->status = Wavefront::S_RETURNING;
+                w->setStatus(Wavefront::S_RETURNING);
                 GPUDynInstPtr local_mempacket = gpuDynInst;
                 local_mempacket->useContinuation = false;
                 local_mempacket->simdId = w->simdId;
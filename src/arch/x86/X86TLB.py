@@ -49,11 +49,21 @@ class X86PagetableWalker(MemObject):
     system = Param.System(Parent.any, "system object")
     num_squash_per_cycle = Param.Unsigned(4,
             "Number of outstanding walks that can be squashed per cycle")
+    # Paging-structure caches, long mode only. A size of 0 disables the
+    # cache; a few PML4 and PDP entries and a few dozen PDE entries are
+    # typical.
+    pml4_cache_size = Param.Unsigned(0, "Number of PML4 cache entries")
+    pdp_cache_size = Param.Unsigned(0, "Number of PDP cache entries")
+    pde_cache_size = Param.Unsigned(0, "Number of PDE cache entries")
 
 class X86TLB(BaseTLB):
     type = 'X86TLB'
     cxx_class = 'X86ISA::TLB'
     cxx_header = 'arch/x86/tlb.hh'
     size = Param.Unsigned(64, "TLB size")
+    assoc = Param.Unsigned(0, "TLB associativity, 0 for a fully associative "
+        "TLB with true LRU replacement")
+    plru = Param.Bool(True, "Use tree pseudo-LRU replacement within the sets "
+        "of a set-associative TLB, true LRU otherwise")
     walker = Param.X86PagetableWalker(\
             X86PagetableWalker(), "page table walker")
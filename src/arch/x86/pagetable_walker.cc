@@ -66,13 +66,114 @@
 
 namespace X86ISA {
 
+Walker::WalkCache::WalkCache(unsigned size)
+    : entries(size), useCount(0)
+{
+    flush();
+}
+
+const Walker::WalkCache::Entry *
+Walker::WalkCache::lookup(Addr cr3, Addr tag)
+{
+    for (auto &e : entries) {
+        if (e.valid && e.cr3 == cr3 && e.tag == tag) {
+            e.lastUse = ++useCount;
+            return &e;
+        }
+    }
+    return NULL;
+}
+
+void
+Walker::WalkCache::insert(const Entry &entry)
+{
+    Entry *victim = &entries[0];
+    for (auto &e : entries) {
+        if (e.valid && e.cr3 == entry.cr3 && e.tag == entry.tag) {
+            victim = &e;
+            break;
+        }
+        if (!e.valid || e.lastUse < victim->lastUse)
+            victim = &e;
+        if (!e.valid)
+            break;
+    }
+    *victim = entry;
+    victim->lastUse = ++useCount;
+}
+
+void
+Walker::WalkCache::flush()
+{
+    for (auto &e : entries)
+        e.valid = false;
+}
+
+void
+Walker::flushWalkCaches()
+{
+    pml4Cache.flush();
+    pdpCache.flush();
+    pdeCache.flush();
+}
+
+void
+Walker::regStats()
+{
+    MemObject::regStats();
+
+    using namespace Stats;
+
+    walks
+        .name(name() + ".walks")
+        .desc("Table walks started");
+
+    walksCoalesced
+        .name(name() + ".walksCoalesced")
+        .desc("Translations finished by a walk for the same page");
+
+    pml4CacheHits
+        .name(name() + ".pml4CacheHits")
+        .desc("Walks starting from a PML4 cache hit");
+
+    pdpCacheHits
+        .name(name() + ".pdpCacheHits")
+        .desc("Walks starting from a PDP cache hit");
+
+    pdeCacheHits
+        .name(name() + ".pdeCacheHits")
+        .desc("Walks starting from a PDE cache hit");
+
+    walkWaitTime
+        .init(16)
+        .name(name() + ".walkWaitTime")
+        .desc("Ticks a timing walk waits before it starts")
+        .flags(nozero);
+
+    walkServiceTime
+        .init(16)
+        .name(name() + ".walkServiceTime")
+        .desc("Ticks from the start to the end of a timing walk")
+        .flags(nozero);
+}
+
 Fault
 Walker::start(ThreadContext * _tc, BaseTLB::Translation *_translation,
               const RequestPtr &_req, BaseTLB::Mode _mode)
 {
-    // TODO: in timing mode, instead of blocking when there are other
-    // outstanding requests, see if this request can be coalesced with
-    // another one (i.e. either coalesce or start walk)
+    // In timing mode, a request for a page that is already being
+    // walked, or queued for a walk, is finished along with that walk
+    for (auto state : currStates) {
+        if (state->canCoalesce(_tc, _req->getVaddr())) {
+            DPRINTF(PageTableWalker, "Coalescing walk for address %#x\n",
+                    _req->getVaddr());
+            state->followers.push_back(
+                {_translation, _req, _tc, _mode, curTick()});
+            walksCoalesced++;
+            return NoFault;
+        }
+    }
+
     WalkerState * newState = new WalkerState(this, _translation, _req);
     newState->initState(_tc, _mode, sys->isTimingMode());
     if (currStates.size()) {
@@ -122,6 +223,11 @@ Walker::recvTimingResp(PacketPtr pkt)
                 break;
             }
         }
+        // If the walk faulted, the translations coalesced with it
+        // need a walk of their own, which goes first
+        WalkerState *heir = senderWalk->detachFollowers();
+        if (heir)
+            currStates.push_front(heir);
         delete senderWalk;
         // Since we block requests when another is outstanding, we
         // need to check if there is a waiting request to be serviced
@@ -205,6 +311,11 @@ Walker::startWalkWrapper()
             std::make_shared<UnimpFault>("Squashed Inst"),
             currState->req, currState->tc, currState->mode);
 
+        // the coalesced translations still need a walk
+        WalkerState *heir = currState->detachFollowers();
+        if (heir)
+            currStates.push_front(heir);
+
         // delete the current request
         delete currState;
 
@@ -224,8 +335,11 @@ Walker::WalkerState::startWalk()
     Fault fault = NoFault;
     assert(!started);
     started = true;
+    startTick = curTick();
+    walker->walks++;
     setupWalk(req->getVaddr());
     if (timing) {
+        walker->walkWaitTime.sample(startTick - enqueueTick);
         nextState = state;
         state = Waiting;
         timingFault = NoFault;
@@ -304,6 +418,8 @@ Walker::WalkerState::stepWalk(PacketPtr &write)
             break;
         }
         entry.noExec = pte.nx;
+        cacheTable(walker->pml4Cache, bits(vaddr, 47, 39),
+                   (uint64_t)pte & (mask(40) << 12), uncacheable);
         nextState = LongPDP;
         break;
       case LongPDP:
@@ -319,6 +435,8 @@ Walker::WalkerState::stepWalk(PacketPtr &write)
             fault = pageFault(pte.p);
             break;
         }
+        cacheTable(walker->pdpCache, bits(vaddr, 47, 30),
+                   (uint64_t)pte & (mask(40) << 12), uncacheable);
         nextState = LongPD;
         break;
       case LongPD:
@@ -338,6 +456,8 @@ Walker::WalkerState::stepWalk(PacketPtr &write)
             entry.logBytes = 12;
             nextRead =
                 ((uint64_t)pte & (mask(40) << 12)) + vaddr.longl1 * dataSize;
+            cacheTable(walker->pdeCache, bits(vaddr, 47, 21),
+                       (uint64_t)pte & (mask(40) << 12), uncacheable);
             nextState = LongPTE;
             break;
         } else {
@@ -549,11 +669,41 @@ Walker::WalkerState::setupWalk(Addr vaddr)
     Efer efer = tc->readMiscRegNoEffect(MISCREG_EFER);
     dataSize = 8;
     Addr topAddr;
+    const WalkCache::Entry *cached = NULL;
+    this->cr3 = cr3;
     if (efer.lma) {
         // Do long mode.
-        state = LongPML4;
-        topAddr = (cr3.longPdtb << 12) + addr.longl4 * dataSize;
         enableNX = efer.nxe;
+        // Start from the lowest level table found in the
+        // paging-structure caches, if any
+        if (functional) {
+            // functional walks leave the caches alone
+        } else if ((cached = walker->pdeCache.lookup(cr3,
+                        bits(vaddr, 47, 21)))) {
+            walker->pdeCacheHits++;
+            state = LongPTE;
+            entry.logBytes = 12;
+            topAddr = cached->table + addr.longl1 * dataSize;
+        } else if ((cached = walker->pdpCache.lookup(cr3,
+                        bits(vaddr, 47, 30)))) {
+            walker->pdpCacheHits++;
+            state = LongPD;
+            topAddr = cached->table + addr.longl2 * dataSize;
+        } else if ((cached = walker->pml4Cache.lookup(cr3,
+                        bits(vaddr, 47, 39)))) {
+            walker->pml4CacheHits++;
+            state = LongPDP;
+            topAddr = cached->table + addr.longl3 * dataSize;
+        }
+
+        if (cached) {
+            entry.writable = cached->writable;
+            entry.user = cached->user;
+            entry.noExec = cached->noExec;
+        } else {
+            state = LongPML4;
+            topAddr = (cr3.longPdtb << 12) + addr.longl4 * dataSize;
+        }
     } else {
         // We're in some flavor of legacy mode.
         CR4 cr4 = tc->readMiscRegNoEffect(MISCREG_CR4);
@@ -580,7 +730,7 @@ Walker::WalkerState::setupWalk(Addr vaddr)
     entry.vaddr = vaddr;
 
     Request::Flags flags = Request::PHYSICAL;
-    if (cr3.pcd)
+    if (cached ? cached->uncacheable : (bool)cr3.pcd)
         flags.set(Request::UNCACHEABLE);
 
     RequestPtr request = std::make_shared<Request>(
@@ -635,10 +785,21 @@ Walker::WalkerState::recvPacket(PacketPtr pkt)
             assert(!delayedResponse);
             // Let the CPU continue.
             translation->finish(fault, req, tc, mode);
+
+            // The coalesced translations are to the same page, so
+            // they hit in the TLB as well
+            for (auto &f : followers) {
+                fault = walker->tlb->translate(f.req, f.tc, NULL, f.mode,
+                                               delayedResponse, true);
+                assert(!delayedResponse);
+                f.translation->finish(fault, f.req, f.tc, f.mode);
+            }
+            followers.clear();
         } else {
             // There was a fault during the walk. Let the CPU know.
             translation->finish(timingFault, req, tc, mode);
         }
+        walker->walkServiceTime.sample(curTick() - startTick);
         return true;
     }
 
@@ -703,6 +864,39 @@ Walker::WalkerState::retry()
     sendPackets();
 }
 
+bool
+Walker::WalkerState::canCoalesce(ThreadContext *_tc, Addr vaddr) const
+{
+    return tc == _tc && (req->getVaddr() >> PageShift) == (vaddr >> PageShift);
+}
+
+Walker::WalkerState *
+Walker::WalkerState::detachFollowers()
+{
+    if (followers.empty())
+        return NULL;
+
+    const Follower &first = followers.front();
+    WalkerState *heir = new WalkerState(walker, first.translation,
+                                        first.req);
+    heir->initState(first.tc, first.mode, timing);
+    heir->enqueueTick = first.enqueueTick;
+    heir->followers.assign(followers.begin() + 1, followers.end());
+    followers.clear();
+    return heir;
+}
+
+void
+Walker::WalkerState::cacheTable(WalkCache &cache, Addr tag, Addr table,
+                                bool uncacheable)
+{
+    if (functional || !cache.enabled())
+        return;
+
+    cache.insert({true, cr3, tag, table, entry.writable, entry.user,
+                  entry.noExec, uncacheable, 0});
+}
+
 Fault
 Walker::WalkerState::pageFault(bool present)
 {
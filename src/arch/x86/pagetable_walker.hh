@@ -44,6 +44,7 @@
 
 #include "arch/x86/pagetable.hh"
 #include "arch/x86/tlb.hh"
+#include "base/statistics.hh"
 #include "base/types.hh"
 #include "mem/mem_object.hh"
 #include "mem/packet.hh"
@@ -76,6 +77,53 @@ namespace X86ISA
         friend class WalkerPort;
         WalkerPort port;
 
+        /**
+         * A paging-structure cache. Each entry maps a prefix of the
+         * virtual address to the physical address of the table the
+         * walk continues with, together with the permissions gathered
+         * in the levels above it, so that walks hitting in it skip
+         * these levels.
+         */
+        class WalkCache
+        {
+          public:
+            struct Entry
+            {
+                bool valid;
+                Addr cr3;
+                Addr tag;
+                Addr table;
+                bool writable;
+                bool user;
+                bool noExec;
+                bool uncacheable;
+                uint64_t lastUse;
+            };
+
+          private:
+            std::vector<Entry> entries;
+            uint64_t useCount;
+
+          public:
+            WalkCache(unsigned size);
+
+            bool enabled() const { return !entries.empty(); }
+
+            /**
+             * Look up the table for a virtual address prefix.
+             *
+             * @param cr3 page table base the walk starts from
+             * @param tag virtual address prefix
+             * @return the matching entry, NULL on a miss
+             */
+            const Entry *lookup(Addr cr3, Addr tag);
+
+            /** Insert an entry, replacing the least recently used one. */
+            void insert(const Entry &entry);
+
+            void flush();
+        };
+
         // State to track each walk of the page table
         class WalkerState
         {
@@ -111,6 +159,25 @@ namespace X86ISA
             bool timing;
             bool retrying;
             bool started;
+            Addr cr3;
+            Tick enqueueTick;
+            Tick startTick;
+
+            /** A translation coalesced with this walk */
+            struct Follower
+            {
+                TLB::Translation *translation;
+                RequestPtr req;
+                ThreadContext *tc;
+                BaseTLB::Mode mode;
+                Tick enqueueTick;
+            };
+
+            /**
+             * Translations for the same page that arrived while this
+             * walk was queued or in flight, finished along with it.
+             */
+            std::vector<Follower> followers;
           public:
             WalkerState(Walker * _walker, BaseTLB::Translation *_translation,
                         const RequestPtr &_req, bool _isFunctional = false) :
@@ -118,7 +185,8 @@ namespace X86ISA
                 nextState(Ready), inflight(0),
                 translation(_translation),
                 functional(_isFunctional), timing(false),
-                retrying(false), started(false)
+                retrying(false), started(false), cr3(0),
+                enqueueTick(curTick()), startTick(0)
             {
             }
             void initState(ThreadContext * _tc, BaseTLB::Mode _mode,
@@ -132,12 +200,32 @@ namespace X86ISA
             void retry();
             std::string name() const {return walker->name();}
 
+            /**
+             * Check if a translation can be finished by this walk.
+             */
+            bool canCoalesce(ThreadContext *_tc, Addr vaddr) const;
+
+            /**
+             * Move the coalesced translations to a walk of their own,
+             * for when this walk cannot finish them.
+             *
+             * @return the new walk, NULL if there are no followers
+             */
+            WalkerState *detachFollowers();
+
           private:
             void setupWalk(Addr vaddr);
             Fault stepWalk(PacketPtr &write);
             void sendPackets();
             void endWalk();
             Fault pageFault(bool present);
+
+            /**
+             * Record the table the walk continues with in a
+             * paging-structure cache.
+             */
+            void cacheTable(WalkCache &cache, Addr tag, Addr table,
+                            bool uncacheable);
         };
 
         friend class WalkerState;
@@ -172,6 +260,20 @@ namespace X86ISA
         // The number of outstanding walks that can be squashed per cycle.
         unsigned numSquashable;
 
+        // The PML4, PDP and PDE caches of long mode walks.
+        WalkCache pml4Cache;
+        WalkCache pdpCache;
+        WalkCache pdeCache;
+
+        // Statistics
+        Stats::Scalar walks;
+        Stats::Scalar walksCoalesced;
+        Stats::Scalar pml4CacheHits;
+        Stats::Scalar pdpCacheHits;
+        Stats::Scalar pdeCacheHits;
+        Stats::Histogram walkWaitTime;
+        Stats::Histogram walkServiceTime;
+
         // Wrapper for checking for squashes before starting a translation.
         void startWalkWrapper();
 
@@ -192,6 +294,11 @@ namespace X86ISA
             tlb = _tlb;
         }
 
+        // Invalidate the paging-structure caches.
+        void flushWalkCaches();
+
+        void regStats() override;
+
         typedef X86PagetableWalkerParams Params;
 
         const Params *
@@ -205,6 +312,9 @@ namespace X86ISA
             funcState(this, NULL, NULL, true), tlb(NULL), sys(params->system),
             masterId(sys->getMasterId(this)),
             numSquashable(params->num_squash_per_cycle),
+            pml4Cache(params->pml4_cache_size),
+            pdpCache(params->pdp_cache_size),
+            pdeCache(params->pde_cache_size),
             startWalkWrapperEvent([this]{ startWalkWrapper(); }, name())
         {
         }
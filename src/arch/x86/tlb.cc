@@ -61,16 +61,21 @@ namespace X86ISA {
 
 TLB::TLB(const Params *p)
     : BaseTLB(p), configAddress(0), size(p->size),
-      tlb(size), lruSeq(0)
+      tlb(size), lruSeq(0), assoc(p->assoc)
 {
     if (!size)
         fatal("TLBs must have a non-zero size.\n");
 
     for (int x = 0; x < size; x++) {
         tlb[x].trieHandle = NULL;
-        freeList.push_back(&tlb[x]);
+        // a set-associative TLB manages its ways itself
+        if (!assoc)
+            freeList.push_back(&tlb[x]);
     }
 
+    if (assoc)
+        sets.reset(new TlbSets(tlb, assoc, p->plru, lruSeq));
+
     walker = p->walker;
     walker->setTLB(this);
 }
@@ -96,6 +101,9 @@ TLB::evictLRU()
 TlbEntry *
 TLB::insert(Addr vpn, const TlbEntry &entry)
 {
+    if (sets)
+        return sets->insert(vpn, entry);
+
     // If somebody beat us to it, just use that existing entry.
     TlbEntry *newEntry = trie.lookup(vpn);
     if (newEntry) {
@@ -120,6 +128,9 @@ TLB::insert(Addr vpn, const TlbEntry &entry)
 TlbEntry *
 TLB::lookup(Addr va, bool update_lru)
 {
+    if (sets)
+        return sets->lookup(va, update_lru);
+
     TlbEntry *entry = trie.lookup(va);
     if (entry && update_lru)
         entry->lruSeq = nextSeq();
@@ -130,6 +141,11 @@ void
 TLB::flushAll()
 {
     DPRINTF(TLB, "Invalidating all entries.\n");
+    walker->flushWalkCaches();
+    if (sets) {
+        sets->flush(false);
+        return;
+    }
     for (unsigned i = 0; i < size; i++) {
         if (tlb[i].trieHandle) {
             trie.remove(tlb[i].trieHandle);
@@ -149,6 +165,11 @@ void
 TLB::flushNonGlobal()
 {
     DPRINTF(TLB, "Invalidating all non global entries.\n");
+    walker->flushWalkCaches();
+    if (sets) {
+        sets->flush(true);
+        return;
+    }
     for (unsigned i = 0; i < size; i++) {
         if (tlb[i].trieHandle && !tlb[i].global) {
             trie.remove(tlb[i].trieHandle);
@@ -161,6 +182,16 @@ TLB::flushNonGlobal()
 void
 TLB::demapPage(Addr va, uint64_t asn)
 {
+    // The paging-structure caches are not tracked per page
+    walker->flushWalkCaches();
+
+    if (sets) {
+        TlbEntry *entry = sets->lookup(va, false);
+        if (entry)
+            sets->invalidate(entry - &tlb[0]);
+        return;
+    }
+
     TlbEntry *entry = trie.lookup(va);
     if (entry) {
         trie.remove(entry->trieHandle);
@@ -478,13 +509,17 @@ void
 TLB::serialize(CheckpointOut &cp) const
 {
     // Only store the entries in use.
-    uint32_t _size = size - freeList.size();
+    uint32_t _size = 0;
+    for (uint32_t x = 0; x < size; x++) {
+        if (inUse(x))
+            _size++;
+    }
     SERIALIZE_SCALAR(_size);
     SERIALIZE_SCALAR(lruSeq);
 
     uint32_t _count = 0;
     for (uint32_t x = 0; x < size; x++) {
-        if (tlb[x].trieHandle != NULL)
+        if (inUse(x))
             tlb[x].serializeSection(cp, csprintf("Entry%d", _count++));
     }
 }
@@ -501,6 +536,19 @@ TLB::unserialize(CheckpointIn &cp)
 
     UNSERIALIZE_SCALAR(lruSeq);
 
+    if (sets) {
+        // Entries are placed in their sets again, which may evict
+        // some of them if the checkpoint comes from a TLB of a
+        // different organization
+        for (uint32_t x = 0; x < _size; x++) {
+            TlbEntry entry;
+            entry.unserializeSection(cp, csprintf("Entry%d", x));
+            uint64_t seq = entry.lruSeq;
+            sets->insert(entry.vaddr, entry)->lruSeq = seq;
+        }
+        return;
+    }
+
     for (uint32_t x = 0; x < _size; x++) {
         TlbEntry *newEntry = freeList.front();
         freeList.pop_front();
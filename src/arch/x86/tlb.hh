@@ -41,10 +41,12 @@
 #define __ARCH_X86_TLB_HH__
 
 #include <list>
+#include <memory>
 #include <vector>
 
 #include "arch/generic/tlb.hh"
 #include "arch/x86/pagetable.hh"
+#include "arch/x86/tlb_sets.hh"
 #include "base/trie.hh"
 #include "mem/request.hh"
 #include "params/X86TLB.hh"
@@ -100,6 +102,22 @@ namespace X86ISA
         TlbEntryTrie trie;
         uint64_t lruSeq;
 
+        /**
+         * Associativity of the TLB, 0 if it is fully associative. A
+         * fully associative TLB finds its entries through the trie and
+         * replaces the least recently used one. A set-associative TLB
+         * finds them through its sets instead.
+         */
+        const uint32_t assoc;
+        std::unique_ptr<TlbSets> sets;
+
+        /** Check if an entry holds a translation. */
+        bool
+        inUse(uint32_t idx) const
+        {
+            return sets ? sets->valid(idx) : tlb[idx].trieHandle != NULL;
+        }
+
         // Statistics
         Stats::Scalar rdAccesses;
         Stats::Scalar wrAccesses;
@@ -0,0 +1,173 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "arch/x86/tlb_sets.hh"
+
+#include <cassert>
+
+#include "base/bitfield.hh"
+#include "base/logging.hh"
+
+namespace X86ISA {
+
+TlbSets::TlbSets(std::vector<TlbEntry> &_entries, uint32_t _assoc,
+                 bool plru, uint64_t &lru_seq)
+    : entries(_entries), assoc(_assoc),
+      _numSets(_assoc ? _entries.size() / _assoc : 0), usePLRU(plru),
+      lruSeq(lru_seq), entryValid(_entries.size(), false),
+      plruState(_numSets, 0), pageSizeMask(0), pageSizeCount(64, 0)
+{
+    fatal_if(!isPowerOf2(assoc) || assoc > 64,
+             "TLB associativity must be a power of 2 up to 64.\n");
+    fatal_if(entries.size() % assoc || !isPowerOf2(_numSets),
+             "TLB size must be a power of 2 multiple of its "
+             "associativity.\n");
+}
+
+void
+TlbSets::touch(uint32_t set, uint32_t way)
+{
+    entries[set * assoc + way].lruSeq = ++lruSeq;
+
+    if (!usePLRU)
+        return;
+
+    // Walk the tree from the root to the leaf of the way, pointing
+    // every node on the path away from it
+    uint64_t &state = plruState[set];
+    uint32_t node = 1;
+    for (uint32_t level = floorLog2(assoc); level > 0; level--) {
+        uint32_t right = (way >> (level - 1)) & 1;
+        if (right)
+            state &= ~(1ULL << node);
+        else
+            state |= 1ULL << node;
+        node = 2 * node + right;
+    }
+}
+
+uint32_t
+TlbSets::findVictim(uint32_t set) const
+{
+    const uint32_t base = set * assoc;
+
+    // Fill the invalid ways first
+    for (uint32_t way = 0; way < assoc; way++) {
+        if (!entryValid[base + way])
+            return way;
+    }
+
+    if (usePLRU) {
+        // Follow the tree nodes to the pseudo least recently used way
+        uint32_t node = 1;
+        while (node < assoc)
+            node = 2 * node + ((plruState[set] >> node) & 1);
+        return node - assoc;
+    }
+
+    uint32_t lru = 0;
+    for (uint32_t way = 1; way < assoc; way++) {
+        if (entries[base + way].lruSeq < entries[base + lru].lruSeq)
+            lru = way;
+    }
+    return lru;
+}
+
+void
+TlbSets::invalidate(uint32_t idx)
+{
+    assert(entryValid[idx]);
+    entryValid[idx] = false;
+
+    unsigned log_bytes = entries[idx].logBytes;
+    assert(pageSizeCount[log_bytes]);
+    if (--pageSizeCount[log_bytes] == 0)
+        pageSizeMask &= ~(1ULL << log_bytes);
+}
+
+void
+TlbSets::flush(bool keep_global)
+{
+    for (uint32_t i = 0; i < entries.size(); i++) {
+        if (entryValid[i] && !(keep_global && entries[i].global))
+            invalidate(i);
+    }
+}
+
+TlbEntry *
+TlbSets::lookup(Addr va, bool update_lru)
+{
+    // Probe one set for each of the page sizes present
+    for (uint64_t mask = pageSizeMask; mask; mask &= mask - 1) {
+        unsigned log_bytes = findLsbSet(mask);
+        Addr vpn = va >> log_bytes;
+        uint32_t set = setIndex(vpn, log_bytes);
+
+        for (uint32_t way = 0; way < assoc; way++) {
+            uint32_t idx = set * assoc + way;
+            TlbEntry &entry = entries[idx];
+            if (entryValid[idx] && entry.logBytes == log_bytes &&
+                (entry.vaddr >> log_bytes) == vpn) {
+                if (update_lru)
+                    touch(set, way);
+                return &entry;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+TlbEntry *
+TlbSets::insert(Addr vpn, const TlbEntry &entry)
+{
+    // If somebody beat us to it, just use that existing entry.
+    TlbEntry *newEntry = lookup(vpn, false);
+    if (newEntry) {
+        assert(newEntry->vaddr == vpn);
+        return newEntry;
+    }
+
+    uint32_t set = setIndex(vpn >> entry.logBytes, entry.logBytes);
+    uint32_t way = findVictim(set);
+    uint32_t idx = set * assoc + way;
+
+    if (entryValid[idx])
+        invalidate(idx);
+
+    newEntry = &entries[idx];
+    *newEntry = entry;
+    newEntry->vaddr = vpn;
+    newEntry->trieHandle = NULL;
+    entryValid[idx] = true;
+
+    pageSizeMask |= 1ULL << entry.logBytes;
+    pageSizeCount[entry.logBytes]++;
+
+    touch(set, way);
+    return newEntry;
+}
+
+} // namespace X86ISA
@@ -0,0 +1,119 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __ARCH_X86_TLB_SETS_HH__
+#define __ARCH_X86_TLB_SETS_HH__
+
+#include <cstdint>
+#include <vector>
+
+#include "arch/x86/pagetable.hh"
+#include "base/intmath.hh"
+#include "base/types.hh"
+
+namespace X86ISA
+{
+    /**
+     * The set-associative organization of an X86 TLB. Set i holds
+     * entries [i * assoc, (i + 1) * assoc) of the TLB's entry array,
+     * found through a hashed set index. The page sizes present are
+     * tracked so that a lookup probes one set for each of them.
+     * Replacement fills invalid ways first, then uses a per-set tree
+     * pseudo-LRU or true LRU within the set.
+     */
+    class TlbSets
+    {
+      public:
+        /**
+         * @param entries Entry array of the TLB, its size a power of 2
+         *        multiple of assoc.
+         * @param assoc Associativity, a power of 2 up to 64.
+         * @param plru Use tree pseudo-LRU rather than true LRU.
+         * @param lru_seq Sequence number of the TLB, used to time stamp
+         *        the entries for true LRU.
+         */
+        TlbSets(std::vector<TlbEntry> &entries, uint32_t assoc, bool plru,
+                uint64_t &lru_seq);
+
+        uint32_t numSets() const { return _numSets; }
+
+        /**
+         * Get the set a virtual page number of a given page size maps
+         * to.
+         */
+        uint32_t
+        setIndex(Addr vpn, unsigned log_bytes) const
+        {
+            // fold the upper bits and the page size into the index so
+            // that strided and large page accesses spread over the sets
+            Addr hash = vpn ^ (vpn >> floorLog2(_numSets)) ^
+                (vpn >> (2 * floorLog2(_numSets))) ^ log_bytes;
+            return hash & (_numSets - 1);
+        }
+
+        /** Check if an entry holds a translation. */
+        bool valid(uint32_t idx) const { return entryValid[idx]; }
+
+        TlbEntry *lookup(Addr va, bool update_lru);
+        TlbEntry *insert(Addr vpn, const TlbEntry &entry);
+
+        /** Pick the way to replace in a set. */
+        uint32_t findVictim(uint32_t set) const;
+
+        /** Invalidate an entry. */
+        void invalidate(uint32_t idx);
+
+        /** Invalidate all the entries, or all the non global ones. */
+        void flush(bool keep_global);
+
+      protected:
+        /** Mark a way as the most recently used. */
+        void touch(uint32_t set, uint32_t way);
+
+        std::vector<TlbEntry> &entries;
+
+        const uint32_t assoc;
+        const uint32_t _numSets;
+
+        /** Use tree pseudo-LRU within a set rather than true LRU */
+        const bool usePLRU;
+
+        uint64_t &lruSeq;
+
+        std::vector<bool> entryValid;
+
+        /** Tree pseudo-LRU state of each set, one bit per tree node */
+        std::vector<uint64_t> plruState;
+
+        /**
+         * Page sizes present, as a mask of their log2 size, and the
+         * number of entries of each of them.
+         */
+        uint64_t pageSizeMask;
+        std::vector<uint32_t> pageSizeCount;
+    };
+}
+
+#endif // __ARCH_X86_TLB_SETS_HH__
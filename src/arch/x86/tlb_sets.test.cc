@@ -0,0 +1,210 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <set>
+#include <vector>
+
+#include "arch/x86/tlb_sets.hh"
+
+using namespace X86ISA;
+
+namespace {
+
+const unsigned Log4K = 12;
+const unsigned Log2M = 21;
+const unsigned Log1G = 30;
+
+TlbEntry
+makeEntry(Addr vaddr, unsigned log_bytes, bool global = false)
+{
+    TlbEntry entry(0, vaddr, vaddr + 0x100000000ULL, false, false);
+    entry.logBytes = log_bytes;
+    entry.global = global;
+    return entry;
+}
+
+/** A set-associative TLB with its own entry array */
+class Sets
+{
+  public:
+    Sets(uint32_t size, uint32_t assoc, bool plru = true)
+        : entries(size), seq(0), sets(entries, assoc, plru, seq)
+    {}
+
+    TlbEntry *
+    insert(Addr vaddr, unsigned log_bytes, bool global = false)
+    {
+        return sets.insert(vaddr, makeEntry(vaddr, log_bytes, global));
+    }
+
+    bool
+    hit(Addr va)
+    {
+        return sets.lookup(va, false) != NULL;
+    }
+
+    std::vector<TlbEntry> entries;
+    uint64_t seq;
+    TlbSets sets;
+};
+
+} // anonymous namespace
+
+TEST(TlbSetsTest, SetIndexAcrossPageSizes)
+{
+    Sets tlb(64, 4);
+    ASSERT_EQ(16U, tlb.sets.numSets());
+
+    // Consecutive pages of a size fill distinct sets
+    for (unsigned log_bytes : {Log4K, Log2M, Log1G}) {
+        std::set<uint32_t> used;
+        for (Addr vpn = 0x4000; vpn < 0x4010; vpn++) {
+            uint32_t set = tlb.sets.setIndex(vpn, log_bytes);
+            EXPECT_LT(set, tlb.sets.numSets());
+            used.insert(set);
+        }
+        EXPECT_EQ(16U, used.size()) << "log_bytes " << log_bytes;
+    }
+
+    // The same page number of different sizes maps to different sets
+    for (Addr vpn = 0; vpn < 64; vpn++) {
+        EXPECT_NE(tlb.sets.setIndex(vpn, Log4K),
+                  tlb.sets.setIndex(vpn, Log2M));
+        EXPECT_NE(tlb.sets.setIndex(vpn, Log2M),
+                  tlb.sets.setIndex(vpn, Log1G));
+    }
+}
+
+TEST(TlbSetsTest, LookupAcrossPageSizes)
+{
+    Sets tlb(64, 4);
+
+    const Addr small = 0x7f0000001000ULL;
+    const Addr large = 0x7f0000200000ULL;
+    const Addr huge = 0x40000000ULL;
+    tlb.insert(small, Log4K);
+    tlb.insert(large, Log2M);
+    tlb.insert(huge, Log1G);
+
+    // Every address of a page hits on the entry of its size
+    EXPECT_EQ(Log4K, tlb.sets.lookup(small + 0xfff, false)->logBytes);
+    EXPECT_EQ(Log2M, tlb.sets.lookup(large + 0x1234, false)->logBytes);
+    EXPECT_EQ(Log2M, tlb.sets.lookup(large + 0x1fffff, false)->logBytes);
+    EXPECT_EQ(Log1G, tlb.sets.lookup(huge + 0x3fffffff, false)->logBytes);
+    EXPECT_EQ(huge, tlb.sets.lookup(huge + 0x200000, false)->vaddr);
+
+    EXPECT_FALSE(tlb.hit(small + 0x1000));
+    EXPECT_FALSE(tlb.hit(large + 0x200000));
+    EXPECT_FALSE(tlb.hit(huge + 0x40000000));
+
+    // Inserting a translation again keeps the existing entry
+    TlbEntry *entry = tlb.sets.lookup(large, false);
+    EXPECT_EQ(entry, tlb.insert(large, Log2M));
+}
+
+TEST(TlbSetsTest, PLRUReplacementOrder)
+{
+    // A single set of 4 ways
+    Sets tlb(4, 4);
+    const Addr page[] = { 0x1000, 0x2000, 0x3000, 0x4000, 0x5000 };
+
+    // The invalid ways fill in order
+    for (unsigned i = 0; i < 4; i++) {
+        EXPECT_EQ(i, tlb.sets.findVictim(0));
+        EXPECT_EQ(&tlb.entries[i], tlb.insert(page[i], Log4K));
+    }
+
+    // After filling 0 to 3 the tree points at way 0
+    EXPECT_EQ(0U, tlb.sets.findVictim(0));
+
+    // Using way 0 points the root at the right half, away from way 3
+    ASSERT_TRUE(tlb.sets.lookup(page[0], true));
+    EXPECT_EQ(2U, tlb.sets.findVictim(0));
+
+    tlb.insert(page[4], Log4K);
+    EXPECT_FALSE(tlb.hit(page[2]));
+    EXPECT_TRUE(tlb.hit(page[0]));
+    EXPECT_TRUE(tlb.hit(page[1]));
+    EXPECT_TRUE(tlb.hit(page[3]));
+    EXPECT_TRUE(tlb.hit(page[4]));
+
+    // Lookups that do not update the replacement state leave it alone
+    EXPECT_EQ(1U, tlb.sets.findVictim(0));
+    ASSERT_TRUE(tlb.sets.lookup(page[3], false));
+    EXPECT_EQ(1U, tlb.sets.findVictim(0));
+}
+
+TEST(TlbSetsTest, LRUReplacementOrder)
+{
+    // The same accesses as the PLRU test evict the true LRU way
+    Sets tlb(4, 4, false);
+    const Addr page[] = { 0x1000, 0x2000, 0x3000, 0x4000, 0x5000 };
+
+    for (unsigned i = 0; i < 4; i++)
+        tlb.insert(page[i], Log4K);
+    EXPECT_EQ(0U, tlb.sets.findVictim(0));
+
+    ASSERT_TRUE(tlb.sets.lookup(page[0], true));
+    EXPECT_EQ(1U, tlb.sets.findVictim(0));
+
+    tlb.insert(page[4], Log4K);
+    EXPECT_FALSE(tlb.hit(page[1]));
+    EXPECT_TRUE(tlb.hit(page[2]));
+}
+
+TEST(TlbSetsTest, InvalidateAndFlush)
+{
+    Sets tlb(64, 4);
+
+    TlbEntry *large = tlb.insert(0x200000, Log2M);
+    tlb.insert(0x1000, Log4K);
+    tlb.insert(0x2000, Log4K, true);
+    tlb.insert(0x40000000, Log1G, true);
+
+    // Invalidating the only large page stops the lookups of its size
+    tlb.sets.invalidate(large - &tlb.entries[0]);
+    EXPECT_FALSE(tlb.hit(0x200000));
+    EXPECT_FALSE(tlb.sets.valid(large - &tlb.entries[0]));
+    EXPECT_TRUE(tlb.hit(0x1000));
+
+    // A non global flush keeps the global entries only
+    tlb.sets.flush(true);
+    EXPECT_FALSE(tlb.hit(0x1000));
+    EXPECT_TRUE(tlb.hit(0x2000));
+    EXPECT_TRUE(tlb.hit(0x40001000));
+
+    // The freed entries can be reused
+    tlb.insert(0x200000, Log2M);
+    EXPECT_TRUE(tlb.hit(0x3fffff));
+
+    tlb.sets.flush(false);
+    for (uint32_t i = 0; i < tlb.entries.size(); i++)
+        EXPECT_FALSE(tlb.sets.valid(i));
+    EXPECT_FALSE(tlb.hit(0x2000));
+    EXPECT_FALSE(tlb.hit(0x40001000));
+    EXPECT_FALSE(tlb.hit(0x200000));
+}
@@ -47,14 +47,209 @@
 #include <cerrno>
 #include <cstdio>
 #include <cstring>
+#include <map>
+#include <vector>
 
 #include "base/logging.hh"
 
 using namespace std;
 
+#if FIBER_ASM_SWITCH
+
+#if defined(__APPLE__) && defined(__MACH__)
+#define FIBER_SYMBOL(name) "_" #name
+#else
+#define FIBER_SYMBOL(name) #name
+#endif
+
+extern "C" {
+/// Push the callee saved registers, save the stack pointer in *save_sp,
+/// switch to new_sp and pop the registers saved there.
+void gem5FiberSwitch(void **save_sp, void *new_sp);
+/// Where a new fiber starts, calling the function saved in a callee
+/// saved register by createContext().
+void gem5FiberStart();
+}
+
+#if defined(__x86_64__)
+
+asm(".text\n"
+    ".globl " FIBER_SYMBOL(gem5FiberSwitch) "\n"
+    ".p2align 4\n"
+    FIBER_SYMBOL(gem5FiberSwitch) ":\n"
+    "    pushq %rbp\n"
+    "    pushq %rbx\n"
+    "    pushq %r12\n"
+    "    pushq %r13\n"
+    "    pushq %r14\n"
+    "    pushq %r15\n"
+    "    subq $16, %rsp\n"
+    "    stmxcsr 8(%rsp)\n"
+    "    fnstcw (%rsp)\n"
+    "    movq %rsp, (%rdi)\n"
+    "    movq %rsi, %rsp\n"
+    "    fldcw (%rsp)\n"
+    "    ldmxcsr 8(%rsp)\n"
+    "    addq $16, %rsp\n"
+    "    popq %r15\n"
+    "    popq %r14\n"
+    "    popq %r13\n"
+    "    popq %r12\n"
+    "    popq %rbx\n"
+    "    popq %rbp\n"
+    "    ret\n"
+    ".globl " FIBER_SYMBOL(gem5FiberStart) "\n"
+    ".p2align 4\n"
+    FIBER_SYMBOL(gem5FiberStart) ":\n"
+    "    callq *%r12\n"
+    "    ud2\n");
+
 namespace
 {
 
+// Layout of the frame gem5FiberSwitch() leaves on the stack.
+struct SwitchFrame
+{
+    uint16_t fpuControl;
+    uint16_t pad0;
+    uint32_t pad1;
+    uint32_t mxcsr;
+    uint32_t pad2;
+    uint64_t r15, r14, r13, r12, rbx, rbp;
+    uint64_t ret;
+};
+
+void
+initFrame(SwitchFrame *frame, void (*entry)())
+{
+    memset(frame, 0, sizeof(*frame));
+    // The control words as the ABI defines them at process start
+    frame->fpuControl = 0x037f;
+    frame->mxcsr = 0x1f80;
+    frame->r12 = (uint64_t)entry;
+    frame->ret = (uint64_t)&gem5FiberStart;
+}
+
+} // anonymous namespace
+
+#elif defined(__aarch64__)
+
+asm(".text\n"
+    ".globl " FIBER_SYMBOL(gem5FiberSwitch) "\n"
+    ".p2align 4\n"
+    FIBER_SYMBOL(gem5FiberSwitch) ":\n"
+    "    sub sp, sp, #176\n"
+    "    stp x19, x20, [sp, #0]\n"
+    "    stp x21, x22, [sp, #16]\n"
+    "    stp x23, x24, [sp, #32]\n"
+    "    stp x25, x26, [sp, #48]\n"
+    "    stp x27, x28, [sp, #64]\n"
+    "    stp x29, x30, [sp, #80]\n"
+    "    stp d8, d9, [sp, #96]\n"
+    "    stp d10, d11, [sp, #112]\n"
+    "    stp d12, d13, [sp, #128]\n"
+    "    stp d14, d15, [sp, #144]\n"
+    "    mrs x9, fpcr\n"
+    "    str x9, [sp, #160]\n"
+    "    mov x9, sp\n"
+    "    str x9, [x0]\n"
+    "    mov sp, x1\n"
+    "    ldr x9, [sp, #160]\n"
+    "    msr fpcr, x9\n"
+    "    ldp x19, x20, [sp, #0]\n"
+    "    ldp x21, x22, [sp, #16]\n"
+    "    ldp x23, x24, [sp, #32]\n"
+    "    ldp x25, x26, [sp, #48]\n"
+    "    ldp x27, x28, [sp, #64]\n"
+    "    ldp x29, x30, [sp, #80]\n"
+    "    ldp d8, d9, [sp, #96]\n"
+    "    ldp d10, d11, [sp, #112]\n"
+    "    ldp d12, d13, [sp, #128]\n"
+    "    ldp d14, d15, [sp, #144]\n"
+    "    add sp, sp, #176\n"
+    "    ret\n"
+    ".globl " FIBER_SYMBOL(gem5FiberStart) "\n"
+    ".p2align 4\n"
+    FIBER_SYMBOL(gem5FiberStart) ":\n"
+    "    blr x19\n"
+    "    brk #0\n");
+
+namespace
+{
+
+// Layout of the frame gem5FiberSwitch() leaves on the stack.
+struct SwitchFrame
+{
+    uint64_t x[12]; // x19 to x30
+    uint64_t d[8];  // d8 to d15
+    uint64_t fpcr;
+    uint64_t pad;
+};
+
+void
+initFrame(SwitchFrame *frame, void (*entry)())
+{
+    memset(frame, 0, sizeof(*frame));
+    frame->x[0] = (uint64_t)entry;                 // x19
+    frame->x[11] = (uint64_t)&gem5FiberStart;      // x30, the link register
+}
+
+} // anonymous namespace
+
+#endif
+
+#endif // FIBER_ASM_SWITCH
+
+namespace
+{
+
+/*
+ * Fiber stacks, guard page included, are kept for reuse when their fiber
+ * is destroyed instead of being unmapped, since simulators with
+ * dynamically spawned threads create and destroy many fibers of the same
+ * stack size. The pool is never destroyed, as static Fibers may outlive
+ * any other static object.
+ */
+class StackPool
+{
+  public:
+    static StackPool &
+    get()
+    {
+        static StackPool *pool = new StackPool;
+        return *pool;
+    }
+
+    void *
+    alloc(size_t size)
+    {
+        auto it = free.find(size);
+        if (it != free.end() && !it->second.empty()) {
+            void *mem = it->second.back();
+            it->second.pop_back();
+            return mem;
+        }
+        return nullptr;
+    }
+
+    bool
+    release(void *mem, size_t size)
+    {
+        std::vector<void *> &stacks = free[size];
+        if (stacks.size() >= MaxFreeStacks)
+            return false;
+        stacks.push_back(mem);
+        return true;
+    }
+
+  private:
+    // Bounds the memory kept per stack size. The pages of a pooled stack
+    // stay committed, so this is up to 64 times the stack size each.
+    static const size_t MaxFreeStacks = 64;
+
+    std::map<size_t, std::vector<void *>> free;
+};
+
 /*
  * The PrimaryFiber class is a special case that attaches to the currently
  * executing context. That makes handling the "primary" fiber, aka the one
@@ -91,18 +286,21 @@ Fiber::Fiber(Fiber *link, size_t stack_size) :
     guardPageSize(sysconf(_SC_PAGE_SIZE)), started(false), _finished(false)
 {
     if (stack_size) {
-        guardPage = mmap(nullptr, guardPageSize + stack_size,
-                         PROT_READ | PROT_WRITE,
-                         MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
-        if (guardPage == (void *)MAP_FAILED) {
-            perror("mmap");
-            fatal("Could not mmap %d byte fiber stack.\n", stack_size);
+        guardPage = StackPool::get().alloc(guardPageSize + stack_size);
+        if (!guardPage) {
+            guardPage = mmap(nullptr, guardPageSize + stack_size,
+                             PROT_READ | PROT_WRITE,
+                             MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+            if (guardPage == (void *)MAP_FAILED) {
+                perror("mmap");
+                fatal("Could not mmap %d byte fiber stack.\n", stack_size);
+            }
+            if (mprotect(guardPage, guardPageSize, PROT_NONE)) {
+                perror("mprotect");
+                fatal("Could not forbid access to fiber stack guard page.");
+            }
         }
         stack = (void *)((uint8_t *)guardPage + guardPageSize);
-        if (mprotect(guardPage, guardPageSize, PROT_NONE)) {
-            perror("mprotect");
-            fatal("Could not forbid access to fiber stack guard page.");
-        }
     }
 #if HAVE_VALGRIND
     valgrindStackId = VALGRIND_STACK_REGISTER(
@@ -116,25 +314,47 @@ Fiber::~Fiber()
 #if HAVE_VALGRIND
     VALGRIND_STACK_DEREGISTER(valgrindStackId);
 #endif
-    if (guardPage)
+    if (guardPage &&
+            !StackPool::get().release(guardPage, guardPageSize + stackSize)) {
         munmap(guardPage, guardPageSize + stackSize);
+    }
+}
+
+void
+Fiber::switchContext(Fiber *from, Fiber *to)
+{
+#if FIBER_ASM_SWITCH
+    gem5FiberSwitch(&from->sp, to->sp);
+#else
+    int ret M5_VAR_USED = swapcontext(&from->ctx, &to->ctx);
+    panic_if(ret == -1, strerror(errno));
+#endif
 }
 
 void
 Fiber::createContext()
 {
     // Set up a context for the new fiber, starting it in the trampoline.
+#if FIBER_ASM_SWITCH
+    // The stack must be 16 byte aligned once the frame is popped, when
+    // gem5FiberStart calls the trampoline.
+    uintptr_t top = ((uintptr_t)stack + stackSize) & ~(uintptr_t)0xf;
+    SwitchFrame *frame = (SwitchFrame *)(top - 16 - sizeof(SwitchFrame));
+    initFrame(frame, &entryTrampoline);
+    sp = frame;
+#else
     getcontext(&ctx);
     ctx.uc_stack.ss_sp = stack;
     ctx.uc_stack.ss_size = stackSize;
     ctx.uc_link = nullptr;
     makecontext(&ctx, &entryTrampoline, 0);
+#endif
 
     // Swap to the new context so it can enter its start() function. It
     // will then swap itself back out and return here.
     startingFiber = this;
     panic_if(!_currentFiber, "No active Fiber object.");
-    swapcontext(&_currentFiber->ctx, &ctx);
+    switchContext(_currentFiber, this);
 
     // The new context is now ready and about to call main().
 }
@@ -149,8 +369,7 @@ Fiber::start()
 
     // Swap back to the parent context which is still considered "current",
     // now that we're ready to go.
-    int ret M5_VAR_USED = swapcontext(&ctx, &_currentFiber->ctx);
-    panic_if(ret == -1, strerror(errno));
+    switchContext(this, _currentFiber);
 
     // Call main() when we're been reactivated for the first time.
     main();
@@ -177,7 +396,7 @@ Fiber::run()
     Fiber *prev = _currentFiber;
     Fiber *next = this;
     _currentFiber = next;
-    swapcontext(&prev->ctx, &next->ctx);
+    switchContext(prev, next);
 }
 
 Fiber *Fiber::currentFiber() { return _currentFiber; }
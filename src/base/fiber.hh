@@ -30,6 +30,17 @@
 #ifndef __BASE_FIBER_HH__
 #define __BASE_FIBER_HH__
 
+// On x86-64 and AArch64 hosts, fibers switch with a few instructions of
+// assembly which only save the callee saved registers. Elsewhere they
+// use ucontext, whose swapcontext also saves and restores the signal
+// mask with a system call on every switch.
+#if defined(__x86_64__) || defined(__aarch64__)
+#define FIBER_ASM_SWITCH 1
+#else
+#define FIBER_ASM_SWITCH 0
+#endif
+
+#if !FIBER_ASM_SWITCH
 // ucontext functions (like getcontext, setcontext etc) have been marked
 // as deprecated and are hence hidden in latest macOS releases.
 // By defining _XOPEN_SOURCE we make them available at compilation time.
@@ -40,6 +51,7 @@
 #else
 #include <ucontext.h>
 #endif
+#endif // !FIBER_ASM_SWITCH
 
 #include <cstddef>
 #include <cstdint>
@@ -102,7 +114,16 @@ class Fiber
     static void entryTrampoline();
     void start();
 
+    /// Save the context of from and resume the one of to.
+    static void switchContext(Fiber *from, Fiber *to);
+
+#if FIBER_ASM_SWITCH
+    /// The stack pointer of the fiber while it is switched out. The
+    /// callee saved registers are on the stack below it.
+    void *sp;
+#else
     ucontext_t ctx;
+#endif
     Fiber *link;
 
     // The stack for this context, or a nullptr if allocated elsewhere.
@@ -29,8 +29,11 @@
 
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <cstdint>
 #include <initializer_list>
 #include <iostream>
+#include <memory>
 #include <vector>
 
 #include "base/fiber.hh"
@@ -138,3 +141,72 @@ TEST(Fiber, Linked)
 
     EXPECT_EQ(currentIndex, 4);
 }
+
+class CountingFiber : public Fiber
+{
+  public:
+    int &count;
+    CountingFiber(int &count) : Fiber(), count(count) {}
+
+    void main() { count++; }
+};
+
+TEST(Fiber, Recycling)
+{
+    // Fibers which are created and destroyed over and over reuse the
+    // same stacks.
+    int count = 0;
+    for (int i = 0; i < 1000; i++) {
+        std::unique_ptr<CountingFiber> f(new CountingFiber(count));
+        f->run();
+        EXPECT_TRUE(f->finished());
+    }
+    EXPECT_EQ(count, 1000);
+}
+
+class PingPongFiber : public Fiber
+{
+  public:
+    Fiber *peer;
+    const uint64_t rounds;
+    uint64_t switches;
+    double sum;
+
+    PingPongFiber(uint64_t rounds) :
+        Fiber(), peer(nullptr), rounds(rounds), switches(0), sum(0)
+    {}
+
+    void
+    main()
+    {
+        for (uint64_t i = 0; i < rounds; i++) {
+            // Keep some floating point state live across the switch
+            sum += 0.5;
+            switches++;
+            peer->run();
+        }
+    }
+};
+
+TEST(Fiber, SwitchBenchmark)
+{
+    const uint64_t rounds = 1000000;
+    PingPongFiber ping(rounds);
+    PingPongFiber pong(rounds);
+    ping.peer = &pong;
+    pong.peer = &ping;
+
+    auto start = std::chrono::steady_clock::now();
+    ping.run();
+    auto end = std::chrono::steady_clock::now();
+
+    EXPECT_TRUE(ping.finished());
+    EXPECT_EQ(ping.switches, rounds);
+    EXPECT_EQ(pong.switches, rounds);
+    EXPECT_EQ(ping.sum, rounds * 0.5);
+    EXPECT_EQ(pong.sum, rounds * 0.5);
+
+    double ns = std::chrono::duration<double, std::nano>(end - start).count();
+    std::cout << "Fiber switch: " << ns / (2 * rounds) << " ns over " <<
+        2 * rounds << " switches" << std::endl;
+}
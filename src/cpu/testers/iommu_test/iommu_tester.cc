@@ -0,0 +1,214 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/testers/iommu_test/iommu_tester.hh"
+
+#include <algorithm>
+
+#include "base/logging.hh"
+#include "debug/IOMMUTester.hh"
+#include "mem/page_table.hh"
+#include "params/IOMMUTester.hh"
+#include "sim/process.hh"
+#include "sim/sim_exit.hh"
+
+IOMMUTester::Request::Request(IOMMUTester &_tester, Addr _vaddr, bool fault,
+                              Addr paddr, const Request *_leader)
+    : tester(_tester), vaddr(_vaddr), expectFault(fault),
+      expectPaddr(paddr), leader(_leader), issueTick(curTick()),
+      finishTick(MaxTick)
+{
+}
+
+void
+IOMMUTester::Request::finish(Addr _vaddr, Addr paddr, bool fault)
+{
+    panic_if(finishTick != MaxTick, "%s: translation of %#x finished twice",
+             tester.name(), vaddr);
+    panic_if(_vaddr != vaddr, "%s: translation of %#x finished as %#x",
+             tester.name(), vaddr, _vaddr);
+    panic_if(fault != expectFault, "%s: translation of %#x %s",
+             tester.name(), vaddr, fault ? "faulted" : "did not fault");
+    panic_if(!fault && paddr != expectPaddr,
+             "%s: %#x translated to %#x instead of %#x", tester.name(),
+             vaddr, paddr, expectPaddr);
+
+    finishTick = curTick();
+    tester.completed(*this);
+}
+
+IOMMUTester::IOMMUTester(const IOMMUTesterParams *p)
+    : ClockedObject(p), iommu(p->iommu), process(p->workload),
+      accelId(p->accel_id), numPages(p->num_pages), phase(Walks),
+      unmappedVaddr(0), outstanding(0), minWalkLatency(MaxTick),
+      phaseEvent([this]{ startPhase(); }, name())
+{
+    fatal_if(numPages < 2, "%s: needs at least two pages to translate",
+             name());
+}
+
+void
+IOMMUTester::startup()
+{
+    iommu->bindAccelerator(accelId, process);
+
+    // Translate an address in the middle of a page, so the page offset
+    // has to be carried over
+    std::vector<std::pair<Addr, Addr>> mappings;
+    process->pTable->getMappings(&mappings);
+    for (const auto &m : mappings) {
+        if (vaddrs.size() == numPages)
+            break;
+        vaddrs.push_back(m.first + 0x48);
+    }
+    fatal_if(vaddrs.size() < numPages, "%s: the process only maps %d pages",
+             name(), vaddrs.size());
+
+    // The first page is never mapped in SE mode
+    fatal_if(process->pTable->translate(unmappedVaddr),
+             "%s: address %#x is mapped", name(), unmappedVaddr);
+
+    schedule(phaseEvent, clockEdge(Cycles(1)));
+}
+
+IOMMUTester::Request &
+IOMMUTester::translate(Addr vaddr, const Request *leader)
+{
+    Addr paddr = 0;
+    const bool fault = !process->pTable->translate(vaddr, paddr);
+    requests.emplace_back(*this, vaddr, fault, paddr, leader);
+    outstanding++;
+
+    DPRINTF(IOMMUTester, "Translating %#x.\n", vaddr);
+    iommu->translateTiming(accelId, vaddr, &requests.back());
+    return requests.back();
+}
+
+void
+IOMMUTester::startPhase()
+{
+    requests.clear();
+
+    switch (phase) {
+      case Walks:
+        // Nothing is in the IOTLB yet, so every page is walked, and a
+        // second translation of the same page waits for that walk
+        for (auto vaddr : vaddrs) {
+            Request &first = translate(vaddr);
+            translate(vaddr + 8, &first);
+        }
+        translate(unmappedVaddr);
+        break;
+
+      case Hits:
+        for (auto vaddr : vaddrs) {
+            Addr paddr = 0, expected = 0;
+            panic_if(!iommu->translateFunctional(accelId, vaddr, paddr) ||
+                     !process->pTable->translate(vaddr, expected) ||
+                     paddr != expected,
+                     "%s: functional translation of %#x failed", name(),
+                     vaddr);
+            translate(vaddr);
+        }
+        break;
+
+      case Invalidation:
+        // Only the first page is dropped, the second one must still hit
+        iommu->invalidate(process, vaddrs[0], 1);
+        translate(vaddrs[0]);
+        translate(vaddrs[1]);
+        break;
+
+      default:
+        panic("%s: no phase to start", name());
+    }
+}
+
+void
+IOMMUTester::completed(Request &req)
+{
+    DPRINTF(IOMMUTester, "Translated %#x in %d ticks.\n", req.vaddr,
+            req.finishTick - req.issueTick);
+
+    assert(outstanding > 0);
+    if (--outstanding == 0)
+        checkPhase();
+}
+
+void
+IOMMUTester::checkPhase()
+{
+    switch (phase) {
+      case Walks:
+        for (const auto &req : requests) {
+            if (req.leader) {
+                panic_if(req.finishTick != req.leader->finishTick,
+                         "%s: translation of %#x did not wait for the walk "
+                         "of its page", name(), req.vaddr);
+            } else if (!req.expectFault) {
+                minWalkLatency = std::min(minWalkLatency,
+                                          req.finishTick - req.issueTick);
+            }
+        }
+        phase = Hits;
+        break;
+
+      case Hits:
+        for (const auto &req : requests) {
+            panic_if(req.finishTick - req.issueTick >= minWalkLatency,
+                     "%s: translation of %#x was not an IOTLB hit", name(),
+                     req.vaddr);
+        }
+        phase = Invalidation;
+        break;
+
+      case Invalidation:
+        panic_if(requests.front().finishTick - requests.front().issueTick <
+                 minWalkLatency,
+                 "%s: translation of %#x hit after being invalidated",
+                 name(), requests.front().vaddr);
+        panic_if(requests.back().finishTick - requests.back().issueTick >=
+                 minWalkLatency,
+                 "%s: invalidating %#x dropped the translation of %#x",
+                 name(), requests.front().vaddr, requests.back().vaddr);
+        phase = Done;
+        break;
+
+      default:
+        panic("%s: no phase to check", name());
+    }
+
+    if (phase == Done) {
+        exitSimLoop("IOMMU test passed");
+    } else {
+        schedule(phaseEvent, clockEdge(Cycles(1)));
+    }
+}
+
+IOMMUTester *
+IOMMUTesterParams::create()
+{
+    return new IOMMUTester(this);
+}
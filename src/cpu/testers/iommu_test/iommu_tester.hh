@@ -0,0 +1,122 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * A tester that drives an IOMMU the way an accelerator would. It
+ * translates addresses of a process through the IOMMU and checks the
+ * results against the page table of the process: misses must be walked,
+ * translations of a page that is already being walked must wait for
+ * that walk, hits must be faster than walks, unmapped addresses must
+ * fault, and invalidated entries must be walked again.
+ */
+
+#ifndef __CPU_TESTERS_IOMMU_TEST_IOMMU_TESTER_HH__
+#define __CPU_TESTERS_IOMMU_TEST_IOMMU_TESTER_HH__
+
+#include <list>
+#include <vector>
+
+#include "base/types.hh"
+#include "dev/iommu.hh"
+#include "sim/clocked_object.hh"
+#include "sim/eventq.hh"
+
+class Process;
+struct IOMMUTesterParams;
+
+class IOMMUTester : public ClockedObject
+{
+  public:
+    IOMMUTester(const IOMMUTesterParams *p);
+
+    void startup() override;
+
+  protected:
+    /** The steps of the test, run one after the other. */
+    enum Phase {
+        /** Translate every page twice, the second one coalesces. */
+        Walks,
+        /** Translate every page again, they must hit. */
+        Hits,
+        /** Invalidate one page and translate it again. */
+        Invalidation,
+        Done
+    };
+
+    /** A translation in flight, and the result it must produce. */
+    class Request : public IOMMU::Translation
+    {
+      public:
+        Request(IOMMUTester &tester, Addr vaddr, bool fault,
+                Addr paddr, const Request *leader);
+
+        void finish(Addr vaddr, Addr paddr, bool fault) override;
+
+        IOMMUTester &tester;
+        const Addr vaddr;
+        /** Whether the address is expected to fault. */
+        const bool expectFault;
+        const Addr expectPaddr;
+        /**
+         * The request for the same page issued just before this one,
+         * whose walk this one must wait for.
+         */
+        const Request *leader;
+        const Tick issueTick;
+        Tick finishTick;
+    };
+
+    IOMMU *iommu;
+    Process *process;
+    const int accelId;
+    const unsigned numPages;
+
+    Phase phase;
+
+    /** Mapped addresses being translated, one per page. */
+    std::vector<Addr> vaddrs;
+    /** An address that is not mapped and can't be. */
+    Addr unmappedVaddr;
+
+    /** Requests of the current phase. */
+    std::list<Request> requests;
+    unsigned outstanding;
+
+    /** Shortest time a walk took, hits must be faster. */
+    Tick minWalkLatency;
+
+    /** Translate an address, checking the result once it completes. */
+    Request &translate(Addr vaddr, const Request *leader = nullptr);
+
+    /** Check a completed request, and move on once the phase is over. */
+    void completed(Request &req);
+
+    void startPhase();
+    void checkPhase();
+    EventFunctionWrapper phaseEvent;
+};
+
+#endif // __CPU_TESTERS_IOMMU_TEST_IOMMU_TESTER_HH__
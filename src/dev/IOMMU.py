@@ -0,0 +1,45 @@
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+
+from m5.params import *
+from m5.proxy import *
+from ClockedObject import ClockedObject
+
+class IOMMU(ClockedObject):
+    type = 'IOMMU'
+    cxx_header = "dev/iommu.hh"
+
+    system = Param.System(Parent.any, "System the accelerators are part of")
+
+    page_size = Param.MemorySize('4kB', "Size of the pages in the IOTLB. "
+        "Must match the page size of the ISA")
+    iotlb_size = Param.Unsigned(64, "Number of IOTLB entries")
+    iotlb_assoc = Param.Unsigned(8, "IOTLB associativity")
+    hit_latency = Param.Cycles(2, "Latency of an IOTLB hit")
+
+    walk_levels = Param.Unsigned(4, "Levels of the walked page table")
+    walk_level_latency = Param.Cycles(20,
+        "Latency of every level of a page walk")
+    num_walkers = Param.Unsigned(4,
+        "Number of page walks that can be in flight at once")
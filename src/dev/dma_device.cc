@@ -45,9 +45,10 @@
 
 #include "dev/dma_device.hh"
 
+#include <algorithm>
 #include <utility>
 
-#include "base/chunk_generator.hh"
+#include "base/intmath.hh"
 #include "debug/DMA.hh"
 #include "debug/Drain.hh"
 #include "mem/port_proxy.hh"
@@ -62,20 +63,24 @@ DmaPort::DmaPort(MemObject *dev, System *s, unsigned max_req,
       sendDataAfterInvalidateEvent([this]{ sendDataAfterInvalidate(); }, dev->name()),
       pendingCount(0), inRetry(false),
       maxRequests(max_req),
+      currGrants(0),
       chunkSize(_chunkSize),
       numChannels(_numChannels),
       invalidateOnWrite(_invalidateOnWrite)
 {
+  fatal_if(!isPowerOf2(chunkSize),
+           "%s: DMA chunk size %d is not a power of two.", name(), chunkSize);
+  fatal_if(numChannels == 0, "%s: DMA needs at least one channel.", name());
   numOutstandingRequests = 0;
   currChannel = 0;
-  // Empty DMA channel.
+  // Empty DMA channels, arbitrated in plain round-robin.
   for (unsigned i = 0; i < numChannels; i++)
-    transmitList.push_back(std::deque<PacketPtr>());
+    transmitList.push_back(DmaChannel{std::deque<DmaTransfer>(), 1});
   DPRINTF(DMA, "Setting up DMA with transaction chunk size %d\n", chunkSize);
 }
 
 DmaPort::DmaPort(MemObject *dev, System *s, unsigned max_req)
-    : DmaPort(dev, s, max_req, sys->cacheLineSize()) {}
+    : DmaPort(dev, s, max_req, s->cacheLineSize()) {}
 
 DmaPort::DmaPort(MemObject *dev, System *s)
     : DmaPort(dev, s, MAX_DMA_REQUEST) {}
@@ -108,6 +113,12 @@ DmaPort::handleResp(PacketPtr pkt, Tick delay)
     state->numBytes += pkt->req->getSize();
     assert(state->totBytes >= state->numBytes);
 
+    // let consumers of the transfer know about the data that is in
+    if (state->readyMap) {
+        state->readyMap->markArrived(state->offsetOf(pkt->getAddr()),
+                                     pkt->req->getSize());
+    }
+
     // if we have reached the total number of bytes for this DMA
     // request, then signal the completion and delete the sate
     if (state->totBytes == state->numBytes) {
@@ -126,6 +137,42 @@ DmaPort::handleResp(PacketPtr pkt, Tick delay)
         signalDrainDone();
 }
 
+void
+DmaPort::DmaReqState::trackReadiness(const std::vector<DmaDescriptor> &chain,
+                                     DmaReadyMap *ready_map)
+{
+    readyMap = ready_map;
+
+    Addr offset = 0;
+    segments.reserve(chain.size());
+    for (const auto &desc : chain) {
+        segments.push_back({desc.addr, Addr(desc.size), offset});
+        offset += desc.size;
+    }
+
+    // Responses are mapped back to their segment by address
+    std::sort(segments.begin(), segments.end(),
+              [](const Segment &a, const Segment &b)
+              { return a.addr < b.addr; });
+    for (size_t i = 1; i < segments.size(); i++) {
+        panic_if(segments[i - 1].addr + segments[i - 1].size >
+                 segments[i].addr, "Overlapping DMA segments at %#x with "
+                 "a readiness map.", segments[i].addr);
+    }
+}
+
+Addr
+DmaPort::DmaReqState::offsetOf(Addr pkt_addr) const
+{
+    auto seg = std::upper_bound(segments.begin(), segments.end(), pkt_addr,
+                                [](Addr a, const Segment &s)
+                                { return a < s.addr; });
+    assert(seg != segments.begin());
+    --seg;
+    assert(pkt_addr - seg->addr < seg->size);
+    return seg->offset + (pkt_addr - seg->addr);
+}
+
 bool
 DmaPort::recvTimingResp(PacketPtr pkt)
 {
@@ -171,18 +218,46 @@ DmaPort::recvReqRetry()
 
 RequestPtr
 DmaPort::dmaAction(Packet::Command cmd, Addr addr, int size, Event *event,
-                   uint8_t *data, Tick delay, Request::Flags flag)
+                   uint8_t *data, Tick delay, Request::Flags flag,
+                   int channel, DmaReadyMap *ready_map)
 {
-    DPRINTF(DMA, "Starting DMA for addr: %#x size: %d sched: %d\n",
-            addr, size, event ? event->scheduled() : -1);
+    return dmaActionSg(cmd, {{addr, size, data}}, event, delay, flag,
+                       channel, ready_map);
+}
 
-    DmaActionReq dmaActionReq = { cmd, addr, size, event, data, delay, flag };
+RequestPtr
+DmaPort::dmaActionSg(Packet::Command cmd,
+                     const std::vector<DmaDescriptor> &chain, Event *event,
+                     Tick delay, Request::Flags flag, int channel,
+                     DmaReadyMap *ready_map)
+{
+    panic_if(chain.empty(), "%s: empty DMA descriptor chain.", name());
+    panic_if(channel >= (int)numChannels, "%s: no DMA channel %d.", name(),
+             channel);
+
+    Addr tot_bytes = 0;
+    for (const auto &desc : chain) {
+        panic_if(desc.size <= 0, "%s: DMA descriptor for addr %#x has no "
+                 "bytes.", name(), desc.addr);
+        tot_bytes += desc.size;
+    }
+    const Addr addr = chain.front().addr;
+    panic_if(ready_map && ready_map->size() != tot_bytes,
+             "%s: DMA readiness map of %d bytes for a %d bytes transfer.",
+             name(), ready_map->size(), tot_bytes);
+
+    DPRINTF(DMA, "Starting DMA for addr: %#x size: %d descriptors: %d "
+            "sched: %d\n", addr, tot_bytes, chain.size(),
+            event ? event->scheduled() : -1);
+
+    DmaActionReq dmaActionReq =
+        { cmd, chain, event, delay, flag, channel, ready_map };
 
     // (functionality added for Table Walker statistics)
     // We're only interested in this when there will only be one request.
-    // For simplicity, we return the last request, which would also be
+    // For simplicity, we return the first request, which would also be
     // the only request in that case.
-    RequestPtr final_req = NULL;
+    RequestPtr first_req = NULL;
 
     MemCmd memcmd(cmd);
     if (invalidateOnWrite && memcmd.isWrite()) {
@@ -195,14 +270,19 @@ DmaPort::dmaAction(Packet::Command cmd, Addr addr, int size, Event *event,
         // request for a cache invalidation (that would make no sense).
         Request::Flags inv_flag = flag & ~Request::UNCACHEABLE;
         DmaActionReq invalidateReq = {
-            MemCmd::InvalidateReq, addr, size, event, nullptr, delay, inv_flag };
-        DmaReqState *reqState =
-            new DmaReqState(&sendDataAfterInvalidateEvent, size, addr, delay);
-        final_req = queueDmaAction(invalidateReq, reqState);
+            MemCmd::InvalidateReq, chain, event, delay, inv_flag, channel,
+            nullptr };
+        for (auto &desc : invalidateReq.chain)
+            desc.data = nullptr;
+        DmaReqState *reqState = new DmaReqState(
+            &sendDataAfterInvalidateEvent, tot_bytes, addr, delay);
+        first_req = queueDmaAction(invalidateReq, reqState);
     } else {
         // Act on this dmaAction immediately.
-        DmaReqState* reqState = new DmaReqState(event, size, addr, delay);
-        final_req = queueDmaAction(dmaActionReq, reqState);
+        DmaReqState* reqState = new DmaReqState(event, tot_bytes, addr, delay);
+        if (ready_map)
+            reqState->trackReadiness(chain, ready_map);
+        first_req = queueDmaAction(dmaActionReq, reqState);
     }
 
     // in zero time also initiate the sending of the packets we have
@@ -210,7 +290,17 @@ DmaPort::dmaAction(Packet::Command cmd, Addr addr, int size, Event *event,
     // the requests
     sendDma();
 
-    return final_req;
+    return first_req;
+}
+
+void
+DmaPort::setChannelWeight(unsigned channel, unsigned weight)
+{
+    fatal_if(channel >= numChannels, "%s: no DMA channel %d.", name(),
+             channel);
+    fatal_if(weight == 0, "%s: DMA channel %d needs a weight of at least "
+             "one.", name(), channel);
+    transmitList[channel].weight = weight;
 }
 
 /* Find the next empty channel.
@@ -250,13 +340,82 @@ DmaPort::findNextNonEmptyChannel() {
 }
 
 void
-DmaPort::queueDma(unsigned channel_idx, PacketPtr pkt)
+DmaPort::arbitrate()
 {
-    transmitList[channel_idx].push_back(pkt);
+    const DmaChannel &channel = transmitList[currChannel];
+    if (++currGrants < channel.weight && !channel.empty())
+        return;
 
-    // remember that we have another packet pending, this will only be
-    // decremented once a response comes back
-    pendingCount++;
+    currGrants = 0;
+    currChannel = findNextNonEmptyChannel();
+}
+
+unsigned
+DmaPort::numPackets(const std::vector<DmaDescriptor> &chain) const
+{
+    unsigned num_packets = 0;
+    for (const auto &desc : chain) {
+        num_packets += divCeil(desc.addr + desc.size, chunkSize) -
+            desc.addr / chunkSize;
+    }
+    return num_packets;
+}
+
+void
+DmaPort::queueDma(unsigned channel_idx, DmaTransfer &&xfer)
+{
+    // remember that we have more packets pending, this will only be
+    // decremented as their responses come back
+    pendingCount += numPackets(xfer.chain);
+
+    transmitList[channel_idx].transfers.push_back(std::move(xfer));
+}
+
+PacketPtr
+DmaPort::buildPacket(const DmaTransfer &xfer) const
+{
+    // Chunks are aligned to the chunk size, and do not cross descriptors
+    const DmaDescriptor &desc = xfer.chain[xfer.descIdx];
+    const Addr addr = desc.addr + xfer.offset;
+    const unsigned size = std::min<Addr>(desc.size - xfer.offset,
+                                         chunkSize - (addr & (chunkSize - 1)));
+
+    RequestPtr req = std::make_shared<Request>(addr, size, xfer.flag,
+                                               masterId);
+    req->taskId(ContextSwitchTaskId::DMA);
+    PacketPtr pkt = new Packet(req, xfer.cmd);
+
+    // Increment the data pointer on a write
+    if (desc.data)
+        pkt->dataStatic(desc.data + xfer.offset);
+
+    pkt->senderState = xfer.state;
+    return pkt;
+}
+
+PacketPtr
+DmaPort::channelPacket(unsigned channel_idx)
+{
+    DmaTransfer &xfer = transmitList[channel_idx].transfers.front();
+    if (!xfer.pkt)
+        xfer.pkt = buildPacket(xfer);
+    return xfer.pkt;
+}
+
+void
+DmaPort::popChannelPacket(unsigned channel_idx)
+{
+    DmaChannel &channel = transmitList[channel_idx];
+    DmaTransfer &xfer = channel.transfers.front();
+    assert(xfer.pkt);
+
+    xfer.offset += xfer.pkt->req->getSize();
+    xfer.pkt = nullptr;
+    if (xfer.offset == xfer.chain[xfer.descIdx].size) {
+        xfer.offset = 0;
+        if (++xfer.descIdx == xfer.chain.size())
+            channel.transfers.pop_front();
+    }
 }
 
 void
@@ -264,8 +423,8 @@ DmaPort::trySendTimingReq()
 {
     // send the first packet on the transmit list and schedule the
     // following send if it is successful
-    assert(transmitList[currChannel].size());
-    PacketPtr pkt = transmitList[currChannel].front();
+    assert(!transmitList[currChannel].empty());
+    PacketPtr pkt = channelPacket(currChannel);
 
     DPRINTF(DMA, "Trying to send %s addr %#x of size %d\n", pkt->cmdString(),
             pkt->getAddr(), pkt->req->getSize());
@@ -273,7 +432,7 @@ DmaPort::trySendTimingReq()
     inRetry = !sendTimingReq(pkt);
     if (!inRetry) {
         // pop the first packet in the current channel
-        transmitList[currChannel].pop_front();
+        popChannelPacket(currChannel);
         DPRINTF(DMA,
                "Sent %s addr %#x with size %d from channel %d. \n",
                 pkt->cmdString(),
@@ -281,7 +440,7 @@ DmaPort::trySendTimingReq()
                 pkt->req->getSize(),
                 currChannel);
 
-        currChannel = findNextNonEmptyChannel();
+        arbitrate();
         DPRINTF(DMA, "-- Done\n");
         numOutstandingRequests++;
         // if there is more to do, then do so
@@ -305,10 +464,16 @@ void DmaPort::sendDataAfterInvalidate() {
         return;
 
     DmaActionReq& dmaReq = outstandingRequests.front();
+    Addr tot_bytes = 0;
+    for (const auto &desc : dmaReq.chain)
+        tot_bytes += desc.size;
+    const Addr addr = dmaReq.chain.front().addr;
     DmaReqState *reqState =
-        new DmaReqState(dmaReq.event, dmaReq.size, dmaReq.addr, dmaReq.delay);
+        new DmaReqState(dmaReq.event, tot_bytes, addr, dmaReq.delay);
+    if (dmaReq.readyMap)
+        reqState->trackReadiness(dmaReq.chain, dmaReq.readyMap);
     DPRINTF(DMA, "Sending DMA after invalidation for addr: %#x size: %d\n",
-            dmaReq.addr, dmaReq.size);
+            addr, tot_bytes);
     queueDmaAction(dmaReq, reqState);
     outstandingRequests.pop_front();
     sendDma();
@@ -316,32 +481,22 @@ void DmaPort::sendDataAfterInvalidate() {
 
 RequestPtr DmaPort::queueDmaAction(DmaActionReq &dmaReq,
                                    DmaReqState *reqState) {
-    /* TODO: Currently as we dynamically add channels, the channel ID is the
-     * last channel that is just added. If we switch to the fixed-number of
-     * channels model, we can let users to pick which channel they want to use,
-     * or automatically pick the empty channel. */
-    unsigned channel = findNextEmptyChannel();
-    RequestPtr req = NULL;
+    /* Unless the caller picked a channel, use the next empty one so that
+     * independent transfers are interleaved. */
+    unsigned channel =
+        dmaReq.channel < 0 ? findNextEmptyChannel() : dmaReq.channel;
     MemCmd memcmd(dmaReq.cmd);
-    for (ChunkGenerator gen(dmaReq.addr, dmaReq.size, sys->cacheLineSize());
-         !gen.done(); gen.next()) {
-        req = std::make_shared<Request>(
-            gen.addr(), gen.size(), dmaReq.flag, masterId);
-        req->taskId(ContextSwitchTaskId::DMA);
-        PacketPtr pkt = new Packet(req, dmaReq.cmd);
-
-        // Increment the data pointer on a write
-        if (dmaReq.data)
-            pkt->dataStatic(dmaReq.data + gen.complete());
-
-        pkt->senderState = reqState;
-
-        DPRINTF(DMA, "--Queuing %s for addr: %#x size: %d in channel %d\n",
-                memcmd.isInvalidate() ? "invalidation" : "DMA", gen.addr(),
-                gen.size(), channel);
-        queueDma(channel, pkt);
-    }
-    return req;
+
+    DPRINTF(DMA, "--Queuing %s for addr: %#x size: %d in channel %d\n",
+            memcmd.isInvalidate() ? "invalidation" : "DMA", reqState->addr,
+            reqState->totBytes, channel);
+    queueDma(channel, DmaTransfer{ dmaReq.cmd, dmaReq.flag, dmaReq.chain,
+                                   0, 0, nullptr, reqState });
+
+    // Build the first packet right away to hand its request back
+    DmaTransfer &xfer = transmitList[channel].transfers.back();
+    xfer.pkt = buildPacket(xfer);
+    return xfer.pkt->req;
 }
 
 void
@@ -369,10 +524,10 @@ DmaPort::sendDma()
         trySendTimingReq();
     } else if (sys->isAtomicMode()) {
         // send everything there is to send in zero time
-        for (auto& it : transmitList) {
-          while(!it.empty()){
-            PacketPtr pkt = it.front();
-            it.pop_front();
+        for (unsigned channel = 0; channel < numChannels; channel++) {
+          while (!transmitList[channel].empty()) {
+            PacketPtr pkt = channelPacket(channel);
+            popChannelPacket(channel);
             DPRINTF(DMA, "Sending  DMA for addr: %#x size: %d\n",
                     pkt->req->getPaddr(), pkt->req->getSize());
             Tick lat = sendAtomic(pkt);
@@ -412,6 +567,56 @@ DmaDevice::getMasterPort(const std::string &if_name, PortID idx)
 
 
 
+DmaReadyMap::DmaReadyMap(Addr tot_bytes, Addr _granule, Callback _callback)
+    : totBytes(tot_bytes), granule(_granule),
+      arrivedBytes(divCeil(tot_bytes, _granule), 0),
+      readyBits(arrivedBytes.size(), false), numReady(0),
+      callback(_callback)
+{
+    fatal_if(granule == 0, "DMA readiness granules need at least a byte.");
+}
+
+bool
+DmaReadyMap::ready(Addr offset, Addr size) const
+{
+    assert(offset + size <= totBytes);
+    if (size == 0)
+        return true;
+
+    for (Addr idx = offset / granule; idx <= (offset + size - 1) / granule;
+         idx++) {
+        if (!readyBits[idx])
+            return false;
+    }
+    return true;
+}
+
+void
+DmaReadyMap::markArrived(Addr offset, Addr size)
+{
+    assert(offset + size <= totBytes);
+
+    // A range can span several granules when they are smaller than the
+    // DMA chunks
+    const Addr end = offset + size;
+    while (offset < end) {
+        const unsigned idx = offset / granule;
+        const Addr granule_start = idx * granule;
+        const Addr granule_end = std::min(granule_start + granule, totBytes);
+        const Addr bytes = std::min(end, granule_end) - offset;
+
+        arrivedBytes[idx] += bytes;
+        assert(arrivedBytes[idx] <= granule_end - granule_start);
+        if (arrivedBytes[idx] == granule_end - granule_start) {
+            readyBits[idx] = true;
+            numReady++;
+            if (callback)
+                callback(granule_start, granule_end - granule_start);
+        }
+        offset += bytes;
+    }
+}
+
 DmaReadFifo::DmaReadFifo(DmaPort &_port, size_t size,
                          unsigned max_req_size,
                          unsigned max_pending,
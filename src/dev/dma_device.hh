@@ -46,6 +46,7 @@
 #define __DEV_DMA_DEVICE_HH__
 
 #include <deque>
+#include <functional>
 #include <memory>
 #include <vector>
 
@@ -58,12 +59,97 @@
 //Modification of DMA for Aladdin simulation
 #define MAX_DMA_REQUEST 64
 
+/**
+ * Readiness map of a DMA transfer.
+ *
+ * Splits a transfer into granules of a fixed size (e.g. the tiles a
+ * datapath works on) and records which ones have fully arrived, so that
+ * consumers can start on the first granules while the later ones are in
+ * flight. The map can be polled, and can also call back as each granule
+ * becomes ready. Offsets are relative to the start of the transfer, with
+ * the segments of a scatter-gather transfer laid out back to back.
+ */
+class DmaReadyMap
+{
+  public:
+    /** Called with the offset and size of each granule that gets ready. */
+    typedef std::function<void(Addr offset, Addr size)> Callback;
+
+    /**
+     * @param tot_bytes Size of the tracked transfer, in bytes.
+     * @param granule Size of the granules, in bytes.
+     * @param callback Optional callback for each ready granule.
+     */
+    DmaReadyMap(Addr tot_bytes, Addr granule, Callback callback = nullptr);
+
+    /** Size of the tracked transfer, in bytes. */
+    Addr size() const { return totBytes; }
+
+    /** Size of the granules, in bytes. */
+    Addr granuleSize() const { return granule; }
+
+    /** Number of granules in the transfer. */
+    unsigned numGranules() const { return readyBits.size(); }
+
+    /** Whether a granule has fully arrived. */
+    bool granuleReady(unsigned idx) const { return readyBits[idx]; }
+
+    /**
+     * Whether a range of the transfer has arrived. This is answered at
+     * granule precision, so every granule overlapping the range must be
+     * ready.
+     */
+    bool ready(Addr offset, Addr size) const;
+
+    /** Whether the whole transfer has arrived. */
+    bool allReady() const { return numReady == readyBits.size(); }
+
+    /** The ready bits, one per granule. */
+    const std::vector<bool> &bitmap() const { return readyBits; }
+
+    /**
+     * Account for the arrival of a range of the transfer. This is called
+     * by the DMA port as responses come back.
+     */
+    void markArrived(Addr offset, Addr size);
+
+  private:
+    const Addr totBytes;
+    const Addr granule;
+
+    /** Bytes that have arrived so far in each granule. */
+    std::vector<Addr> arrivedBytes;
+
+    /** Ready bit of each granule. */
+    std::vector<bool> readyBits;
+
+    /** Number of ready granules. */
+    unsigned numReady;
+
+    Callback callback;
+};
+
 class DmaPort : public MasterPort, public Drainable
 {
+  public:
+    /**
+     * One contiguous segment of a scatter-gather transfer. A chain of
+     * descriptors moves data between scattered memory regions and a
+     * single transfer, with one completion event for the whole chain.
+     */
+    struct DmaDescriptor {
+        /** Start address of the segment in memory. */
+        Addr addr;
+        /** Size of the segment, in bytes. */
+        int size;
+        /** Device buffer for the segment, or nullptr if none. */
+        uint8_t *data;
+    };
+
   private:
 
     /**
-     * Take the first packet of the transmit list and attempt to send
+     * Take the first packet of the current channel and attempt to send
      * it as a timing request. If it is successful, schedule the
      * sending of the next packet, otherwise remember that we are
      * waiting for a retry.
@@ -79,17 +165,17 @@ class DmaPort : public MasterPort, public Drainable
      */
     void sendDma();
 
-    // Describes a call to dmaAction(). It can be used to delay the actual
-    // construction and queuing of DMA packets. Each of these fields is an
-    // argument to dmaAction().
+    // Describes a call to dmaAction() or dmaActionSg(). It can be used to
+    // delay the actual queuing of the DMA transfer. Each of these fields is
+    // an argument to dmaActionSg().
     struct DmaActionReq {
         Packet::Command cmd;
-        Addr addr;
-        int size;
+        std::vector<DmaDescriptor> chain;
         Event* event;
-        uint8_t* data;
         Tick delay;
         Request::Flags flag;
+        int channel;
+        DmaReadyMap *readyMap;
     };
 
     /**
@@ -122,11 +208,32 @@ class DmaPort : public MasterPort, public Drainable
         /** Amount to delay completion of dma by */
         const Tick delay;
 
+        /** Readiness map to update as responses come back, if any. */
+        DmaReadyMap *readyMap;
+
+        /** A segment of the transfer, as tracked by the readiness map. */
+        struct Segment {
+            Addr addr;
+            Addr size;
+            /** Offset of the segment in the transfer. */
+            Addr offset;
+        };
+
+        /** Segments of the transfer sorted by address, only kept when
+         * its readiness is tracked. */
+        std::vector<Segment> segments;
+
         DmaReqState(Event *ce, Addr tb, Addr _addr, Tick _delay)
             : completionEvent(ce), totBytes(tb),
-              numBytes(0), addr(_addr), delay(_delay)
+              numBytes(0), addr(_addr), delay(_delay), readyMap(nullptr)
         {}
 
+        /** Start updating a readiness map for the given chain. */
+        void trackReadiness(const std::vector<DmaDescriptor> &chain,
+                            DmaReadyMap *ready_map);
+
+        /** Offset in the transfer of an address of one of its segments. */
+        Addr offsetOf(Addr pkt_addr) const;
     };
 
     /** Event used to act on a delayed dmaAction request. */
@@ -139,8 +246,8 @@ class DmaPort : public MasterPort, public Drainable
      */
     void sendDataAfterInvalidate();
 
-    /** Queue up DMA packets for this DmaActionReq at cache line granularity
-     * and return the last request queued.
+    /** Queue up the transfer of this DmaActionReq, to be sent in packets of
+     * at most the chunk size, and return the request of its first packet.
      */
     RequestPtr queueDmaAction(DmaActionReq& req, DmaReqState *reqState);
 
@@ -157,15 +264,51 @@ class DmaPort : public MasterPort, public Drainable
 
   protected:
 
-    /** Each deque represents a memory channel that never does any insertion or
-     * removal in the middle. A vector of deques are used to represent
-     * multi-chanel DMAs that requests across channels can be interleaved. */
-    std::vector< std::deque<PacketPtr> > transmitList;
+    /**
+     * A transfer queued on a channel. Its packets are built one at a time,
+     * as they are about to be sent, so that large transfers do not hold
+     * one packet per chunk for their whole lifetime.
+     */
+    struct DmaTransfer {
+        Packet::Command cmd;
+        Request::Flags flag;
+        std::vector<DmaDescriptor> chain;
+
+        /** Descriptor being sent. */
+        size_t descIdx;
+
+        /** Bytes of that descriptor that have already been sent. */
+        int offset;
+
+        /** Packet for the next chunk, if already built. */
+        PacketPtr pkt;
+
+        /** State shared by all the packets of the transfer. */
+        DmaReqState *state;
+    };
+
+    /** A virtual DMA channel and its share of the port bandwidth. */
+    struct DmaChannel {
+        /** Transfers in order; only the front one is being sent. */
+        std::deque<DmaTransfer> transfers;
+
+        /** Packets sent in a row when the channel is granted the port. */
+        unsigned weight;
+
+        bool empty() const { return transfers.empty(); }
+    };
+
+    /** Each channel never does any insertion or removal in the middle of
+     * its transfers. A vector of channels is used to represent multi-channel
+     * DMAs whose requests are interleaved, with weighted round-robin
+     * arbitration between the channels. */
+    std::vector<DmaChannel> transmitList;
 
     /** Event used to schedule a future sending from the transmit list. */
     EventFunctionWrapper sendEvent;
 
-    /** Number of outstanding packets the dma port has. */
+    /** Number of outstanding packets the dma port has, including those
+     * that are still to be built. */
     uint32_t pendingCount;
 
     /** If the port is currently waiting for a retry before it can
@@ -180,7 +323,12 @@ class DmaPort : public MasterPort, public Drainable
     /** Keep track of the current channel index to send DMA request. */
     unsigned currChannel;
 
-    /** DMA transaction chunk size. */
+    /** Packets sent by the current channel since it was granted. */
+    unsigned currGrants;
+
+    /** DMA transaction chunk size. Transfers are split into packets of at
+     * most this size, aligned to it, so it should match the burst size of
+     * the memory the port talks to. */
     unsigned chunkSize;
 
     /** Number of virtual DMA channels. */
@@ -197,7 +345,24 @@ class DmaPort : public MasterPort, public Drainable
     bool recvTimingResp(PacketPtr pkt) override;
     void recvReqRetry() override;
 
-    void queueDma(unsigned channel_index, PacketPtr pkt);
+    /** Queue a transfer at the end of a channel. */
+    void queueDma(unsigned channel_idx, DmaTransfer &&xfer);
+
+    /** Build the packet for the next chunk of a transfer. */
+    PacketPtr buildPacket(const DmaTransfer &xfer) const;
+
+    /** Get the next packet of a channel, building it if needed. */
+    PacketPtr channelPacket(unsigned channel_idx);
+
+    /** Move a channel past its next packet, once it has been sent. */
+    void popChannelPacket(unsigned channel_idx);
+
+    /** Number of packets needed to transfer a descriptor chain. */
+    unsigned numPackets(const std::vector<DmaDescriptor> &chain) const;
+
+    /** Grant the port to the next channel if the current one is empty or
+     * has used up its weight. */
+    void arbitrate();
 
     unsigned findNextEmptyChannel();
     unsigned findNextNonEmptyChannel();
@@ -216,8 +381,44 @@ class DmaPort : public MasterPort, public Drainable
             unsigned _chunkSize, unsigned _numChannels = 1,
             bool _invalidateOnWrite = false);
 
+    /**
+     * Transfer a contiguous region.
+     *
+     * @param channel Channel to queue the transfer on, or -1 to pick the
+     *                next empty one.
+     * @param ready_map Readiness map to update as the data arrives, if
+     *                  any. It must cover the transfer and outlive it.
+     * @return The request of the first packet of the transfer, which is
+     *         its only one if it fits in a chunk.
+     */
     RequestPtr dmaAction(Packet::Command cmd, Addr addr, int size, Event *event,
-                         uint8_t *data, Tick delay, Request::Flags flag = 0);
+                         uint8_t *data, Tick delay, Request::Flags flag = 0,
+                         int channel = -1, DmaReadyMap *ready_map = nullptr);
+
+    /**
+     * Transfer a chain of descriptors as a single scatter-gather
+     * transfer. The completion event is only scheduled once all the
+     * segments are done.
+     *
+     * @param channel Channel to queue the transfer on, or -1 to pick the
+     *                next empty one.
+     * @param ready_map Readiness map to update as the data arrives, if
+     *                  any. It must cover the transfer and outlive it, and
+     *                  the segments must not overlap.
+     * @return The request of the first packet of the transfer.
+     */
+    RequestPtr dmaActionSg(Packet::Command cmd,
+                           const std::vector<DmaDescriptor> &chain,
+                           Event *event, Tick delay,
+                           Request::Flags flag = 0, int channel = -1,
+                           DmaReadyMap *ready_map = nullptr);
+
+    /**
+     * Set the number of packets a channel may send in a row when it is
+     * granted the port. All channels have a weight of one by default,
+     * which gives plain round-robin arbitration.
+     */
+    void setChannelWeight(unsigned channel, unsigned weight);
 
     bool dmaPending() const { return pendingCount > 0; }
 
@@ -0,0 +1,314 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dev/iommu.hh"
+
+#include "arch/isa_traits.hh"
+#include "base/intmath.hh"
+#include "config/the_isa.hh"
+#include "debug/IOMMU.hh"
+#include "mem/page_table.hh"
+#include "params/IOMMU.hh"
+#include "sim/process.hh"
+#include "sim/system.hh"
+
+IOMMU::IOMMU(const IOMMUParams *p)
+    : ClockedObject(p), system(p->system),
+      pageShift(floorLog2(p->page_size)),
+      numSets(p->iotlb_size / p->iotlb_assoc), assoc(p->iotlb_assoc),
+      hitLatency(p->hit_latency), walkLevelLatency(p->walk_level_latency),
+      walkLevels(p->walk_levels), numWalkers(p->num_walkers),
+      iotlb(p->iotlb_size), useCount(0),
+      respondEvent([this]{ respond(); }, name()),
+      walkDoneEvent([this]{ completeWalk(); }, name())
+{
+    fatal_if(p->page_size != TheISA::PageBytes,
+             "IOMMU page size must match the ISA page size (%d bytes), as "
+             "its walks read the page table of the process.",
+             TheISA::PageBytes);
+    fatal_if(p->iotlb_assoc == 0 || p->iotlb_size % p->iotlb_assoc,
+             "IOTLB size must be a multiple of its associativity.");
+    fatal_if(!isPowerOf2(numSets),
+             "Number of IOTLB sets must be a power of 2.");
+    fatal_if(numWalkers == 0, "IOMMU needs at least one walker.");
+
+    invalidateAll();
+    system->registerIOMMU(this);
+}
+
+void
+IOMMU::bindAccelerator(int accel_id, Process *p)
+{
+    auto it = boundProcesses.find(accel_id);
+    if (it != boundProcesses.end() && it->second == p)
+        return;
+
+    DPRINTF(IOMMU, "Binding accelerator %d to process %d.\n",
+            accel_id, p->pid());
+    boundProcesses[accel_id] = p;
+}
+
+void
+IOMMU::unbindAccelerator(int accel_id)
+{
+    boundProcesses.erase(accel_id);
+}
+
+bool
+IOMMU::isBound(int accel_id) const
+{
+    return boundProcesses.find(accel_id) != boundProcesses.end();
+}
+
+Process *
+IOMMU::boundProcess(int accel_id) const
+{
+    auto it = boundProcesses.find(accel_id);
+    fatal_if(it == boundProcesses.end(),
+             "IOMMU: accelerator %d is not bound to a process.", accel_id);
+    return it->second;
+}
+
+IOMMU::IOTLBEntry *
+IOMMU::lookup(const Process *p, Addr vpn)
+{
+    IOTLBEntry *set = &iotlb[(vpn & (numSets - 1)) * assoc];
+    for (unsigned way = 0; way < assoc; way++) {
+        IOTLBEntry &e = set[way];
+        if (e.valid && e.process == p && e.vpn == vpn) {
+            e.lastUse = ++useCount;
+            return &e;
+        }
+    }
+    return nullptr;
+}
+
+void
+IOMMU::insert(const Process *p, Addr vpn, Addr ppn)
+{
+    IOTLBEntry *set = &iotlb[(vpn & (numSets - 1)) * assoc];
+    IOTLBEntry *victim = &set[0];
+    for (unsigned way = 0; way < assoc; way++) {
+        IOTLBEntry &e = set[way];
+        if (e.valid && e.process == p && e.vpn == vpn) {
+            victim = &e;
+            break;
+        }
+        if (!e.valid || (victim->valid && e.lastUse < victim->lastUse))
+            victim = &e;
+    }
+    *victim = {true, p, vpn, ppn, ++useCount};
+}
+
+bool
+IOMMU::walkPageTable(Process *p, Addr vpn, Addr &ppn)
+{
+    Addr vaddr = vpn << pageShift;
+    Addr paddr;
+    if (!p->pTable->translate(vaddr, paddr)) {
+        // Fix the fault up the way the CPU would, which in SE mode
+        // means growing the stack onto the page
+        if (!p->fixupStackFault(vaddr) ||
+            !p->pTable->translate(vaddr, paddr)) {
+            return false;
+        }
+        pageFaults++;
+    }
+    ppn = paddr >> pageShift;
+    return true;
+}
+
+void
+IOMMU::translateTiming(int accel_id, Addr vaddr, Translation *t)
+{
+    Process *p = boundProcess(accel_id);
+    Addr vpn = vaddr >> pageShift;
+
+    if (IOTLBEntry *e = lookup(p, vpn)) {
+        iotlbHits++;
+        Addr paddr = (e->ppn << pageShift) | (vaddr & mask(pageShift));
+        responses.push_back({clockEdge(hitLatency), t, vaddr, paddr});
+        if (!respondEvent.scheduled())
+            schedule(respondEvent, responses.front().when);
+        return;
+    }
+
+    iotlbMisses++;
+
+    // Translations for a page that is already being walked wait for
+    // that walk
+    for (auto list : {&activeWalks, &queuedWalks}) {
+        for (auto &walk : *list) {
+            if (walk.process == p && walk.vpn == vpn) {
+                walksCoalesced++;
+                walk.waiters.push_back({t, vaddr});
+                return;
+            }
+        }
+    }
+
+    Walk walk{p, vpn, curTick(), 0, {{t, vaddr}}};
+    if (activeWalks.size() < numWalkers) {
+        startWalk(std::move(walk));
+    } else {
+        DPRINTF(IOMMU, "No walker free for address %#x.\n", vaddr);
+        queuedWalks.push_back(std::move(walk));
+    }
+}
+
+bool
+IOMMU::translateFunctional(int accel_id, Addr vaddr, Addr &paddr)
+{
+    return boundProcess(accel_id)->pTable->translate(vaddr, paddr);
+}
+
+void
+IOMMU::startWalk(Walk &&walk)
+{
+    DPRINTF(IOMMU, "Walking the page table for address %#x.\n",
+            walk.vpn << pageShift);
+    walks++;
+    walk.doneTick = clockEdge(Cycles(walkLevels * walkLevelLatency));
+    activeWalks.push_back(std::move(walk));
+    if (!walkDoneEvent.scheduled())
+        schedule(walkDoneEvent, activeWalks.front().doneTick);
+}
+
+void
+IOMMU::completeWalk()
+{
+    Walk walk = std::move(activeWalks.front());
+    activeWalks.pop_front();
+
+    walkLatency.sample(curTick() - walk.requestTick);
+
+    Addr ppn = 0;
+    bool fault = !walkPageTable(walk.process, walk.vpn, ppn);
+    if (fault) {
+        DPRINTF(IOMMU, "Translation fault on address %#x.\n",
+                walk.vpn << pageShift);
+        translationFaults++;
+    } else {
+        insert(walk.process, walk.vpn, ppn);
+    }
+
+    if (!queuedWalks.empty()) {
+        startWalk(std::move(queuedWalks.front()));
+        queuedWalks.pop_front();
+    }
+    if (!activeWalks.empty() && !walkDoneEvent.scheduled())
+        schedule(walkDoneEvent, activeWalks.front().doneTick);
+
+    for (const auto &w : walk.waiters) {
+        Addr paddr = (ppn << pageShift) | (w.vaddr & mask(pageShift));
+        w.translation->finish(w.vaddr, paddr, fault);
+    }
+}
+
+void
+IOMMU::respond()
+{
+    while (!responses.empty() && responses.front().when <= curTick()) {
+        Response r = responses.front();
+        responses.pop_front();
+        r.translation->finish(r.vaddr, r.paddr, false);
+    }
+    if (!responses.empty() && !respondEvent.scheduled())
+        schedule(respondEvent, responses.front().when);
+}
+
+void
+IOMMU::invalidate(const Process *p, Addr vaddr, Addr size)
+{
+    if (size == 0)
+        return;
+
+    DPRINTF(IOMMU, "Invalidating %#x-%#x for process %d.\n",
+            vaddr, vaddr + size, p->pid());
+
+    Addr first = vaddr >> pageShift;
+    Addr last = (vaddr + size - 1) >> pageShift;
+    for (auto &e : iotlb) {
+        if (e.valid && e.process == p && e.vpn >= first && e.vpn <= last) {
+            e.valid = false;
+            invalidations++;
+        }
+    }
+}
+
+void
+IOMMU::invalidateAll()
+{
+    for (auto &e : iotlb)
+        e.valid = false;
+}
+
+void
+IOMMU::regStats()
+{
+    ClockedObject::regStats();
+
+    using namespace Stats;
+
+    iotlbHits
+        .name(name() + ".iotlbHits")
+        .desc("Translations that hit in the IOTLB");
+
+    iotlbMisses
+        .name(name() + ".iotlbMisses")
+        .desc("Translations that missed in the IOTLB");
+
+    walks
+        .name(name() + ".walks")
+        .desc("Page table walks");
+
+    walksCoalesced
+        .name(name() + ".walksCoalesced")
+        .desc("IOTLB misses served by a walk already under way");
+
+    pageFaults
+        .name(name() + ".pageFaults")
+        .desc("Page faults fixed up by a page walk");
+
+    translationFaults
+        .name(name() + ".translationFaults")
+        .desc("Translations of unmapped addresses");
+
+    invalidations
+        .name(name() + ".invalidations")
+        .desc("IOTLB entries invalidated");
+
+    walkLatency
+        .init(16)
+        .name(name() + ".walkLatency")
+        .desc("Ticks from an IOTLB miss to the end of its walk")
+        .flags(nozero);
+}
+
+IOMMU *
+IOMMUParams::create()
+{
+    return new IOMMU(this);
+}
@@ -0,0 +1,218 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Describes an IOMMU for accelerators. An accelerator bound to a process
+ * translates its virtual addresses on demand through the IOMMU, with
+ * ATS-style translation requests. Misses in the IOTLB are served by a
+ * page walker that reads the page table of the process, so the
+ * accelerator shares its address space with the CPU and sees the same
+ * mappings, page faults included.
+ */
+
+#ifndef __DEV_IOMMU_HH__
+#define __DEV_IOMMU_HH__
+
+#include <deque>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "base/types.hh"
+#include "sim/clocked_object.hh"
+
+class Process;
+class System;
+struct IOMMUParams;
+
+class IOMMU : public ClockedObject
+{
+  public:
+    /**
+     * A translation request from an accelerator. The IOMMU calls
+     * finish() once the translation completes.
+     */
+    class Translation
+    {
+      public:
+        virtual ~Translation() {}
+
+        /**
+         * @param vaddr The virtual address that was translated.
+         * @param paddr The physical address, if there was no fault.
+         * @param fault Whether the address is not mapped.
+         */
+        virtual void finish(Addr vaddr, Addr paddr, bool fault) = 0;
+    };
+
+    IOMMU(const IOMMUParams *p);
+
+    /** Make an accelerator translate through the page table of p. */
+    void bindAccelerator(int accel_id, Process *p);
+
+    /** Forget an accelerator, e.g. once it finished running. */
+    void unbindAccelerator(int accel_id);
+
+    /** Whether an accelerator is bound to a process. */
+    bool isBound(int accel_id) const;
+
+    /**
+     * Translate an address of an accelerator. The translation finishes
+     * after the IOTLB hit latency, or once a page walk completes.
+     */
+    void translateTiming(int accel_id, Addr vaddr, Translation *t);
+
+    /**
+     * Translate an address right away, without any timing and without
+     * touching the IOTLB.
+     *
+     * @return False if the address is not mapped.
+     */
+    bool translateFunctional(int accel_id, Addr vaddr, Addr &paddr);
+
+    /**
+     * Invalidate the IOTLB entries of a process in a range of virtual
+     * addresses, e.g. when the range is unmapped.
+     */
+    void invalidate(const Process *p, Addr vaddr, Addr size);
+
+    /** Invalidate all the IOTLB entries. */
+    void invalidateAll();
+
+    void regStats() override;
+
+  protected:
+    /** The system the accelerators are part of. */
+    System *system;
+
+    /** Log2 of the size of the pages tracked by the IOTLB. */
+    const unsigned pageShift;
+
+    /** Number of IOTLB sets and ways. */
+    const unsigned numSets;
+    const unsigned assoc;
+
+    /** Latency of an IOTLB hit. */
+    const Cycles hitLatency;
+
+    /** Latency of every level of a page walk. */
+    const Cycles walkLevelLatency;
+
+    /** Number of levels of the walked page table. */
+    const unsigned walkLevels;
+
+    /** Number of page walks that can be in flight at once. */
+    const unsigned numWalkers;
+
+    /** The process each accelerator translates for. */
+    std::unordered_map<int, Process *> boundProcesses;
+
+    struct IOTLBEntry
+    {
+        bool valid;
+        /** The process the entry belongs to. */
+        const Process *process;
+        Addr vpn;
+        Addr ppn;
+        uint64_t lastUse;
+    };
+
+    std::vector<IOTLBEntry> iotlb;
+    uint64_t useCount;
+
+    /** A translation waiting for a page walk. */
+    struct Waiter
+    {
+        Translation *translation;
+        Addr vaddr;
+    };
+
+    /** A page walk, and the translations it serves. */
+    struct Walk
+    {
+        Process *process;
+        Addr vpn;
+        /** When the walk was requested. */
+        Tick requestTick;
+        /** When the walk completes, once it started. */
+        Tick doneTick;
+        std::vector<Waiter> waiters;
+    };
+
+    /**
+     * Walks in flight, in the order they complete, and walks waiting
+     * for a walker. Walks all take the same time, so the walk at the
+     * front of the active list always completes first.
+     */
+    std::list<Walk> activeWalks;
+    std::list<Walk> queuedWalks;
+
+    /** A translation that hit in the IOTLB. */
+    struct Response
+    {
+        Tick when;
+        Translation *translation;
+        Addr vaddr;
+        Addr paddr;
+    };
+
+    /** IOTLB hits in the order they are returned. */
+    std::deque<Response> responses;
+
+    IOTLBEntry *lookup(const Process *p, Addr vpn);
+    void insert(const Process *p, Addr vpn, Addr ppn);
+
+    Process *boundProcess(int accel_id) const;
+
+    /**
+     * Find the physical page of a virtual page of a process, fixing up
+     * the page fault the way the CPU would if it is not mapped yet.
+     *
+     * @return False if the page is not mapped and cannot be.
+     */
+    bool walkPageTable(Process *p, Addr vpn, Addr &ppn);
+
+    /** Start a walk on a walker. */
+    void startWalk(Walk &&walk);
+
+    void respond();
+    EventFunctionWrapper respondEvent;
+
+    void completeWalk();
+    EventFunctionWrapper walkDoneEvent;
+
+    Stats::Scalar iotlbHits;
+    Stats::Scalar iotlbMisses;
+    Stats::Scalar walks;
+    Stats::Scalar walksCoalesced;
+    Stats::Scalar pageFaults;
+    Stats::Scalar translationFaults;
+    Stats::Scalar invalidations;
+    Stats::Histogram walkLatency;
+};
+
+#endif //__DEV_IOMMU_HH__
@@ -76,6 +76,10 @@ class DistEtherLink(EtherObject):
     is_switch = Param.Bool(False, "true if this a link in etherswitch")
     dist_sync_on_pseudo_op = Param.Bool(False, "Start sync with pseudo_op")
     num_nodes = Param.UInt32('2', "Number of simulate nodes")
+    dist_transport = Param.String('tcp', "Transport to the peer gem5 "
+                                  "processes (tcp or shm)")
+    shm_ring_size = Param.MemorySize('4MB', "Size of each shared memory "
+                                     "ring of the shm transport")
 
 class EtherBus(EtherObject):
     type = 'EtherBus'
@@ -95,6 +99,8 @@ class EtherSwitch(EtherObject):
     delay = Param.Latency('0us', "packet transmit delay")
     delay_var = Param.Latency('0ns', "packet transmit delay variability")
     time_to_live = Param.Latency('10ms', "time to live of MAC address maping")
+    batch_forwarding = Param.Bool(False, "send the frames due in a tick "
+                                  "on all ports from a single event")
 
 class EtherTapBase(EtherObject):
     type = 'EtherTapBase'
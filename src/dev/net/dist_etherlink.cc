@@ -63,6 +63,7 @@
 #include "dev/net/etherlink.hh"
 #include "dev/net/etherobject.hh"
 #include "dev/net/etherpkt.hh"
+#include "dev/net/shm_iface.hh"
 #include "dev/net/tcp_iface.hh"
 #include "params/EtherLink.hh"
 #include "sim/core.hh"
@@ -91,12 +92,26 @@ DistEtherLink::DistEtherLink(const Params *p)
         sync_repeat = p->delay;
     }
 
-    // create the dist (TCP) interface to talk to the peer gem5 processes.
-    distIface = new TCPIface(p->server_name, p->server_port,
-                             p->dist_rank, p->dist_size,
-                             p->sync_start, sync_repeat, this,
-                             p->dist_sync_on_pseudo_op, p->is_switch,
-                             p->num_nodes);
+    // create the dist interface to talk to the peer gem5 processes.
+    if (p->dist_transport == "tcp") {
+        distIface = new TCPIface(p->server_name, p->server_port,
+                                 p->dist_rank, p->dist_size,
+                                 p->sync_start, sync_repeat, this,
+                                 p->dist_sync_on_pseudo_op, p->is_switch,
+                                 p->num_nodes);
+    } else if (p->dist_transport == "shm") {
+        // All the processes of a run are on the same host, the server
+        // port tells the runs apart
+        distIface = new ShmIface(csprintf("gem5-dist.%d", p->server_port),
+                                 p->shm_ring_size,
+                                 p->dist_rank, p->dist_size,
+                                 p->sync_start, sync_repeat, this,
+                                 p->dist_sync_on_pseudo_op, p->is_switch,
+                                 p->num_nodes);
+    } else {
+        fatal("DistEtherLink(): unknown dist transport '%s'",
+              p->dist_transport);
+    }
 
     localIface = new LocalIface(name() + ".int0", txLink, rxLink, distIface);
 }
@@ -234,7 +249,7 @@ DistEtherLink::Link::unserialize(CheckpointIn &cp)
     bool packet_exists;
     UNSERIALIZE_SCALAR(packet_exists);
     if (packet_exists) {
-        packet = make_shared<EthPacketData>();
+        packet = makeEthPacket();
         packet->unserialize("packet", cp);
     }
 
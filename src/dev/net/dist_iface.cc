@@ -564,7 +564,7 @@ DistIface::RecvScheduler::Desc::unserialize(CheckpointIn &cp)
 {
         UNSERIALIZE_SCALAR(sendTick);
         UNSERIALIZE_SCALAR(sendDelay);
-        packet = std::make_shared<EthPacketData>();
+        packet = makeEthPacket();
         packet->unserialize("rxPacket", cp);
 }
 
@@ -167,18 +167,16 @@ EtherLink::Link::txDone()
 void
 EtherLink::Link::processTxQueue()
 {
-    auto cur(txQueue.front());
-    txQueue.pop_front();
-
-    // Schedule a new event to process the next packet in the queue.
-    if (!txQueue.empty()) {
-        auto next(txQueue.front());
-        assert(next.first > curTick());
-        parent->schedule(txQueueEvent, next.first);
+    // Deliver all the packets due now from this one event
+    while (!txQueue.empty() && txQueue.front().first <= curTick()) {
+        auto cur(txQueue.front());
+        txQueue.pop_front();
+        txComplete(cur.second);
     }
 
-    assert(cur.first == curTick());
-    txComplete(cur.second);
+    // Schedule a new event to process the next packet in the queue.
+    if (!txQueue.empty() && !txQueueEvent.scheduled())
+        parent->schedule(txQueueEvent, txQueue.front().first);
 }
 
 bool
@@ -236,7 +234,7 @@ EtherLink::Link::unserialize(const string &base, CheckpointIn &cp)
     bool packet_exists;
     paramIn(cp, base + ".packet_exists", packet_exists);
     if (packet_exists) {
-        packet = make_shared<EthPacketData>();
+        packet = makeEthPacket();
         packet->unserialize(base + ".packet", cp);
     }
 
@@ -252,7 +250,7 @@ EtherLink::Link::unserialize(const string &base, CheckpointIn &cp)
     if (optParamIn(cp, base + ".tx_queue_size", tx_queue_size)) {
         for (size_t idx = 0; idx < tx_queue_size; ++idx) {
             Tick tick;
-            EthPacketPtr delayed_packet = make_shared<EthPacketData>();
+            EthPacketPtr delayed_packet = makeEthPacket();
 
             paramIn(cp, csprintf("%s.txQueue[%i].tick", base, idx), tick);
             delayed_packet->unserialize(
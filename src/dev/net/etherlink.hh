@@ -96,8 +96,9 @@ class EtherLink : public EtherObject
 
         /**
          * Maintain a queue of in-flight packets. Assume that the
-         * delay is non-zero and constant (i.e., at most one packet
-         * per tick).
+         * delay is non-zero and constant, so packets come out in the
+         * order they went in. All the packets due in a tick are
+         * delivered by the same event.
          */
         std::deque<std::pair<Tick, EthPacketPtr>> txQueue;
 
@@ -31,6 +31,8 @@
 #include "dev/net/etherpkt.hh"
 
 #include <iostream>
+#include <unordered_map>
+#include <vector>
 
 #include "base/inet.hh"
 #include "base/logging.hh"
@@ -38,6 +40,45 @@
 
 using namespace std;
 
+namespace {
+
+/** Maximum number of free buffers of a size kept per thread. */
+const size_t MaxFreeBuffers = 1024;
+
+typedef unordered_map<unsigned, vector<uint8_t *>> BufferPool;
+
+BufferPool &
+bufferPool()
+{
+    // Never destroyed, as packets may still be freed on exit
+    static thread_local BufferPool *pool = new BufferPool;
+    return *pool;
+}
+
+} // anonymous namespace
+
+uint8_t *
+EthPacketData::allocBuffer(unsigned size)
+{
+    vector<uint8_t *> &free_bufs = bufferPool()[size];
+    if (free_bufs.empty())
+        return new uint8_t[size];
+
+    uint8_t *buf = free_bufs.back();
+    free_bufs.pop_back();
+    return buf;
+}
+
+void
+EthPacketData::freeBuffer(uint8_t *buf, unsigned size)
+{
+    vector<uint8_t *> &free_bufs = bufferPool()[size];
+    if (free_bufs.size() < MaxFreeBuffers)
+        free_bufs.push_back(buf);
+    else
+        delete [] buf;
+}
+
 void
 EthPacketData::serialize(const string &base, CheckpointOut &cp) const
 {
@@ -66,7 +107,7 @@ EthPacketData::unserialize(const string &base, CheckpointIn &cp)
     }
     assert(length <= bufLength);
     if (!data)
-        data = new uint8_t[bufLength];
+        data = allocBuffer(bufLength);
     arrayParamIn(cp, base + ".data", data, length);
     if (!optParamIn(cp, base + ".simLength", simLength))
         simLength = length;
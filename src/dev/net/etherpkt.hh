@@ -37,12 +37,73 @@
 #define __DEV_NET_ETHERPKT_HH__
 
 #include <cassert>
+#include <cstddef>
 #include <iosfwd>
 #include <memory>
+#include <vector>
 
 #include "base/types.hh"
 #include "sim/serialize.hh"
 
+/**
+ * Allocator that recycles single objects through a per-thread free
+ * list, so that the packets and the containers holding them do not go
+ * to the heap for every frame. Packets are created and freed on the
+ * threads of the dist-gem5 interfaces as well, hence the free list per
+ * thread; an object may be freed on a different thread than the one it
+ * was allocated on.
+ */
+template <class T>
+class EthPoolAllocator
+{
+  public:
+    typedef T value_type;
+
+    /** Maximum number of free objects kept per thread. */
+    static const size_t MaxFree = 4096;
+
+    EthPoolAllocator() {}
+    template <class U>
+    EthPoolAllocator(const EthPoolAllocator<U> &) {}
+
+    T *
+    allocate(size_t n)
+    {
+        std::vector<void *> &free_list = freeList();
+        if (n == 1 && !free_list.empty()) {
+            void *p = free_list.back();
+            free_list.pop_back();
+            return static_cast<T *>(p);
+        }
+        return static_cast<T *>(::operator new(n * sizeof(T)));
+    }
+
+    void
+    deallocate(T *p, size_t n)
+    {
+        std::vector<void *> &free_list = freeList();
+        if (n == 1 && free_list.size() < MaxFree)
+            free_list.push_back(p);
+        else
+            ::operator delete(p);
+    }
+
+    template <class U>
+    bool operator==(const EthPoolAllocator<U> &) const { return true; }
+    template <class U>
+    bool operator!=(const EthPoolAllocator<U> &) const { return false; }
+
+  private:
+    static std::vector<void *> &
+    freeList()
+    {
+        // Never destroyed, as objects may still be freed on exit
+        static thread_local std::vector<void *> *free_list =
+            new std::vector<void *>;
+        return *free_list;
+    }
+};
+
 /*
  * Reference counted class containing ethernet packet data
  */
@@ -78,10 +139,17 @@ class EthPacketData
     { }
 
     explicit EthPacketData(unsigned size)
-        : data(new uint8_t[size]), bufLength(size), length(0), simLength(0)
+        : data(allocBuffer(size)), bufLength(size), length(0), simLength(0)
     { }
 
-    ~EthPacketData() { if (data) delete [] data; }
+    ~EthPacketData() { if (data) freeBuffer(data, bufLength); }
+
+    /**
+     * Get a data buffer of the given size, recycling the buffers of
+     * the packets freed before.
+     */
+    static uint8_t *allocBuffer(unsigned size);
+    static void freeBuffer(uint8_t *buf, unsigned size);
 
     void serialize(const std::string &base, CheckpointOut &cp) const;
     void unserialize(const std::string &base, CheckpointIn &cp);
@@ -89,4 +157,22 @@ class EthPacketData
 
 typedef std::shared_ptr<EthPacketData> EthPacketPtr;
 
+/**
+ * Create a packet, taking the packet, its reference count and its data
+ * buffer from the pools.
+ */
+inline EthPacketPtr
+makeEthPacket()
+{
+    return std::allocate_shared<EthPacketData>(
+        EthPoolAllocator<EthPacketData>());
+}
+
+inline EthPacketPtr
+makeEthPacket(unsigned size)
+{
+    return std::allocate_shared<EthPacketData>(
+        EthPoolAllocator<EthPacketData>(), size);
+}
+
 #endif // __DEV_NET_ETHERPKT_HH__
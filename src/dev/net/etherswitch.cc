@@ -43,7 +43,9 @@
 using namespace std;
 
 EtherSwitch::EtherSwitch(const Params *p)
-    : EtherObject(p), ttl(p->time_to_live)
+    : EtherObject(p), ttl(p->time_to_live),
+      batchForwarding(p->batch_forwarding), inBatch(false),
+      batchEvent([this]{ forwardBatch(); }, name())
 {
     for (int i = 0; i < p->port_interface_connection_count; ++i) {
         std::string interfaceName = csprintf("%s.interface%d", name(), i);
@@ -74,21 +76,57 @@ EtherSwitch::getEthPort(const std::string &if_name, int idx)
     return interface;
 }
 
+void
+EtherSwitch::forwardBatch()
+{
+    inBatch = true;
+    while (!txSchedule.empty() && txSchedule.begin()->first <= curTick()) {
+        Interface *interface = txSchedule.begin()->second;
+        txSchedule.erase(txSchedule.begin());
+        interface->batchTransmit();
+    }
+    inBatch = false;
+    updateBatchEvent();
+}
+
+void
+EtherSwitch::updateBatchEvent()
+{
+    if (inBatch)
+        return;
+
+    if (txSchedule.empty()) {
+        if (batchEvent.scheduled())
+            deschedule(batchEvent);
+    } else {
+        reschedule(batchEvent, txSchedule.begin()->first, true);
+    }
+}
+
 bool
 EtherSwitch::Interface::PortFifo::push(EthPacketPtr ptr, unsigned senderId)
 {
     assert(ptr->length);
 
     _size += ptr->length;
-    fifo.emplace_hint(fifo.end(), ptr, curTick(), senderId);
+
+    // Packets received in the same tick go in the order of their ports
+    auto pos = fifo.end();
+    while (pos != fifo.begin()) {
+        auto prev = std::prev(pos);
+        if (prev->recvTick != curTick() || prev->srcId <= senderId)
+            break;
+        pos = prev;
+    }
+    fifo.emplace(pos, ptr, curTick(), senderId);
 
     // Drop the extra pushed packets from end of the fifo
     while (avail() < 0) {
         DPRINTF(Ethernet, "Fifo is full. Drop packet: len=%d\n",
                 std::prev(fifo.end())->packet->length);
 
-        _size -= std::prev(fifo.end())->packet->length;
-        fifo.erase(std::prev(fifo.end()));
+        _size -= fifo.back().packet->length;
+        fifo.pop_back();
     }
 
     if (empty()) {
@@ -115,7 +153,7 @@ EtherSwitch::Interface::PortFifo::pop()
     assert(_size >= fifo.begin()->packet->length);
     // Erase the packet at the head of the queue
     _size -= fifo.begin()->packet->length;
-    fifo.erase(fifo.begin());
+    fifo.pop_front();
 }
 
 void
@@ -132,8 +170,44 @@ EtherSwitch::Interface::Interface(const std::string &name,
     : EtherInt(name), ticksPerByte(rate), switchDelay(delay),
       delayVar(delay_var), interfaceId(id), parent(etherSwitch),
       outputFifo(name + ".outputFifo", outputBufferSize),
-      txEvent([this]{ transmit(); }, name)
+      txEvent([this]{ transmit(); }, name),
+      txPending(false)
+{
+}
+
+void
+EtherSwitch::Interface::scheduleTx(Tick when)
+{
+    if (!parent->batchForwarding) {
+        parent->reschedule(txEvent, when, true);
+        return;
+    }
+
+    if (txPending)
+        parent->txSchedule.erase(txSlot);
+    txSlot = parent->txSchedule.emplace(when, this);
+    txPending = true;
+    parent->updateBatchEvent();
+}
+
+bool
+EtherSwitch::Interface::txScheduled() const
+{
+    return parent->batchForwarding ? txPending : txEvent.scheduled();
+}
+
+Tick
+EtherSwitch::Interface::txWhen() const
+{
+    return parent->batchForwarding ? txSlot->first : txEvent.when();
+}
+
+void
+EtherSwitch::Interface::batchTransmit()
 {
+    assert(txPending);
+    txPending = false;
+    transmit();
 }
 
 bool
@@ -175,7 +249,7 @@ EtherSwitch::Interface::enqueue(EthPacketPtr packet, unsigned senderId)
     // to send this packet out the external link
     // otherwise, there is already a txEvent scheduled
     if (outputFifo.push(packet, senderId)) {
-        parent->reschedule(txEvent, curTick() + switchingDelay(), true);
+        scheduleTx(curTick() + switchingDelay());
     }
 }
 
@@ -187,15 +261,15 @@ EtherSwitch::Interface::transmit()
 
     if (!sendPacket(outputFifo.front())) {
         DPRINTF(Ethernet, "output port busy...retry later\n");
-        if (!txEvent.scheduled())
-            parent->schedule(txEvent, curTick() + retryTime);
+        if (!txScheduled())
+            scheduleTx(curTick() + retryTime);
     } else {
         DPRINTF(Ethernet, "packet sent: len=%d\n", outputFifo.front()->length);
         outputFifo.pop();
         // schedule an event to send the pkt at
         // the head of queue, if there is any
         if (!outputFifo.empty()) {
-            parent->schedule(txEvent, curTick() + switchingDelay());
+            scheduleTx(curTick() + switchingDelay());
         }
     }
 }
@@ -277,11 +351,11 @@ EtherSwitch::unserialize(CheckpointIn &cp)
 void
 EtherSwitch::Interface::serialize(CheckpointOut &cp) const
 {
-    bool event_scheduled = txEvent.scheduled();
+    bool event_scheduled = txScheduled();
     SERIALIZE_SCALAR(event_scheduled);
 
     if (event_scheduled) {
-        Tick event_time = txEvent.when();
+        Tick event_time = txWhen();
         SERIALIZE_SCALAR(event_time);
     }
     outputFifo.serializeSection(cp, "outputFifo");
@@ -296,7 +370,7 @@ EtherSwitch::Interface::unserialize(CheckpointIn &cp)
     if (event_scheduled) {
         Tick event_time;
         UNSERIALIZE_SCALAR(event_time);
-        parent->schedule(txEvent, event_time);
+        scheduleTx(event_time);
     }
     outputFifo.unserializeSection(cp, "outputFifo");
 }
@@ -312,7 +386,7 @@ EtherSwitch::Interface::PortFifoEntry::serialize(CheckpointOut &cp) const
 void
 EtherSwitch::Interface::PortFifoEntry::unserialize(CheckpointIn &cp)
 {
-    packet = make_shared<EthPacketData>(16384);
+    packet = makeEthPacket(16384);
     packet->unserialize("packet", cp);
     UNSERIALIZE_SCALAR(recvTick);
     UNSERIALIZE_SCALAR(srcId);
@@ -345,7 +419,7 @@ EtherSwitch::Interface::PortFifo::unserialize(CheckpointIn &cp)
 
         entry.unserializeSection(cp, csprintf("entry%d", i));
 
-        fifo.insert(entry);
+        fifo.push_back(entry);
 
     }
 }
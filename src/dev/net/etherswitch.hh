@@ -36,8 +36,8 @@
 #ifndef __DEV_ETHERSWITCH_HH__
 #define __DEV_ETHERSWITCH_HH__
 
+#include <deque>
 #include <map>
-#include <set>
 
 #include "base/inet.hh"
 #include "dev/net/etherint.hh"
@@ -121,17 +121,13 @@ class EtherSwitch : public EtherObject
         class PortFifo : public Serializable
         {
           protected:
-            struct EntryOrder {
-                bool operator() (const PortFifoEntry& lhs,
-                                 const PortFifoEntry& rhs) const
-                {
-                    if (lhs.recvTick == rhs.recvTick)
-                        return lhs.srcId < rhs.srcId;
-                    else
-                        return lhs.recvTick < rhs.recvTick;
-                }
-            };
-            std::set<PortFifoEntry, EntryOrder> fifo;
+            /**
+             * Packets in the order they are sent: by receive tick, and
+             * by the id of the port they came from for packets received
+             * in the same tick. Packets arrive in tick order, so a new
+             * packet only moves past the packets of its own tick.
+             */
+            std::deque<PortFifoEntry> fifo;
 
             const std::string objName;
             const unsigned _maxsize;
@@ -171,8 +167,27 @@ class EtherSwitch : public EtherObject
          * output fifo at each interface
          */
         PortFifo outputFifo;
-        void transmit();
         EventFunctionWrapper txEvent;
+
+        /**
+         * When the switch forwards in batches, the next transmission
+         * is a slot in the schedule of the switch instead of txEvent.
+         */
+        bool txPending;
+        std::multimap<Tick, Interface *>::iterator txSlot;
+
+        /** (Re)schedule the next transmission of this port. */
+        void scheduleTx(Tick when);
+        bool txScheduled() const;
+        Tick txWhen() const;
+        void transmit();
+
+      public:
+        /**
+         * Transmit from the batch of the switch, once the slot of this
+         * port has been taken out of the schedule.
+         */
+        void batchTransmit();
     };
 
     struct SwitchTableEntry {
@@ -188,6 +203,21 @@ class EtherSwitch : public EtherObject
     // table that maps MAC address to interfaces
     std::map<uint64_t, SwitchTableEntry> forwardingTable;
 
+    /**
+     * Whether the ports transmit from a single event of the switch,
+     * which sends all the frames due in a tick, instead of each port
+     * having its own event.
+     */
+    const bool batchForwarding;
+    /** Ports with a transmission pending, by the tick it is due. */
+    std::multimap<Tick, Interface *> txSchedule;
+    /** Whether forwardBatch() is going through the due ports. */
+    bool inBatch;
+
+    void forwardBatch();
+    EventFunctionWrapper batchEvent;
+    void updateBatchEvent();
+
     void serialize(CheckpointOut &cp) const override;
     void unserialize(CheckpointIn &cp) override;
 };
@@ -190,7 +190,7 @@ void
 EtherTapBase::sendSimulated(void *data, size_t len)
 {
     EthPacketPtr packet;
-    packet = make_shared<EthPacketData>(len);
+    packet = makeEthPacket(len);
     packet->length = len;
     packet->simLength = len;
     memcpy(packet->data, data, len);
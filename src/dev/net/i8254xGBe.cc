@@ -2169,7 +2169,7 @@ IGbE::txStateMachine()
     }
 
     if (!txPacket) {
-        txPacket = std::make_shared<EthPacketData>(16384);
+        txPacket = makeEthPacket(16384);
     }
 
     if (!txDescCache.packetWaiting()) {
@@ -2550,7 +2550,7 @@ IGbE::unserialize(CheckpointIn &cp)
     bool txPktExists;
     UNSERIALIZE_SCALAR(txPktExists);
     if (txPktExists) {
-        txPacket = std::make_shared<EthPacketData>(16384);
+        txPacket = makeEthPacket(16384);
         txPacket->unserialize("txpacket", cp);
     }
 
@@ -79,12 +79,17 @@ class PacketFifo
 {
   public:
 
-    typedef std::list<PacketFifoEntry> fifo_list;
+    /**
+     * The NICs keep iterators into the fifo across pushes and removes,
+     * so the fifo stays a list, but its nodes come from a pool.
+     */
+    typedef std::list<PacketFifoEntry, EthPoolAllocator<PacketFifoEntry>>
+        fifo_list;
     typedef fifo_list::iterator iterator;
     typedef fifo_list::const_iterator const_iterator;
 
   protected:
-    std::list<PacketFifoEntry> fifo;
+    fifo_list fifo;
     uint64_t _counter;
     unsigned _maxsize;
     unsigned _size;
@@ -0,0 +1,402 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* @file
+ * Shared memory based interface class implementation for dist-gem5 runs.
+ */
+
+#include "dev/net/shm_iface.hh"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <csignal>
+#include <cstring>
+#include <ctime>
+#include <thread>
+
+#include "base/cprintf.hh"
+#include "base/intmath.hh"
+#include "base/trace.hh"
+#include "base/types.hh"
+#include "debug/DistEthernet.hh"
+#include "debug/DistEthernetCmd.hh"
+#include "sim/sim_exit.hh"
+
+using namespace std;
+
+vector<ShmIface::Channel *> ShmIface::chanRegistry;
+
+namespace {
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+              "futex words must be plain 32 bit words");
+
+/**
+ * Sleep until *word is no longer val or somebody wakes us up.
+ *
+ * @return False if the wait timed out, for the caller to check that
+ * its peer is still there.
+ */
+bool
+futexWait(std::atomic<uint32_t> *word, uint32_t val)
+{
+#if defined(__linux__)
+    struct timespec timeout = { 0, 100 * 1000 * 1000 };
+    long ret = syscall(SYS_futex, reinterpret_cast<uint32_t *>(word),
+                       FUTEX_WAIT, val, &timeout, nullptr, 0);
+    return ret == 0 || errno != ETIMEDOUT;
+#else
+    std::this_thread::yield();
+    return true;
+#endif
+}
+
+void
+futexWake(std::atomic<uint32_t> *word)
+{
+#if defined(__linux__)
+    syscall(SYS_futex, reinterpret_cast<uint32_t *>(word),
+            FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#endif
+}
+
+bool
+processAlive(int32_t pid)
+{
+    return pid == 0 || kill(pid, 0) == 0 || errno == EPERM;
+}
+
+/** Poll interval while the processes connect. */
+void
+connectWait()
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
+
+} // anonymous namespace
+
+ShmIface::ShmIface(const string &seg_prefix, uint64_t ring_bytes,
+                   unsigned dist_rank, unsigned dist_size,
+                   Tick sync_start, Tick sync_repeat,
+                   EventManager *em, bool use_pseudo_op, bool is_switch,
+                   int num_nodes) :
+    DistIface(dist_rank, dist_size, sync_start, sync_repeat, em, use_pseudo_op,
+              is_switch, num_nodes), segPrefix(seg_prefix),
+    ringBytes(ring_bytes), isSwitch(is_switch)
+{
+    fatal_if(ringBytes < 2 * sizeof(Header),
+             "ShmIface: ring size %d is too small", ringBytes);
+    chan.seg = nullptr;
+}
+
+ShmIface::~ShmIface()
+{
+    if (!chan.seg)
+        return;
+
+    // Stop our receiver thread and let the peer know we are gone. The
+    // segment stays mapped, as the receiver thread is only joined
+    // once this destructor returns.
+    chan.rx->closed.store(1);
+    futexWake(&chan.rx->dataSeq);
+    chan.tx->closed.store(1);
+    futexWake(&chan.tx->dataSeq);
+
+    auto it = find(chanRegistry.begin(), chanRegistry.end(), &chan);
+    if (it != chanRegistry.end())
+        chanRegistry.erase(it);
+}
+
+string
+ShmIface::segName(unsigned rank, unsigned iface_id) const
+{
+    return csprintf("/%s.%d.%d", segPrefix, rank, iface_id);
+}
+
+void
+ShmIface::mapChannel(int fd, size_t bytes)
+{
+    void *m = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED,
+                   fd, 0);
+    panic_if(m == MAP_FAILED, "mmap() failed: %s", strerror(errno));
+    ::close(fd);
+
+    chan.seg = static_cast<Segment *>(m);
+    chan.segBytes = bytes;
+}
+
+void
+ShmIface::createSegment()
+{
+    string name = segName(rank, distIfaceId);
+    uint64_t data_offset = roundUp(sizeof(Segment), 4096);
+    size_t bytes = data_offset + 2 * ringBytes;
+
+    // Get rid of the segment of an earlier run that did not finish
+    shm_unlink(name.c_str());
+    int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    panic_if(fd < 0, "shm_open(%s) failed: %s", name, strerror(errno));
+    panic_if(ftruncate(fd, bytes) != 0, "ftruncate(%s) failed: %s",
+             name, strerror(errno));
+    mapChannel(fd, bytes);
+
+    Segment *seg = chan.seg;
+    seg->rank = rank;
+    seg->distIfaceId = distIfaceId;
+    seg->distIfaceNum = distIfaceNum;
+    seg->nodePid = getpid();
+    seg->ringBytes = ringBytes;
+
+    uint8_t *base = reinterpret_cast<uint8_t *>(seg);
+    chan.tx = &seg->toSwitch;
+    chan.txData = base + data_offset;
+    chan.rx = &seg->toNode;
+    chan.rxData = base + data_offset + ringBytes;
+    chan.ringBytes = ringBytes;
+    chan.peerPid = &seg->switchPid;
+
+    seg->nodeReady.store(1);
+}
+
+void
+ShmIface::attachSegment(unsigned node_rank, unsigned iface_id)
+{
+    string name = segName(node_rank, iface_id);
+    DPRINTF(DistEthernet, "Waiting for segment %s\n", name);
+
+    // Wait for the node to create and set up its segment
+    int fd;
+    struct stat st;
+    while (true) {
+        fd = shm_open(name.c_str(), O_RDWR, 0600);
+        if (fd >= 0) {
+            panic_if(fstat(fd, &st) != 0, "fstat(%s) failed: %s",
+                     name, strerror(errno));
+            if (st.st_size >= (off_t)sizeof(Segment))
+                break;
+            ::close(fd);
+        }
+        connectWait();
+    }
+    mapChannel(fd, st.st_size);
+
+    Segment *seg = chan.seg;
+    while (!seg->nodeReady.load())
+        connectWait();
+    // The name is not needed anymore, the node and us have it mapped
+    shm_unlink(name.c_str());
+
+    uint64_t ring_bytes = seg->ringBytes;
+    uint64_t data_offset = roundUp(sizeof(Segment), 4096);
+    panic_if(data_offset + 2 * ring_bytes > (uint64_t)st.st_size,
+             "Segment %s is too small for its rings", name);
+
+    uint8_t *base = reinterpret_cast<uint8_t *>(seg);
+    chan.tx = &seg->toNode;
+    chan.txData = base + data_offset + ring_bytes;
+    chan.rx = &seg->toSwitch;
+    chan.rxData = base + data_offset;
+    chan.ringBytes = ring_bytes;
+    chan.peerPid = &seg->nodePid;
+
+    seg->switchIfaceId = distIfaceId;
+    seg->switchPid = getpid();
+    seg->switchReady.store(1);
+}
+
+void
+ShmIface::establishConnection()
+{
+    static unsigned cur_rank = 0;
+    static unsigned cur_id = 0;
+
+    if (isSwitch) {
+        // Links are assigned to the switch interfaces in the same
+        // order as TCPIface does
+        attachSegment(cur_rank, cur_id);
+        const Segment *seg = chan.seg;
+        inform("Link okay  (iface:%d -> (node:%d, iface:%d))",
+               distIfaceId, seg->rank, seg->distIfaceId);
+        if (seg->distIfaceId < seg->distIfaceNum - 1) {
+            cur_id++;
+        } else {
+            cur_rank++;
+            cur_id = 0;
+        }
+    } else {
+        createSegment();
+        DPRINTF(DistEthernet, "Segment created, waiting for the switch "
+                "(distIfaceId:%d)\n", distIfaceId);
+        while (!chan.seg->switchReady.load())
+            connectWait();
+        inform("Link okay  (iface:%d -> switch iface:%d)", distIfaceId,
+               chan.seg->switchIfaceId);
+    }
+    chanRegistry.push_back(&chan);
+}
+
+void
+ShmIface::sendMsg(Channel &c, const void *hdr, size_t hdr_len,
+                  const void *payload, size_t payload_len)
+{
+    size_t len = hdr_len + payload_len;
+    panic_if(len > c.ringBytes, "ShmIface: message of %d bytes does not "
+             "fit in a ring of %d bytes", len, c.ringBytes);
+
+    std::lock_guard<std::mutex> lock(c.txLock);
+    Ring &r = *c.tx;
+    uint64_t head = r.head.load(std::memory_order_relaxed);
+
+    // Wait for the consumer to make room
+    while (head + len - r.tail.load() > c.ringBytes) {
+        uint32_t seq = r.spaceSeq.load();
+        r.producerWaiting.store(1);
+        if (head + len - r.tail.load() <= c.ringBytes)
+            break;
+        if (!futexWait(&r.spaceSeq, seq) && !processAlive(*c.peerPid)) {
+            exitSimLoop("Message server closed connection, simulation "
+                        "is exiting");
+            return;
+        }
+    }
+
+    // Write the message, wrapping around the end of the ring
+    const uint8_t *parts[] = { static_cast<const uint8_t *>(hdr),
+                               static_cast<const uint8_t *>(payload) };
+    size_t lens[] = { hdr_len, payload_len };
+    uint64_t pos = head;
+    for (int i = 0; i < 2; i++) {
+        size_t done = 0;
+        while (done < lens[i]) {
+            uint64_t off = pos % c.ringBytes;
+            size_t chunk = min<uint64_t>(lens[i] - done, c.ringBytes - off);
+            memcpy(c.txData + off, parts[i] + done, chunk);
+            done += chunk;
+            pos += chunk;
+        }
+    }
+
+    // Publish it
+    r.head.store(head + len, std::memory_order_release);
+    r.dataSeq.fetch_add(1);
+    if (r.consumerWaiting.exchange(0))
+        futexWake(&r.dataSeq);
+}
+
+bool
+ShmIface::recvBytes(Channel &c, void *buf, size_t length)
+{
+    Ring &r = *c.rx;
+    uint64_t tail = r.tail.load(std::memory_order_relaxed);
+
+    // Wait for the producer to write the bytes
+    while (r.head.load(std::memory_order_acquire) - tail < length) {
+        if (r.closed.load()) {
+            inform("recv(): Connection closed");
+            return false;
+        }
+        uint32_t seq = r.dataSeq.load();
+        r.consumerWaiting.store(1);
+        if (r.head.load() - tail >= length)
+            break;
+        if (!futexWait(&r.dataSeq, seq) && !processAlive(*c.peerPid)) {
+            inform("recv(): Peer process is gone");
+            return false;
+        }
+    }
+
+    uint8_t *dst = static_cast<uint8_t *>(buf);
+    size_t done = 0;
+    while (done < length) {
+        uint64_t off = (tail + done) % c.ringBytes;
+        size_t chunk = min<uint64_t>(length - done, c.ringBytes - off);
+        memcpy(dst + done, c.rxData + off, chunk);
+        done += chunk;
+    }
+
+    // Hand the space back to the producer
+    r.tail.store(tail + length, std::memory_order_release);
+    r.spaceSeq.fetch_add(1);
+    if (r.producerWaiting.exchange(0))
+        futexWake(&r.spaceSeq);
+    return true;
+}
+
+void
+ShmIface::sendPacket(const Header &header, const EthPacketPtr &packet)
+{
+    sendMsg(chan, &header, sizeof(header), packet->data, packet->length);
+}
+
+void
+ShmIface::sendCmd(const Header &header)
+{
+    DPRINTF(DistEthernetCmd, "ShmIface::sendCmd() type: %d\n",
+            static_cast<int>(header.msgType));
+    // Global commands (i.e. sync request) are always sent by the master
+    // DistIface, on every link of the process
+    for (auto c : chanRegistry)
+        sendMsg(*c, &header, sizeof(header), nullptr, 0);
+}
+
+bool
+ShmIface::recvHeader(Header &header)
+{
+    bool ret = recvBytes(chan, &header, sizeof(header));
+    DPRINTF(DistEthernetCmd, "ShmIface::recvHeader() type: %d ret: %d\n",
+            static_cast<int>(header.msgType), ret);
+    return ret;
+}
+
+void
+ShmIface::recvPacket(const Header &header, EthPacketPtr &packet)
+{
+    packet = makeEthPacket(header.dataPacketLength);
+    bool ret = recvBytes(chan, packet->data, header.dataPacketLength);
+    panic_if(!ret, "Error while reading shared memory ring");
+    packet->simLength = header.simLength;
+    packet->length = header.dataPacketLength;
+}
+
+void
+ShmIface::initTransport()
+{
+    // As for TCPIface, the links are set up once the number of dist
+    // interfaces of every process is known.
+    establishConnection();
+}
@@ -0,0 +1,194 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* @file
+ * Shared memory based interface class for dist-gem5 runs.
+ *
+ * For a high level description about dist-gem5 see comments in
+ * header file dist_iface.hh.
+ *
+ * This is an alternative to TCPIface for when all the gem5 processes of
+ * a dist run are on the same host. Every link between a compute node
+ * and the switch is a POSIX shared memory segment holding a pair of
+ * single producer/single consumer rings, one for each direction. Headers
+ * and frames are written straight into the rings, and a receiver that
+ * finds its ring empty sleeps on a futex until the sender wakes it up,
+ * so neither the synchronisation messages nor the frames go through the
+ * kernel network stack.
+ */
+#ifndef __DEV_NET_SHM_IFACE_HH__
+#define __DEV_NET_SHM_IFACE_HH__
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "dev/net/dist_iface.hh"
+
+class EventManager;
+
+class ShmIface : public DistIface
+{
+  private:
+    /**
+     * Control block of a ring. The data of the ring follows it in the
+     * segment. The producer and the consumer fields are on separate
+     * cache lines.
+     */
+    struct Ring
+    {
+        /** Bytes written so far. Only the producer updates it. */
+        alignas(64) std::atomic<uint64_t> head;
+        /** Bumped after every write, for the consumer to wait on. */
+        std::atomic<uint32_t> dataSeq;
+        /** Whether the producer is gone. */
+        std::atomic<uint32_t> closed;
+
+        /** Bytes read so far. Only the consumer updates it. */
+        alignas(64) std::atomic<uint64_t> tail;
+        /** Bumped after every read, for the producer to wait on. */
+        std::atomic<uint32_t> spaceSeq;
+
+        /** Whether each side is asleep waiting for the other. */
+        alignas(64) std::atomic<uint32_t> consumerWaiting;
+        std::atomic<uint32_t> producerWaiting;
+    };
+
+    /**
+     * Layout of the start of a segment. The segment is created by the
+     * compute node, zero filled, which leaves both rings empty.
+     */
+    struct Segment
+    {
+        /** Set by the node once the fields below are valid. */
+        std::atomic<uint32_t> nodeReady;
+        /** Set by the switch once it has attached. */
+        std::atomic<uint32_t> switchReady;
+
+        /** Link info of the node, as sent by TCPIface. */
+        uint32_t rank;
+        uint32_t distIfaceId;
+        uint32_t distIfaceNum;
+        /** Id of the switch interface, the ack of the switch. */
+        uint32_t switchIfaceId;
+
+        /** Processes at each end, to notice when a peer dies. */
+        int32_t nodePid;
+        int32_t switchPid;
+
+        /** Size of the data of each ring. */
+        uint64_t ringBytes;
+
+        Ring toSwitch;
+        Ring toNode;
+    };
+
+    /** One end of a link. */
+    struct Channel
+    {
+        Segment *seg;
+        size_t segBytes;
+        Ring *tx;
+        uint8_t *txData;
+        Ring *rx;
+        uint8_t *rxData;
+        uint64_t ringBytes;
+        /** The process at the other end. */
+        const int32_t *peerPid;
+        /** Serialises the local senders on the ring. */
+        std::mutex txLock;
+    };
+
+    Channel chan;
+
+    /** Prefix of the names of the segments of this run. */
+    std::string segPrefix;
+    /** Size of the rings of the segments this node creates. */
+    uint64_t ringBytes;
+
+    bool isSwitch;
+
+    /**
+     * All the channels of this process, to send global commands on,
+     * like TCPIface::sockRegistry.
+     */
+    static std::vector<Channel *> chanRegistry;
+
+  private:
+    std::string segName(unsigned rank, unsigned iface_id) const;
+
+    /** Create the segment of a link of this compute node. */
+    void createSegment();
+    /** Attach to the segment of a compute node link, as the switch. */
+    void attachSegment(unsigned rank, unsigned iface_id);
+    void mapChannel(int fd, size_t bytes);
+
+    /**
+     * Send a message made of a header and an optional payload. The
+     * whole message is written to the ring before it is published.
+     */
+    void sendMsg(Channel &c, const void *hdr, size_t hdr_len,
+                 const void *payload, size_t payload_len);
+
+    /**
+     * Receive the next length bytes from the ring, waiting for them if
+     * necessary.
+     *
+     * @return False if the peer closed the link.
+     */
+    bool recvBytes(Channel &c, void *buf, size_t length);
+
+    void establishConnection();
+
+  protected:
+
+    void sendPacket(const Header &header,
+                    const EthPacketPtr &packet) override;
+
+    void sendCmd(const Header &header) override;
+
+    bool recvHeader(Header &header) override;
+
+    void recvPacket(const Header &header, EthPacketPtr &packet) override;
+
+    void initTransport() override;
+
+  public:
+    /**
+     * @param seg_prefix Prefix of the names of the shared memory
+     * segments, which must be the same for all the processes of a run.
+     * @param ring_bytes Size of the rings, in each direction.
+     * @see TCPIface::TCPIface() for the rest of the parameters.
+     */
+    ShmIface(const std::string &seg_prefix, uint64_t ring_bytes,
+             unsigned dist_rank, unsigned dist_size,
+             Tick sync_start, Tick sync_repeat, EventManager *em,
+             bool use_pseudo_op, bool is_switch, int num_nodes);
+
+    ~ShmIface() override;
+};
+
+#endif // __DEV_NET_SHM_IFACE_HH__
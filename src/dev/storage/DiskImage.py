@@ -38,11 +38,14 @@ class DiskImage(SimObject):
 class RawDiskImage(DiskImage):
     type = 'RawDiskImage'
     cxx_header = "dev/storage/disk_image.hh"
+    io_threads = Param.Unsigned(2,
+        "Host threads reading the image ahead, 0 to read synchronously")
+    read_ahead_chunks = Param.Unsigned(256,
+        "Maximum number of 4 KB chunks read ahead")
 
 class CowDiskImage(DiskImage):
     type = 'CowDiskImage'
     cxx_header = "dev/storage/disk_image.hh"
     child = Param.DiskImage(RawDiskImage(read_only=True),
                             "child image")
-    table_size = Param.Int(65536, "initial table size")
     image_file = ""
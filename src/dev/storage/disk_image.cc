@@ -34,11 +34,15 @@
 
 #include "dev/storage/disk_image.hh"
 
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/types.h>
 #include <sys/uio.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <cerrno>
+#include <cstdlib>
 #include <cstring>
 #include <fstream>
 #include <string>
@@ -58,7 +62,8 @@ using namespace std;
 // Raw Disk image
 //
 RawDiskImage::RawDiskImage(const Params* p)
-    : DiskImage(p), disk_size(0)
+    : DiskImage(p), fd(-1), disk_size(0),
+      readAhead(p->io_threads, p->read_ahead_chunks)
 { open(p->image_file, p->read_only); }
 
 RawDiskImage::~RawDiskImage()
@@ -75,6 +80,15 @@ RawDiskImage::notifyFork()
     open(p->image_file, p->read_only);
 }
 
+DrainState
+RawDiskImage::drain()
+{
+    // Threads do not survive a fork, so stop them when the system
+    // drains. They are started again by the next prefetch.
+    readAhead.stop();
+    return DrainState::Drained;
+}
+
 void
 RawDiskImage::open(const string &filename, bool rd_only)
 {
@@ -83,11 +97,8 @@ RawDiskImage::open(const string &filename, bool rd_only)
         readonly = rd_only;
         file = filename;
 
-        ios::openmode mode = ios::in | ios::binary;
-        if (!readonly)
-            mode |= ios::out;
-        stream.open(file.c_str(), mode);
-        if (!stream.is_open())
+        fd = ::open(file.c_str(), readonly ? O_RDONLY : O_RDWR);
+        if (fd < 0)
             panic("Error opening %s", filename);
     }
 }
@@ -95,42 +106,48 @@ RawDiskImage::open(const string &filename, bool rd_only)
 void
 RawDiskImage::close()
 {
-    stream.close();
+    readAhead.stop();
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
 }
 
 std::streampos
 RawDiskImage::size() const
 {
     if (disk_size == 0) {
-        if (!stream.is_open())
+        if (fd < 0)
             panic("file not open!\n");
-        stream.seekg(0, ios::end);
-        disk_size = stream.tellg();
+        disk_size = lseek(fd, 0, SEEK_END);
     }
 
     return disk_size / SectorSize;
 }
 
+void
+RawDiskImage::prefetch(std::streampos offset, uint64_t count)
+{
+    readAhead.prefetch(fd, offset * SectorSize, count * SectorSize);
+}
+
 std::streampos
 RawDiskImage::read(uint8_t *data, std::streampos offset) const
 {
     if (!initialized)
         panic("RawDiskImage not initialized");
 
-    if (!stream.is_open())
+    if (fd < 0)
         panic("file not open!\n");
 
-    stream.seekg(offset * SectorSize, ios::beg);
-    if (!stream.good())
-        panic("Could not seek to location in file");
-
-    streampos pos = stream.tellg();
-    stream.read((char *)data, SectorSize);
+    std::streampos bytes = SectorSize;
+    if (!readAhead.read(data, offset * SectorSize, SectorSize))
+        bytes = pread(fd, data, SectorSize, offset * SectorSize);
 
     DPRINTF(DiskImageRead, "read: offset=%d\n", (uint64_t)offset);
     DDUMP(DiskImageRead, data, SectorSize);
 
-    return stream.tellg() - pos;
+    return bytes;
 }
 
 std::streampos
@@ -142,19 +159,15 @@ RawDiskImage::write(const uint8_t *data, std::streampos offset)
     if (readonly)
         panic("Cannot write to a read only disk image");
 
-    if (!stream.is_open())
+    if (fd < 0)
         panic("file not open!\n");
 
-    stream.seekp(offset * SectorSize, ios::beg);
-    if (!stream.good())
-        panic("Could not seek to location in file");
+    readAhead.invalidate(offset * SectorSize, SectorSize);
 
     DPRINTF(DiskImageWrite, "write: offset=%d\n", (uint64_t)offset);
     DDUMP(DiskImageWrite, data, SectorSize);
 
-    streampos pos = stream.tellp();
-    stream.write((const char *)data, SectorSize);
-    return stream.tellp() - pos;
+    return pwrite(fd, data, SectorSize, offset * SectorSize);
 }
 
 RawDiskImage *
@@ -181,16 +194,16 @@ class CowDiskCallback : public Callback
 };
 
 CowDiskImage::CowDiskImage(const Params *p)
-    : DiskImage(p), filename(p->image_file), child(p->child), table(NULL)
+    : DiskImage(p), filename(p->image_file), child(p->child),
+      overlayFd(-1), overlay(NULL), overlayBytes(0), validSectors(0)
 {
-    if (filename.empty()) {
-        initSectorTable(p->table_size);
-    } else {
-        if (!open(filename)) {
-            if (p->read_only)
-                fatal("could not open read-only file");
-            initSectorTable(p->table_size);
-        }
+    // The overlay is mapped when it is first written, once the size of
+    // the child is known
+    initialized = true;
+
+    if (!filename.empty()) {
+        if (!open(filename) && p->read_only)
+            fatal("could not open read-only file");
 
         if (!p->read_only)
             registerExitCallback(new CowDiskCallback(this));
@@ -199,13 +212,10 @@ CowDiskImage::CowDiskImage(const Params *p)
 
 CowDiskImage::~CowDiskImage()
 {
-    SectorTable::iterator i = table->begin();
-    SectorTable::iterator end = table->end();
-
-    while (i != end) {
-        delete (*i).second;
-        ++i;
-    }
+    if (overlay)
+        munmap(overlay, overlayBytes);
+    if (overlayFd >= 0)
+        ::close(overlayFd);
 }
 
 void
@@ -273,18 +283,20 @@ CowDiskImage::open(const string &file)
 
     uint64_t sector_count;
     SafeReadSwap(stream, sector_count);
-    table = new SectorTable(sector_count);
 
+    initOverlay();
 
+    uint8_t data[SectorSize];
     for (uint64_t i = 0; i < sector_count; i++) {
         uint64_t offset;
         SafeReadSwap(stream, offset);
+        SafeRead(stream, data, sizeof(data));
 
-        Sector *sector = new Sector;
-        SafeRead(stream, sector, sizeof(Sector));
-
-        assert(table->find(offset) == table->end());
-        (*table)[offset] = sector;
+        if (offset * SectorSize >= overlayBytes)
+            panic("Could not open %s: sector %d is out of bounds",
+                  file, offset);
+        assert(!isValid(offset));
+        writeSector(data, offset);
     }
 
     stream.close();
@@ -294,11 +306,49 @@ CowDiskImage::open(const string &file)
 }
 
 void
-CowDiskImage::initSectorTable(int hash_size)
+CowDiskImage::initOverlay()
 {
-    table = new SectorTable(hash_size);
+    validSectors = 0;
+    if (overlay) {
+        std::fill(chunkValid.begin(), chunkValid.end(), 0);
+        return;
+    }
 
-    initialized = true;
+    // Cover one sector past the end too, as the bounds checks allow it
+    uint64_t chunks = (uint64_t)child->size() / ChunkSectors + 1;
+    overlayBytes = chunks * ChunkSectors * SectorSize;
+    chunkValid.assign(chunks, 0);
+
+    const char *tmpdir = getenv("TMPDIR");
+    string path = string(tmpdir ? tmpdir : "/tmp") + "/gem5-cow-XXXXXX";
+    overlayFd = mkstemp(&path[0]);
+    if (overlayFd < 0)
+        fatal("Could not create the COW overlay of %s: %s",
+              name(), strerror(errno));
+    unlink(path.c_str());
+
+    if (ftruncate(overlayFd, overlayBytes) != 0)
+        fatal("Could not size the COW overlay of %s: %s",
+              name(), strerror(errno));
+
+    void *m = mmap(NULL, overlayBytes, PROT_READ | PROT_WRITE, MAP_SHARED,
+                   overlayFd, 0);
+    if (m == MAP_FAILED)
+        fatal("Could not map the COW overlay of %s: %s",
+              name(), strerror(errno));
+    overlay = (uint8_t *)m;
+}
+
+void
+CowDiskImage::writeSector(const uint8_t *data, uint64_t sector)
+{
+    uint8_t bit = 1 << (sector % ChunkSectors);
+    uint8_t &valid = chunkValid[sector / ChunkSectors];
+    if (!(valid & bit)) {
+        valid |= bit;
+        validSectors++;
+    }
+    memcpy(sectorData(sector), data, SectorSize);
 }
 
 void
@@ -355,33 +405,42 @@ CowDiskImage::save(const string &file) const
 
     SafeWriteSwap(stream, (uint32_t)VersionMajor);
     SafeWriteSwap(stream, (uint32_t)VersionMinor);
-    SafeWriteSwap(stream, (uint64_t)table->size());
+    SafeWriteSwap(stream, validSectors);
 
-    uint64_t size = table->size();
-    SectorTable::iterator iter = table->begin();
-    SectorTable::iterator end = table->end();
+    uint64_t count = 0;
+    for (uint64_t chunk = 0; chunk < chunkValid.size(); chunk++) {
+        if (!chunkValid[chunk])
+            continue;
 
-    for (uint64_t i = 0; i < size; i++) {
-        if (iter == end)
-            panic("Incorrect Table Size during save of COW disk image");
+        for (unsigned i = 0; i < ChunkSectors; i++) {
+            uint64_t sector = chunk * ChunkSectors + i;
+            if (!isValid(sector))
+                continue;
 
-        SafeWriteSwap(stream, (uint64_t)(*iter).first);
-        SafeWrite(stream, (*iter).second->data, sizeof(Sector));
-        ++iter;
+            SafeWriteSwap(stream, sector);
+            SafeWrite(stream, sectorData(sector), SectorSize);
+            count++;
+        }
     }
 
+    if (count != validSectors)
+        panic("Incorrect Table Size during save of COW disk image");
+
     stream.close();
 }
 
 void
 CowDiskImage::writeback()
 {
-    SectorTable::iterator i = table->begin();
-    SectorTable::iterator end = table->end();
-
-    while (i != end) {
-        child->write((*i).second->data, (*i).first);
-        ++i;
+    for (uint64_t chunk = 0; chunk < chunkValid.size(); chunk++) {
+        if (!chunkValid[chunk])
+            continue;
+
+        for (unsigned i = 0; i < ChunkSectors; i++) {
+            uint64_t sector = chunk * ChunkSectors + i;
+            if (isValid(sector))
+                child->write(sectorData(sector), sector);
+        }
     }
 }
 
@@ -398,17 +457,33 @@ CowDiskImage::read(uint8_t *data, std::streampos offset) const
     if (offset > size())
         panic("access out of bounds");
 
-    SectorTable::const_iterator i = table->find(offset);
-    if (i == table->end())
+    if (!isValid(offset))
         return child->read(data, offset);
     else {
-        memcpy(data, (*i).second->data, SectorSize);
+        memcpy(data, sectorData(offset), SectorSize);
         DPRINTF(DiskImageRead, "read: offset=%d\n", (uint64_t)offset);
         DDUMP(DiskImageRead, data, SectorSize);
         return SectorSize;
     }
 }
 
+void
+CowDiskImage::prefetch(std::streampos offset, uint64_t count)
+{
+    // Only the sectors missing from the overlay come from the child
+    uint64_t sector = offset;
+    uint64_t end = sector + count;
+    while (sector < end) {
+        while (sector < end && isValid(sector))
+            sector++;
+        uint64_t first = sector;
+        while (sector < end && !isValid(sector))
+            sector++;
+        if (sector > first)
+            child->prefetch(first, sector - first);
+    }
+}
+
 std::streampos
 CowDiskImage::write(const uint8_t *data, std::streampos offset)
 {
@@ -418,14 +493,9 @@ CowDiskImage::write(const uint8_t *data, std::streampos offset)
     if (offset > size())
         panic("access out of bounds");
 
-    SectorTable::iterator i = table->find(offset);
-    if (i == table->end()) {
-        Sector *sector = new Sector;
-        memcpy(sector, data, SectorSize);
-        table->insert(make_pair(offset, sector));
-    } else {
-        memcpy((*i).second->data, data, SectorSize);
-    }
+    if (!overlay)
+        initOverlay();
+    writeSector(data, offset);
 
     DPRINTF(DiskImageWrite, "write: offset=%d\n", (uint64_t)offset);
     DDUMP(DiskImageWrite, data, SectorSize);
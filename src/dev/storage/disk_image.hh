@@ -36,8 +36,9 @@
 #define __DEV_STORAGE_DISK_IMAGE_HH__
 
 #include <fstream>
-#include <unordered_map>
+#include <vector>
 
+#include "dev/storage/read_ahead.hh"
 #include "params/CowDiskImage.hh"
 #include "params/DiskImage.hh"
 #include "params/RawDiskImage.hh"
@@ -64,6 +65,15 @@ class DiskImage : public SimObject
                                 std::streampos offset) const = 0;
     virtual std::streampos write(const uint8_t *data,
                                  std::streampos offset) = 0;
+
+    /**
+     * Hint that a range of sectors is about to be read, so that an
+     * image can start fetching them from the host ahead of time.
+     *
+     * @param offset First sector of the range.
+     * @param count Number of sectors in the range.
+     */
+    virtual void prefetch(std::streampos offset, uint64_t count) {}
 };
 
 /**
@@ -72,17 +82,21 @@ class DiskImage : public SimObject
 class RawDiskImage : public DiskImage
 {
   protected:
-    mutable std::fstream stream;
+    int fd;
     std::string file;
     bool readonly;
     mutable std::streampos disk_size;
 
+    /** Sectors read ahead on host threads. */
+    mutable DiskReadAhead readAhead;
+
   public:
     typedef RawDiskImageParams Params;
     RawDiskImage(const Params *p);
     ~RawDiskImage();
 
     void notifyFork() override;
+    DrainState drain() override;
 
     void close();
     void open(const std::string &filename, bool rd_only = false);
@@ -91,6 +105,7 @@ class RawDiskImage : public DiskImage
 
     std::streampos read(uint8_t *data, std::streampos offset) const override;
     std::streampos write(const uint8_t *data, std::streampos offset) override;
+    void prefetch(std::streampos offset, uint64_t count) override;
 };
 
 /**
@@ -110,15 +125,46 @@ class CowDiskImage : public DiskImage
     static const uint32_t VersionMinor;
 
   protected:
-    struct Sector {
-        uint8_t data[SectorSize];
-    };
-    typedef std::unordered_map<uint64_t, Sector *> SectorTable;
+    /**
+     * The overlay is kept in 4 KB chunks. Each chunk records which of
+     * its sectors have been written.
+     */
+    static const unsigned ChunkSectors = 8;
 
-  protected:
     std::string filename;
     DiskImage *child;
-    SectorTable *table;
+
+    /**
+     * The data of the overlay lives in an unlinked sparse file mapped
+     * over the whole disk. Only the chunks that are written take up
+     * space, and the host can page them out.
+     */
+    int overlayFd;
+    uint8_t *overlay;
+    uint64_t overlayBytes;
+
+    /** Per chunk, a bitmask of the sectors held by the overlay. */
+    std::vector<uint8_t> chunkValid;
+    /** Number of sectors held by the overlay. */
+    uint64_t validSectors;
+
+    /** Map the overlay, or empty it if it is mapped already. */
+    void initOverlay();
+
+    bool isValid(uint64_t sector) const
+    {
+        uint64_t chunk = sector / ChunkSectors;
+        return chunk < chunkValid.size() &&
+            (chunkValid[chunk] & (1 << (sector % ChunkSectors)));
+    }
+
+    uint8_t *sectorData(uint64_t sector) const
+    {
+        return overlay + sector * SectorSize;
+    }
+
+    /** Copy a sector into the overlay. */
+    void writeSector(const uint8_t *data, uint64_t sector);
 
   public:
     typedef CowDiskImageParams Params;
@@ -127,7 +173,6 @@ class CowDiskImage : public DiskImage
 
     void notifyFork() override;
 
-    void initSectorTable(int hash_size);
     bool open(const std::string &file);
     void save() const;
     void save(const std::string &file) const;
@@ -140,6 +185,7 @@ class CowDiskImage : public DiskImage
 
     std::streampos read(uint8_t *data, std::streampos offset) const override;
     std::streampos write(const uint8_t *data, std::streampos offset) override;
+    void prefetch(std::streampos offset, uint64_t count) override;
 };
 
 void SafeRead(std::ifstream &stream, void *data, int count);
@@ -679,6 +679,7 @@ IdeDisk::startCommand()
             cmdBytes = cmdBytesLeft = (cmdReg.sec_count * SectorSize);
 
         curSector = getLBABase();
+        image->prefetch(curSector, cmdBytes / SectorSize);
 
         /** @todo make this a scheduled event to simulate disk delay */
         devState = Prepare_Data_In;
@@ -717,6 +718,9 @@ IdeDisk::startCommand()
         DPRINTF(IdeDisk, "Setting cmdBytesLeft to %d in readdma\n", cmdBytesLeft);
 
         curSector = getLBABase();
+        // Have the host read the data while the transfer is simulated
+        if (!dmaRead)
+            image->prefetch(curSector, cmdBytes / SectorSize);
 
         devState = Prepare_Data_Dma;
         action = ACT_DMA_READY;
@@ -0,0 +1,190 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dev/storage/read_ahead.hh"
+
+#include <unistd.h>
+
+#include <cstring>
+
+DiskReadAhead::DiskReadAhead(unsigned threads, unsigned max_chunks)
+    : numThreads(threads), maxChunks(max_chunks), fd(-1), seq(0),
+      stopping(false)
+{
+}
+
+DiskReadAhead::~DiskReadAhead()
+{
+    stop();
+}
+
+void
+DiskReadAhead::stop()
+{
+    if (!threads.empty()) {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            stopping = true;
+        }
+        work.notify_all();
+        for (auto &t : threads)
+            t.join();
+        threads.clear();
+    }
+
+    // The file may change before the threads start again, so nothing
+    // read so far can be trusted anymore
+    std::lock_guard<std::mutex> guard(lock);
+    chunks.clear();
+    order.clear();
+    queue.clear();
+    fd = -1;
+}
+
+void
+DiskReadAhead::ioThread()
+{
+    std::unique_ptr<Chunk> buf(new Chunk);
+    std::unique_lock<std::mutex> guard(lock);
+    while (true) {
+        work.wait(guard, [this]{ return stopping || !queue.empty(); });
+        if (stopping)
+            return;
+
+        uint64_t chunk = queue.front().first;
+        uint64_t chunk_seq = queue.front().second;
+        queue.pop_front();
+
+        guard.unlock();
+        ssize_t bytes = pread(fd, buf->data, ChunkSize, chunk * ChunkSize);
+        guard.lock();
+
+        // The chunk may have been written, and dropped, in the meantime
+        auto it = chunks.find(chunk);
+        if (it == chunks.end() || it->second->seq != chunk_seq)
+            continue;
+
+        buf->seq = chunk_seq;
+        buf->ready = true;
+        buf->bytes = bytes;
+        it->second.swap(buf);
+        done.notify_all();
+    }
+}
+
+void
+DiskReadAhead::prefetch(int file, uint64_t offset, uint64_t size)
+{
+    if (numThreads == 0 || size == 0)
+        return;
+
+    if (threads.empty()) {
+        fd = file;
+        stopping = false;
+        for (unsigned i = 0; i < numThreads; i++)
+            threads.emplace_back([this]{ ioThread(); });
+    }
+
+    uint64_t first = offset / ChunkSize;
+    uint64_t last = (offset + size - 1) / ChunkSize;
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        for (uint64_t chunk = first; chunk <= last; chunk++) {
+            if (chunks.count(chunk))
+                continue;
+
+            // Forget the chunks that were used already, and make room
+            // by dropping the oldest chunks that were read ahead but
+            // never used
+            while (!order.empty()) {
+                auto it = chunks.find(order.front());
+                if (it == chunks.end()) {
+                    order.pop_front();
+                } else if (chunks.size() >= maxChunks &&
+                           it->second->ready) {
+                    chunks.erase(it);
+                    order.pop_front();
+                } else {
+                    break;
+                }
+            }
+            if (chunks.size() >= maxChunks)
+                break;
+
+            std::unique_ptr<Chunk> c(new Chunk);
+            c->seq = ++seq;
+            c->ready = false;
+            chunks[chunk] = std::move(c);
+            order.push_back(chunk);
+            queue.emplace_back(chunk, seq);
+        }
+    }
+    work.notify_all();
+}
+
+bool
+DiskReadAhead::read(uint8_t *data, uint64_t offset, unsigned size)
+{
+    if (threads.empty())
+        return false;
+
+    uint64_t chunk = offset / ChunkSize;
+    std::unique_lock<std::mutex> guard(lock);
+    auto it = chunks.find(chunk);
+    if (it == chunks.end())
+        return false;
+
+    done.wait(guard, [&]{ return it->second->ready; });
+
+    const Chunk &c = *it->second;
+    ssize_t pos = offset % ChunkSize;
+    if (c.bytes < pos + (ssize_t)size) {
+        // Short read, let the synchronous path report it
+        chunks.erase(it);
+        return false;
+    }
+    memcpy(data, c.data + pos, size);
+
+    // The file is mostly read in order, so the chunk is done with once
+    // its end is read
+    if (pos + size == ChunkSize)
+        chunks.erase(it);
+    return true;
+}
+
+void
+DiskReadAhead::invalidate(uint64_t offset, uint64_t size)
+{
+    if (size == 0)
+        return;
+
+    // Drop the chunks even if the threads are stopped, so they can't be
+    // mistaken for valid ones once the threads start again
+    std::lock_guard<std::mutex> guard(lock);
+    uint64_t last = (offset + size - 1) / ChunkSize;
+    for (uint64_t chunk = offset / ChunkSize; chunk <= last; chunk++)
+        chunks.erase(chunk);
+}
@@ -0,0 +1,117 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __DEV_STORAGE_READ_AHEAD_HH__
+#define __DEV_STORAGE_READ_AHEAD_HH__
+
+#include <sys/types.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Reads a file ahead of time, in fixed size chunks, on a small pool of
+ * host threads. Chunks are kept until they are used, invalidated or
+ * evicted to make room for newer ones, and the buffer is emptied when
+ * the threads are stopped, so nothing read before a stop can be served
+ * after it.
+ */
+class DiskReadAhead
+{
+  public:
+    /** Size of the chunks the file is read ahead in. */
+    static const unsigned ChunkSize = 4096;
+
+    /**
+     * @param threads Number of threads reading ahead, 0 to disable.
+     * @param max_chunks Maximum number of chunks held by the buffer.
+     */
+    DiskReadAhead(unsigned threads, unsigned max_chunks);
+    ~DiskReadAhead();
+
+    /**
+     * Start reading a range of a file ahead, starting the threads if
+     * they are not running.
+     */
+    void prefetch(int fd, uint64_t offset, uint64_t size);
+
+    /**
+     * Copy data from the buffer, waiting for it to be read if needed.
+     * The range has to fit in a single chunk.
+     *
+     * @return False if the range is not in the buffer.
+     */
+    bool read(uint8_t *data, uint64_t offset, unsigned size);
+
+    /** Drop the chunks covering a range, e.g. because it was written. */
+    void invalidate(uint64_t offset, uint64_t size);
+
+    /** Stop the threads and drop everything that was read ahead. */
+    void stop();
+
+  private:
+    /** A chunk of the file read ahead by an I/O thread. */
+    struct Chunk {
+        /** Identifies this read, in case the chunk is dropped. */
+        uint64_t seq;
+        bool ready;
+        ssize_t bytes;
+        uint8_t data[ChunkSize];
+    };
+
+    const unsigned numThreads;
+    const unsigned maxChunks;
+
+    /** File the running threads read from. */
+    int fd;
+
+    /** Protects all the state below. */
+    std::mutex lock;
+    /** Signalled when there is a chunk to read. */
+    std::condition_variable work;
+    /** Signalled when a chunk has been read. */
+    std::condition_variable done;
+
+    /** Chunks read ahead or being read, by chunk index. */
+    std::unordered_map<uint64_t, std::unique_ptr<Chunk>> chunks;
+    /** Chunk indices in the order they were requested. */
+    std::deque<uint64_t> order;
+    /** Reads waiting for a thread, as (chunk index, seq). */
+    std::deque<std::pair<uint64_t, uint64_t>> queue;
+    uint64_t seq;
+
+    std::vector<std::thread> threads;
+    bool stopping;
+
+    void ioThread();
+};
+
+#endif // __DEV_STORAGE_READ_AHEAD_HH__
@@ -0,0 +1,160 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include "dev/storage/read_ahead.hh"
+
+namespace {
+
+const unsigned SectorSize = 512;
+
+/** A temporary file filled with a known pattern */
+class DiskReadAheadTest : public testing::Test
+{
+  protected:
+    static const unsigned chunks = 4;
+
+    int fd;
+
+    void
+    SetUp() override
+    {
+        char name[] = "/tmp/read_ahead.test.XXXXXX";
+        fd = mkstemp(name);
+        ASSERT_GE(fd, 0);
+        unlink(name);
+
+        std::vector<uint8_t> data(chunks * DiskReadAhead::ChunkSize);
+        for (unsigned i = 0; i < data.size(); i++)
+            data[i] = i / SectorSize;
+        ASSERT_EQ(data.size(), pwrite(fd, data.data(), data.size(), 0));
+    }
+
+    void TearDown() override { close(fd); }
+
+    /** Overwrite a sector with a value, bypassing the buffer */
+    void
+    writeSector(uint64_t sector, uint8_t value)
+    {
+        std::vector<uint8_t> data(SectorSize, value);
+        ASSERT_EQ(SectorSize,
+                  pwrite(fd, data.data(), SectorSize, sector * SectorSize));
+    }
+
+    /** Check that a sector read from the buffer holds a value */
+    void
+    expectSector(DiskReadAhead &ra, uint64_t sector, uint8_t value)
+    {
+        std::vector<uint8_t> data(SectorSize);
+        ASSERT_TRUE(ra.read(data.data(), sector * SectorSize, SectorSize));
+        for (auto byte : data)
+            ASSERT_EQ(value, byte) << "sector " << sector;
+    }
+};
+
+} // anonymous namespace
+
+TEST_F(DiskReadAheadTest, ReadsAhead)
+{
+    DiskReadAhead ra(2, 16);
+    ra.prefetch(fd, 0, chunks * DiskReadAhead::ChunkSize);
+    for (unsigned s = 0; s < chunks * DiskReadAhead::ChunkSize / SectorSize;
+         s++) {
+        expectSector(ra, s, s);
+    }
+}
+
+TEST_F(DiskReadAheadTest, Disabled)
+{
+    DiskReadAhead ra(0, 16);
+    ra.prefetch(fd, 0, DiskReadAhead::ChunkSize);
+
+    uint8_t data[SectorSize];
+    EXPECT_FALSE(ra.read(data, 0, SectorSize));
+}
+
+TEST_F(DiskReadAheadTest, InvalidateOnWrite)
+{
+    DiskReadAhead ra(1, 16);
+    ra.prefetch(fd, 0, DiskReadAhead::ChunkSize);
+    expectSector(ra, 0, 0);
+
+    writeSector(1, 0xaa);
+    ra.invalidate(1 * SectorSize, SectorSize);
+
+    uint8_t data[SectorSize];
+    EXPECT_FALSE(ra.read(data, 1 * SectorSize, SectorSize));
+
+    ra.prefetch(fd, 0, DiskReadAhead::ChunkSize);
+    expectSector(ra, 1, 0xaa);
+}
+
+TEST_F(DiskReadAheadTest, DrainWriteRead)
+{
+    DiskReadAhead ra(1, 16);
+    ra.prefetch(fd, 0, DiskReadAhead::ChunkSize);
+    expectSector(ra, 0, 0);
+
+    // The threads are stopped when draining, and the image is written
+    // before they start again
+    ra.stop();
+    writeSector(1, 0xaa);
+    ra.invalidate(1 * SectorSize, SectorSize);
+
+    ra.prefetch(fd, 0, DiskReadAhead::ChunkSize);
+    expectSector(ra, 1, 0xaa);
+}
+
+TEST_F(DiskReadAheadTest, StopDropsChunks)
+{
+    DiskReadAhead ra(1, 16);
+    ra.prefetch(fd, 0, DiskReadAhead::ChunkSize);
+    expectSector(ra, 0, 0);
+
+    // Nothing read before stopping is served afterwards, even if the
+    // file changed behind the buffer's back
+    ra.stop();
+    writeSector(1, 0x55);
+
+    ra.prefetch(fd, 0, DiskReadAhead::ChunkSize);
+    expectSector(ra, 1, 0x55);
+}
+
+TEST_F(DiskReadAheadTest, Bounded)
+{
+    DiskReadAhead ra(1, 2);
+    ra.prefetch(fd, 0, chunks * DiskReadAhead::ChunkSize);
+
+    uint8_t data[SectorSize];
+    expectSector(ra, 0, 0);
+    expectSector(ra, DiskReadAhead::ChunkSize / SectorSize, 8);
+    EXPECT_FALSE(ra.read(data, 2 * DiskReadAhead::ChunkSize, SectorSize));
+}
@@ -38,6 +38,7 @@
 
 #include <limits>
 
+#include "base/intmath.hh"
 #include "base/output.hh"
 #include "debug/GPUDisp.hh"
 #include "debug/GPUExec.hh"
@@ -122,6 +123,10 @@ ComputeUnit::ComputeUnit(const Params *p) : MemObject(p), fetchStage(p),
         }
     }
 
+    waveReadyMask.resize(numSIMDs,
+                         std::vector<uint64_t>(divCeil(p->n_wf, 64), 0));
+    numActiveWaves.resize(numSIMDs, 0);
+
     lastVaddrSimd.resize(numSIMDs);
 
     for (int i = 0; i < numSIMDs; ++i) {
@@ -224,6 +229,20 @@ ComputeUnit::updateEvents() {
 }
 
 
+void
+ComputeUnit::wakeWave(const Wavefront *w)
+{
+    waveReadyMask[w->simdId][w->wfSlotId / 64] |=
+        1ULL << (w->wfSlotId % 64);
+}
+
+void
+ComputeUnit::sleepWave(const Wavefront *w)
+{
+    waveReadyMask[w->simdId][w->wfSlotId / 64] &=
+        ~(1ULL << (w->wfSlotId % 64));
+}
+
 void
 ComputeUnit::startWavefront(Wavefront *w, int waveId, LdsChunk *ldsChunk,
                             NDRange *ndr)
@@ -639,7 +658,7 @@ ComputeUnit::DataPort::recvTimingResp(PacketPtr pkt)
                     w->wfDynId, w->kernId);
 
             computeUnit->shader->dispatcher->notifyWgCompl(w);
-            w->status = Wavefront::S_STOPPED;
+            w->setStatus(Wavefront::S_STOPPED);
         } else {
             w->outstandingReqs--;
         }
@@ -1598,6 +1617,11 @@ ComputeUnit::regStats()
         .desc("number of cycles the CU ran for")
         ;
 
+    idleScheduleCycles
+        .name(name() + ".idle_schedule_cycles")
+        .desc("number of cycles no wave had an instruction to schedule")
+        ;
+
     ipc
         .name(name() + ".ipc")
         .desc("Instructions per cycle (this CU only)")
@@ -1779,10 +1803,8 @@ ComputeUnit::isSimdDone(uint32_t simdId) const
         return false;
     }
 
-    for (int i_wf = 0; i_wf < shader->n_wf; ++i_wf){
-        if (wfList[simdId][i_wf]->status != Wavefront::S_STOPPED) {
-            return false;
-        }
+    if (numActiveWaves[simdId]) {
+        return false;
     }
 
     return true;
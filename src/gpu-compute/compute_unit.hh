@@ -118,6 +118,16 @@ class ComputeUnit : public MemObject
     // TODO: convert std::pair to a class to increase readability
     std::vector<std::vector<std::pair<Wavefront*, WAVE_STATUS>>> waveStatusList;
 
+    // Per SIMD bitmap of the waves which may have an instruction to
+    // issue, i.e., those whose instruction buffer is not empty. The
+    // fetch unit sets the bit of a wave when it fills its instruction
+    // buffer and the scoreboardCheck stage clears it when it finds the
+    // buffer empty, so that stage only visits these waves.
+    std::vector<std::vector<uint64_t>> waveReadyMask;
+
+    // Number of waves of each SIMD which are not stopped
+    std::vector<int> numActiveWaves;
+
     // List of waves which will be dispatched to
     // each execution resource. A FILLED implies
     // dispatch list is non-empty and
@@ -130,6 +140,9 @@ class ComputeUnit : public MemObject
     // TODO: convert std::pair to a class to increase readability
     std::vector<std::pair<Wavefront*, DISPATCH_STATUS>> dispatchList;
 
+    void wakeWave(const Wavefront *w);
+    void sleepWave(const Wavefront *w);
+
     int rrNextMemID; // used by RR WF exec policy to cycle through WF's
     int rrNextALUWp;
     typedef ComputeUnitParams Params;
@@ -355,6 +368,7 @@ class ComputeUnit : public MemObject
     Stats::Scalar numVecOpsExecuted;
     // Total cycles that something is running on the GPU
     Stats::Scalar totalCycles;
+    Stats::Scalar idleScheduleCycles;
     Stats::Formula vpc; // vector ops per cycle
     Stats::Formula ipc; // vector instructions per cycle
     Stats::Distribution controlFlowDivergenceDist;
@@ -69,6 +69,11 @@ void
 FetchStage::exec()
 {
     for (int j = 0; j < numSIMDs; ++j) {
+        // nothing can be fetched for a SIMD without running waves
+        if (!computeUnit->numActiveWaves[j] &&
+            fetchUnit[j].fetchQueueEmpty()) {
+            continue;
+        }
         fetchUnit[j].exec();
     }
 }
@@ -302,6 +302,10 @@ FetchUnit::processFetchReturn(PacketPtr pkt)
 
             wavefront->instructionBuffer.push_back(gpuDynInst);
         }
+
+        // the wave may now have an instruction to issue
+        if (!wavefront->instructionBuffer.empty())
+            computeUnit->wakeWave(wavefront);
     }
 
     wavefront->pendingFetch = false;
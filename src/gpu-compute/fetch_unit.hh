@@ -63,6 +63,7 @@ class FetchUnit
     void fetch(PacketPtr pkt, Wavefront *wavefront);
     void processFetchReturn(PacketPtr pkt);
     static uint32_t globalFetchUnitID;
+    bool fetchQueueEmpty() const { return fetchQueue.empty(); }
 
   private:
     bool timingSim;
@@ -122,6 +122,17 @@ ScheduleStage::arbitrate()
 void
 ScheduleStage::exec()
 {
+    // nothing to dispatch or arbitrate when no wave is ready; the exec
+    // stage has already emptied the dispatch list this cycle
+    bool anyReady = false;
+    for (int j = 0; j < numSIMDs + numMemUnits; ++j) {
+        anyReady = anyReady || !computeUnit->readyList[j].empty();
+    }
+    if (!anyReady) {
+        computeUnit->idleScheduleCycles++;
+        return;
+    }
+
     for (int j = 0; j < numSIMDs + numMemUnits; ++j) {
          uint32_t readyListSize = computeUnit->readyList[j].size();
 
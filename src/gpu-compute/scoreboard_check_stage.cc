@@ -37,6 +37,7 @@
 
 #include "gpu-compute/scoreboard_check_stage.hh"
 
+#include "base/bitfield.hh"
 #include "gpu-compute/compute_unit.hh"
 #include "gpu-compute/gpu_static_inst.hh"
 #include "gpu-compute/shader.hh"
@@ -125,6 +126,43 @@ ScoreboardCheckStage::collectStatistics(Wavefront *curWave, int unitId)
     }
 }
 
+void
+ScoreboardCheckStage::checkWave(int unitId, int wvId)
+{
+    // reset the ready status of each wavefront
+    waveStatusList[unitId]->at(wvId).second = BLOCKED;
+    Wavefront *curWave = waveStatusList[unitId]->at(wvId).first;
+
+    // skip the wave until the fetch unit wakes it up again
+    if (curWave->instructionBuffer.empty()) {
+        computeUnit->sleepWave(curWave);
+        return;
+    }
+
+    collectStatistics(curWave, unitId);
+
+    if (curWave->ready(Wavefront::I_ALU)) {
+        readyList[unitId]->push_back(curWave);
+        waveStatusList[unitId]->at(wvId).second = READY;
+    } else if (curWave->ready(Wavefront::I_GLOBAL)) {
+        if (computeUnit->cedeSIMD(unitId, wvId)) {
+            return;
+        }
+
+        readyList[computeUnit->GlbMemUnitId()]->push_back(curWave);
+        waveStatusList[unitId]->at(wvId).second = READY;
+    } else if (curWave->ready(Wavefront::I_SHARED)) {
+        readyList[computeUnit->ShrMemUnitId()]->push_back(curWave);
+        waveStatusList[unitId]->at(wvId).second = READY;
+    } else if (curWave->ready(Wavefront::I_FLAT)) {
+        readyList[computeUnit->GlbMemUnitId()]->push_back(curWave);
+        waveStatusList[unitId]->at(wvId).second = READY;
+    } else if (curWave->ready(Wavefront::I_PRIVATE)) {
+        readyList[computeUnit->GlbMemUnitId()]->push_back(curWave);
+        waveStatusList[unitId]->at(wvId).second = READY;
+    }
+}
+
 void
 ScoreboardCheckStage::exec()
 {
@@ -136,33 +174,16 @@ ScoreboardCheckStage::exec()
         readyList[unitId]->clear();
     }
 
-    // iterate over the Wavefronts of all SIMD units
+    // iterate over the Wavefronts of all SIMD units which may have an
+    // instruction to issue, in slot order. The other waves have an
+    // empty instruction buffer, so they can not be ready, and their
+    // status was reset when they were last visited.
     for (int unitId = 0; unitId < numSIMDs; ++unitId) {
-        for (int wvId = 0; wvId < computeUnit->shader->n_wf; ++wvId) {
-            // reset the ready status of each wavefront
-            waveStatusList[unitId]->at(wvId).second = BLOCKED;
-            Wavefront *curWave = waveStatusList[unitId]->at(wvId).first;
-            collectStatistics(curWave, unitId);
-
-            if (curWave->ready(Wavefront::I_ALU)) {
-                readyList[unitId]->push_back(curWave);
-                waveStatusList[unitId]->at(wvId).second = READY;
-            } else if (curWave->ready(Wavefront::I_GLOBAL)) {
-                if (computeUnit->cedeSIMD(unitId, wvId)) {
-                    continue;
-                }
-
-                readyList[computeUnit->GlbMemUnitId()]->push_back(curWave);
-                waveStatusList[unitId]->at(wvId).second = READY;
-            } else if (curWave->ready(Wavefront::I_SHARED)) {
-                readyList[computeUnit->ShrMemUnitId()]->push_back(curWave);
-                waveStatusList[unitId]->at(wvId).second = READY;
-            } else if (curWave->ready(Wavefront::I_FLAT)) {
-                readyList[computeUnit->GlbMemUnitId()]->push_back(curWave);
-                waveStatusList[unitId]->at(wvId).second = READY;
-            } else if (curWave->ready(Wavefront::I_PRIVATE)) {
-                readyList[computeUnit->GlbMemUnitId()]->push_back(curWave);
-                waveStatusList[unitId]->at(wvId).second = READY;
+        const std::vector<uint64_t> &mask =
+            computeUnit->waveReadyMask[unitId];
+        for (int word = 0; word < mask.size(); ++word) {
+            for (uint64_t bits = mask[word]; bits; bits &= bits - 1) {
+                checkWave(unitId, word * 64 + findLsbSet(bits));
             }
         }
     }
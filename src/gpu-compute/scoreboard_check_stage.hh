@@ -75,6 +75,9 @@ class ScoreboardCheckStage
 
   private:
     void collectStatistics(Wavefront *curWave, int unitId);
+    // Checks whether a wave is ready and adds it to the ready list of
+    // the resource which would execute its oldest instruction
+    void checkWave(int unitId, int wvId);
     void initStatistics();
     ComputeUnit *computeUnit;
     uint32_t numSIMDs;
@@ -158,7 +158,18 @@ Wavefront::start(uint64_t _wf_dyn_id,uint64_t _base_ptr)
 {
     wfDynId = _wf_dyn_id;
     basePtr = _base_ptr;
-    status = S_RUNNING;
+    setStatus(S_RUNNING);
+}
+
+void
+Wavefront::setStatus(status_e new_status)
+{
+    if (status == S_STOPPED && new_status != S_STOPPED) {
+        computeUnit->numActiveWaves[simdId]++;
+    } else if (status != S_STOPPED && new_status == S_STOPPED) {
+        computeUnit->numActiveWaves[simdId]--;
+    }
+    status = new_status;
 }
 
 bool
@@ -158,6 +158,9 @@ class Wavefront : public SimObject
     uint32_t barrierId;
     uint32_t barrierSlots;
     status_e status;
+    // Changes the status, keeping the active wave count of the
+    // CU up to date
+    void setStatus(status_e new_status);
     // HW slot id where the WF is mapped to inside a SIMD unit
     int wfSlotId;
     int kernId;
@@ -71,3 +71,7 @@ from XBar import *
 class HMCController(NoncoherentXBar):
         type = 'HMCController'
         cxx_header = "mem/hmc_controller.hh"
+        # The vaults of the cube, used to break down the scheduling stats,
+        # each one owning a contiguous chunk of the address space
+        num_vaults = Param.Unsigned(16, "Number of vaults in the HMC device")
+        vault_size = Param.MemorySize('256MB', "Storage capacity of a vault")
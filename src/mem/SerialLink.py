@@ -63,3 +63,10 @@ class SerialLink(MemObject):
         "link. (aka. lane width)")
     link_speed = Param.UInt64(1, "Gb/s Speed of each parallel lane inside the"
         "serial link. (aka. lane speed)")
+    # Packets are serialized in whole flits, 16 bytes for HMC
+    flit_size = Param.Unsigned(16, "Size of a flit in bytes")
+    # Packets that start crossing the link within this window are sent from
+    # a single event, and the receiver accounts for their offset into the
+    # window. The default sends one packet per event.
+    batch_window = Param.Latency('0ns', "Window within which ready packets "
+        "are sent together")
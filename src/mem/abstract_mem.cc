@@ -334,6 +334,8 @@ AbstractMemory::access(PacketPtr pkt)
 
     uint8_t *hostAddr = pmemAddr + pkt->getAddr() - range.start();
 
+    notifyWrite(pkt);
+
     if (pkt->cmd == MemCmd::SwapReq) {
         if (pkt->isAtomicOp()) {
             if (pmemAddr) {
@@ -425,6 +427,8 @@ AbstractMemory::functionalAccess(PacketPtr pkt)
 
     uint8_t *hostAddr = pmemAddr + pkt->getAddr() - range.start();
 
+    notifyWrite(pkt);
+
     if (pkt->isRead()) {
         if (pmemAddr) {
             pkt->setData(hostAddr);
@@ -49,6 +49,9 @@
 #ifndef __MEM_ABSTRACT_MEMORY_HH__
 #define __MEM_ABSTRACT_MEMORY_HH__
 
+#include <list>
+#include <vector>
+
 #include "mem/mem_object.hh"
 #include "params/AbstractMemory.hh"
 #include "sim/stats.hh"
@@ -93,6 +96,25 @@ class LockedAddr {
     {}
 };
 
+/**
+ * Interface of the objects that must be told when the contents of a
+ * memory change, e.g. because they handed out pointers into its backing
+ * store. Observers see every write that reaches the memory, whatever the
+ * memory mode, including functional writes.
+ */
+class MemWriteObserver
+{
+  public:
+    virtual ~MemWriteObserver() {}
+
+    /**
+     * Called before a packet modifies the contents of a memory.
+     *
+     * @param pkt Packet performing the write
+     */
+    virtual void memWrite(PacketPtr pkt) = 0;
+};
+
 /**
  * An abstract memory represents a contiguous block of physical
  * memory, with an associated address range, and also provides basic
@@ -181,6 +203,22 @@ class AbstractMemory : public MemObject
      */
     System *_system;
 
+    /** Observers of the writes to this memory */
+    std::vector<MemWriteObserver*> writeObservers;
+
+    /**
+     * Tell the write observers that a packet is about to modify the
+     * memory. Packets that do not write are ignored.
+     */
+    void notifyWrite(PacketPtr pkt)
+    {
+        if (writeObservers.empty() ||
+            !(pkt->isWrite() || pkt->cmd == MemCmd::SwapReq))
+            return;
+
+        for (auto *observer : writeObservers)
+            observer->memWrite(pkt);
+    }
 
   private:
 
@@ -312,6 +350,17 @@ class AbstractMemory : public MemObject
      */
     void functionalAccess(PacketPtr pkt);
 
+    /**
+     * Register an observer that is told about every write to this
+     * memory.
+     *
+     * @param observer The write observer
+     */
+    void addWriteObserver(MemWriteObserver *observer)
+    {
+        writeObservers.push_back(observer);
+    }
+
     /**
      * Register Statistics
      */
@@ -42,6 +42,7 @@
 from m5.params import *
 from m5.proxy import *
 from m5.SimObject import SimObject
+from Compressors import BaseCacheCompressor
 from MemObject import MemObject
 from Prefetcher import BasePrefetcher
 from ReplacementPolicies import *
@@ -107,6 +108,9 @@ class BaseCache(MemObject):
     sequential_access = Param.Bool(False,
         "Whether to access tags and data sequentially")
 
+    compressor = Param.BaseCacheCompressor(NULL, "Cache compressor. "
+        "Requires CompressedTags")
+
     cpu_side = SlavePort("Upstream port closer to the CPU and/or device")
     mem_side = MasterPort("Downstream port closer to memory")
 
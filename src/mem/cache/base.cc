@@ -51,12 +51,16 @@
 #include "base/compiler.hh"
 #include "base/logging.hh"
 #include "debug/Cache.hh"
+#include "debug/CacheComp.hh"
 #include "debug/CachePort.hh"
 #include "debug/CacheRepl.hh"
 #include "debug/CacheVerbose.hh"
+#include "mem/cache/compressors/base.hh"
 #include "mem/cache/mshr.hh"
 #include "mem/cache/prefetch/base.hh"
 #include "mem/cache/queue_entry.hh"
+#include "mem/cache/tags/compressed_tags.hh"
+#include "mem/cache/tags/super_blk.hh"
 #include "params/BaseCache.hh"
 #include "params/WriteAllocator.hh"
 #include "sim/core.hh"
@@ -84,6 +88,7 @@ BaseCache::BaseCache(const BaseCacheParams *p, unsigned blk_size)
       writeBuffer("write buffer", p->write_buffers, p->mshrs), // see below
       tags(p->tags),
       prefetcher(p->prefetcher),
+      compressor(p->compressor),
       writeAllocator(p->write_allocator),
       writebackClean(p->writeback_clean),
       tempBlockWriteback(nullptr),
@@ -119,6 +124,10 @@ BaseCache::BaseCache(const BaseCacheParams *p, unsigned blk_size)
 
     tempBlock = new TempCacheBlk(blkSize);
 
+    // Compressed blocks need a tag store that can co-allocate them
+    fatal_if(compressor && !dynamic_cast<CompressedTags*>(tags),
+             "%s: a compressor requires CompressedTags", name());
+
     tags->tagsInit();
     if (prefetcher)
         prefetcher->setCache(this);
@@ -499,8 +508,16 @@ BaseCache::recvTimingResp(PacketPtr pkt)
         mshr->promoteWritable();
     }
 
+    // Writes serviced by the targets below change the contents of the
+    // block, so it must be recompressed afterwards
+    const bool has_writes = mshr->needsWritable();
+
     serviceMSHRTargets(mshr, pkt, blk);
 
+    if (has_writes) {
+        updateCompressionData(blk, writebacks);
+    }
+
     if (mshr->promoteDeferredTargets()) {
         // avoid later read getting stale data while write miss is
         // outstanding.. see comment in timingAccess()
@@ -577,6 +594,11 @@ BaseCache::recvAtomic(PacketPtr pkt)
 
     if (!satisfied) {
         lat += handleAtomicReqMiss(pkt, blk, writebacks);
+
+        // A write miss modifies the newly filled block
+        if (pkt->isWrite()) {
+            updateCompressionData(blk, writebacks);
+        }
     }
 
     // Note that we don't invoke the prefetcher at all in atomic mode.
@@ -900,6 +922,12 @@ BaseCache::calculateAccessLatency(const CacheBlk* blk,
             lat = std::max(lookup_lat, dataLatency);
         }
 
+        // Compressed blocks must be decompressed before being used
+        if (compressor && (blk != tempBlock)) {
+            lat += static_cast<const CompressionBlk*>(blk)
+                ->getDecompressionLatency();
+        }
+
         // Check if the block to be accessed is available. If not, apply the
         // access latency on top of when the block is ready to be accessed.
         const Tick when_ready = blk->getWhenReady();
@@ -997,6 +1025,8 @@ BaseCache::access(PacketPtr pkt, CacheBlk *&blk, Cycles &lat,
             return true;
         }
 
+        // blocks allocated here are compressed with the packet's data
+        const bool was_present = blk != nullptr;
         if (!blk) {
             // need to do a replacement
             blk = allocateBlock(pkt, writebacks);
@@ -1023,6 +1053,9 @@ BaseCache::access(PacketPtr pkt, CacheBlk *&blk, Cycles &lat,
         // nothing else to do; writeback doesn't expect response
         assert(!pkt->needsResponse());
         pkt->writeDataToBlock(blk->data, blkSize);
+        if (was_present) {
+            updateCompressionData(blk, writebacks);
+        }
         DPRINTF(Cache, "%s new state is %s\n", __func__, blk->print());
         incHitCount(pkt);
         // populate the time when the block will be ready to access.
@@ -1049,6 +1082,8 @@ BaseCache::access(PacketPtr pkt, CacheBlk *&blk, Cycles &lat,
         // of the block as well.
         assert(blkSize == pkt->getSize());
 
+        // blocks allocated here are compressed with the packet's data
+        const bool was_present = blk != nullptr;
         if (!blk) {
             if (pkt->writeThrough()) {
                 // if this is a write through packet, we don't try to
@@ -1079,6 +1114,9 @@ BaseCache::access(PacketPtr pkt, CacheBlk *&blk, Cycles &lat,
         // nothing else to do; writeback doesn't expect response
         assert(!pkt->needsResponse());
         pkt->writeDataToBlock(blk->data, blkSize);
+        if (was_present) {
+            updateCompressionData(blk, writebacks);
+        }
         DPRINTF(Cache, "%s new state is %s\n", __func__, blk->print());
 
         incHitCount(pkt);
@@ -1095,6 +1133,11 @@ BaseCache::access(PacketPtr pkt, CacheBlk *&blk, Cycles &lat,
         satisfyRequest(pkt, blk);
         maintainClusivity(pkt->fromCache(), blk);
 
+        // Write hits modify the block's contents
+        if (pkt->isWrite()) {
+            updateCompressionData(blk, writebacks);
+        }
+
         return true;
     }
 
@@ -1139,6 +1182,7 @@ BaseCache::handleFill(PacketPtr pkt, CacheBlk *blk, PacketList &writebacks,
     assert(addr == pkt->getBlockAddr(blkSize));
     assert(!writeBuffer.findMatch(addr, is_secure));
 
+    bool is_upgrade = false;
     if (!blk) {
         // better have read new data...
         assert(pkt->hasData() || pkt->cmd == MemCmd::InvalidateResp);
@@ -1160,6 +1204,7 @@ BaseCache::handleFill(PacketPtr pkt, CacheBlk *blk, PacketList &writebacks,
         // existing block... probably an upgrade
         // don't clear block status... if block is already dirty we
         // don't want to lose that
+        is_upgrade = true;
     }
 
     // Block is guaranteed to be valid at this point
@@ -1212,6 +1257,12 @@ BaseCache::handleFill(PacketPtr pkt, CacheBlk *blk, PacketList &writebacks,
         assert(pkt->getSize() == blkSize);
 
         pkt->writeDataToBlock(blk->data, blkSize);
+
+        // A newly allocated block was compressed on allocation, but the
+        // data of an existing block was just replaced
+        if (is_upgrade) {
+            updateCompressionData(blk, writebacks);
+        }
     }
     // We pay for fillLatency here.
     blk->setWhenReady(clockEdge(fillLatency) + pkt->payloadDelay);
@@ -1228,9 +1279,24 @@ BaseCache::allocateBlock(const PacketPtr pkt, PacketList &writebacks)
     // Get secure bit
     const bool is_secure = pkt->isSecure();
 
+    // Get the size of the block to be allocated. When a compressor is
+    // used, the packet's data is compressed to find how much space the
+    // block needs. Packets without data are allocated uncompressed.
+    // Compression happens while the fill is written, so its latency is not
+    // added to the critical path.
+    std::size_t blk_size_bits = blkSize*8;
+    Cycles compression_lat = Cycles(0);
+    Cycles decompression_lat = Cycles(0);
+    bool is_compressed = false;
+    if (compressor && pkt->hasData()) {
+        is_compressed = compressor->compress(pkt->getConstPtr<uint64_t>(),
+            compression_lat, decompression_lat, blk_size_bits);
+    }
+
     // Find replacement victim
     std::vector<CacheBlk*> evict_blks;
-    CacheBlk *victim = tags->findVictim(addr, is_secure, evict_blks);
+    CacheBlk *victim = tags->findVictim(addr, is_secure, blk_size_bits,
+                                        evict_blks);
 
     // It is valid to return nullptr if there is no victim
     if (!victim)
@@ -1285,9 +1351,80 @@ BaseCache::allocateBlock(const PacketPtr pkt, PacketList &writebacks)
     tags->insertBlock(addr, is_secure, pkt->req->masterId(),
                       pkt->req->taskId(), victim);
 
+    // Set compression data of the newly allocated block
+    if (compressor) {
+        CompressionBlk* compression_blk = static_cast<CompressionBlk*>(victim);
+        compression_blk->setSizeBits(blk_size_bits);
+        compression_blk->setDecompressionLatency(decompression_lat);
+        if (is_compressed) {
+            compression_blk->setCompressed();
+        } else {
+            compression_blk->setUncompressed();
+        }
+    }
+
     return victim;
 }
 
+void
+BaseCache::updateCompressionData(CacheBlk *blk, PacketList &writebacks)
+{
+    // Nothing to update if the block is not held in the compressed tags
+    if (!compressor || !blk || (blk == tempBlock) || !blk->isValid()) {
+        return;
+    }
+
+    // Recompress the block's new contents
+    std::size_t blk_size_bits = blkSize*8;
+    Cycles compression_lat = Cycles(0);
+    Cycles decompression_lat = Cycles(0);
+    const bool is_compressed = compressor->compress(
+        reinterpret_cast<const uint64_t*>(blk->data), compression_lat,
+        decompression_lat, blk_size_bits);
+
+    CompressionBlk* compression_blk = static_cast<CompressionBlk*>(blk);
+    const SuperBlk* superblock =
+        static_cast<const SuperBlk*>(compression_blk->getSectorBlock());
+
+    // A block that no longer fits in its share of the superblock expanded.
+    // Its co-allocated blocks must then leave the superblock, unless they
+    // are in a transient state, in which case the superblock stays
+    // overcommitted until they are evicted.
+    if (!is_compressed ||
+        !superblock->canCoAllocate(blk_size_bits, compression_blk)) {
+        bool is_expansion = false;
+        for (const auto& sub_blk : superblock->blks) {
+            if (!sub_blk->isValid() || (sub_blk == blk)) {
+                continue;
+            }
+
+            is_expansion = true;
+            if (mshrQueue.findMatch(regenerateBlkAddr(sub_blk),
+                                    sub_blk->isSecure())) {
+                dataExpansionsUnevictable++;
+                continue;
+            }
+
+            DPRINTF(CacheComp, "Data expansion of %#llx evicts %#llx\n",
+                    regenerateBlkAddr(blk), regenerateBlkAddr(sub_blk));
+            evictBlock(sub_blk, writebacks);
+        }
+
+        if (is_expansion) {
+            dataExpansions++;
+        }
+    }
+
+    // Update the block's compression information
+    compression_blk->setSizeBits(blk_size_bits);
+    compression_blk->setDecompressionLatency(decompression_lat);
+    if (is_compressed) {
+        compression_blk->setCompressed();
+    } else {
+        compression_blk->setUncompressed();
+    }
+}
+
 void
 BaseCache::invalidateBlock(CacheBlk *blk)
 {
@@ -2216,6 +2353,19 @@ BaseCache::regStats()
         .name(name() + ".replacements")
         .desc("number of replacements")
         ;
+
+    dataExpansions
+        .name(name() + ".data_expansions")
+        .desc("number of data expansions")
+        .flags(nozero | nonan)
+        ;
+
+    dataExpansionsUnevictable
+        .name(name() + ".data_expansions_unevictable")
+        .desc("number of co-allocated blocks kept on a data expansion "
+              "because of a pending MSHR")
+        .flags(nozero | nonan)
+        ;
 }
 
 void
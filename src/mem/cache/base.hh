@@ -55,6 +55,7 @@
 #include <cassert>
 #include <cstdint>
 #include <string>
+#include <vector>
 
 #include "base/addr_range.hh"
 #include "base/statistics.hh"
@@ -80,6 +81,7 @@
 #include "sim/sim_exit.hh"
 #include "sim/system.hh"
 
+class BaseCacheCompressor;
 class BaseMasterPort;
 class BasePrefetcher;
 class BaseSlavePort;
@@ -325,6 +327,9 @@ class BaseCache : public MemObject
     /** Prefetcher */
     BasePrefetcher *prefetcher;
 
+    /** Compression method being used. */
+    BaseCacheCompressor* compressor;
+
     /** To probe when a cache hit occurs */
     ProbePointArg<PacketPtr> *ppHit;
 
@@ -698,6 +703,21 @@ class BaseCache : public MemObject
      * @return the allocated block
      */
     CacheBlk *allocateBlock(const PacketPtr pkt, PacketList &writebacks);
+
+    /**
+     * When a block is overwritten, its compression information must be
+     * updated, and it may need to be recompressed. If the compression size
+     * changes, the block may either become smaller, in which case there is
+     * no side effect, or bigger (data expansion), in which case the blocks
+     * co-allocated in its superblock must be evicted.
+     *
+     * Does nothing when no compressor is being used, or for the temporary
+     * block.
+     *
+     * @param blk The block to be updated.
+     * @param writebacks List for any writebacks that need to be performed.
+     */
+    void updateCompressionData(CacheBlk *blk, PacketList &writebacks);
     /**
      * Evict a cache block.
      *
@@ -996,6 +1016,15 @@ class BaseCache : public MemObject
     /** Number of replacements of valid blocks. */
     Stats::Scalar replacements;
 
+    /** Number of data expansions. */
+    Stats::Scalar dataExpansions;
+
+    /**
+     * Number of co-allocated blocks that could not be evicted on a data
+     * expansion because they had an outstanding MSHR.
+     */
+    Stats::Scalar dataExpansionsUnevictable;
+
     /**
      * @}
      */
@@ -1136,6 +1165,29 @@ class BaseCache : public MemObject
         return mshrQueue.findMatch(addr, is_secure);
     }
 
+    bool hasBeenPrefetched(Addr addr, bool is_secure) const {
+        CacheBlk *block = tags->findBlock(addr, is_secure);
+        return block && block->wasPrefetched();
+    }
+
+    /**
+     * Check a batch of addresses against the tags and the MSHRs.
+     *
+     * @param addrs The addresses to look for.
+     * @param is_secure True if the target memory space is secure.
+     * @param present Set, for each address, to whether it is either in the
+     *                cache or in the miss queue.
+     */
+    void inCacheOrMissQueue(const std::vector<Addr> &addrs, bool is_secure,
+                            std::vector<bool> &present) const
+    {
+        present.resize(addrs.size());
+        for (size_t i = 0; i < addrs.size(); i++) {
+            present[i] = tags->findBlock(addrs[i], is_secure) ||
+                mshrQueue.findMatch(addrs[i], is_secure);
+        }
+    }
+
     void incMissCount(PacketPtr pkt)
     {
         assert(pkt->req->masterId() < system->maxMasters());
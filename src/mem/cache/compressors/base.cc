@@ -0,0 +1,152 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ * Definition of a basic cache compressor.
+ */
+
+#include "mem/cache/compressors/base.hh"
+
+#include <algorithm>
+#include <string>
+
+#include "base/intmath.hh"
+#include "base/logging.hh"
+#include "debug/CacheComp.hh"
+#include "params/BaseCacheCompressor.hh"
+
+BaseCacheCompressor::CompressionData::CompressionData()
+    : _size(0)
+{
+}
+
+BaseCacheCompressor::CompressionData::~CompressionData()
+{
+}
+
+void
+BaseCacheCompressor::CompressionData::setSizeBits(std::size_t size)
+{
+    _size = size;
+}
+
+std::size_t
+BaseCacheCompressor::CompressionData::getSizeBits() const
+{
+    return _size;
+}
+
+std::size_t
+BaseCacheCompressor::CompressionData::getSize() const
+{
+    return divCeil(_size, 8);
+}
+
+BaseCacheCompressor::BaseCacheCompressor(const Params *p)
+    : SimObject(p), blkSize(p->block_size), sizeThreshold(p->size_threshold),
+      compressionLatency(p->compression_latency),
+      decompressionLatency(p->decompression_latency)
+{
+    fatal_if(blkSize < 8 || !isPowerOf2(blkSize),
+             "Block size must be at least 8 and a power of 2");
+    fatal_if(sizeThreshold > blkSize,
+             "Compression threshold must not exceed the block size");
+}
+
+bool
+BaseCacheCompressor::compress(const uint64_t* data, Cycles& comp_lat,
+                              Cycles& decomp_lat, std::size_t& comp_size_bits)
+{
+    // Apply compression
+    std::unique_ptr<CompressionData> comp_data = compress(data);
+
+    // Get compression size. If compressed size is greater than the size
+    // threshold, the compression is seen as unsuccessful
+    std::size_t comp_size_bits_temp = comp_data->getSizeBits();
+    const bool is_compressed = comp_size_bits_temp <= sizeThreshold * 8;
+    if (!is_compressed) {
+        comp_size_bits_temp = blkSize * 8;
+    }
+
+    // Update stats
+    compressions++;
+    compressionSizeBits += comp_size_bits_temp;
+    compressionSize[ceilLog2(std::max(comp_size_bits_temp,
+                                      std::size_t(1)))]++;
+
+    // The compression latency is always paid, whereas blocks stored in
+    // their uncompressed format do not need to be decompressed
+    comp_lat = compressionLatency;
+    decomp_lat = is_compressed ? decompressionLatency : Cycles(0);
+    comp_size_bits = comp_size_bits_temp;
+
+    DPRINTF(CacheComp, "Compressed cache line from %d to %d bits. " \
+            "Compression latency: %llu, decompression latency: %llu\n",
+            blkSize*8, comp_size_bits, comp_lat, decomp_lat);
+
+    return is_compressed;
+}
+
+void
+BaseCacheCompressor::regStats()
+{
+    SimObject::regStats();
+
+    compressions
+        .name(name() + ".compressions")
+        .desc("Total number of compressions")
+        ;
+
+    compressionSize
+        .init(floorLog2(blkSize*8) + 1)
+        .name(name() + ".compression_size")
+        .desc("Number of blocks that were compressed to this power of " \
+              "two size.")
+        .flags(Stats::nozero)
+        ;
+    for (int i = 0; i <= floorLog2(blkSize*8); ++i) {
+        compressionSize.subname(i, std::to_string(1 << i));
+        compressionSize.subdesc(i, "Number of blocks that compressed to " \
+                                "fit in " + std::to_string(1 << i) + " bits");
+    }
+
+    compressionSizeBits
+        .name(name() + ".compression_size_bits")
+        .desc("Total compressed data size, in bits")
+        ;
+
+    avgCompressionSizeBits
+        .name(name() + ".avg_compression_size_bits")
+        .desc("Average compression size, in bits")
+        ;
+    avgCompressionSizeBits = compressionSizeBits / compressions;
+
+    compressionRatio
+        .name(name() + ".compression_ratio")
+        .desc("Average ratio of the uncompressed to the compressed size")
+        ;
+    compressionRatio = (compressions * Stats::constant(blkSize * 8)) /
+                       compressionSizeBits;
+}
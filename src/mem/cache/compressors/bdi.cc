@@ -0,0 +1,255 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ * Implementation of the BDI cache compressor.
+ */
+
+#include "mem/cache/compressors/bdi.hh"
+
+#include "base/bitfield.hh"
+#include "base/logging.hh"
+#include "debug/CacheComp.hh"
+#include "params/BDI.hh"
+
+namespace
+{
+
+/**
+ * Read the i-th value of the given size from a line.
+ */
+inline uint64_t
+getValue(const uint64_t* line, std::size_t size, std::size_t i)
+{
+    const std::size_t offset = i * size;
+    const uint64_t word = line[offset / 8];
+    return (size == 8) ? word : bits(word >> ((offset % 8) * 8),
+                                     size * 8 - 1, 0);
+}
+
+/**
+ * Write the i-th value of the given size into a line.
+ */
+inline void
+setValue(uint64_t* line, std::size_t size, std::size_t i, uint64_t value)
+{
+    const std::size_t offset = i * size;
+    if (size == 8) {
+        line[offset / 8] = value;
+    } else {
+        const int first = (offset % 8) * 8;
+        replaceBits(line[offset / 8], first + size * 8 - 1, first, value);
+    }
+}
+
+/**
+ * Sign extend a value of the given size, in bytes, to 64 bits.
+ */
+inline int64_t
+signExtend(uint64_t value, std::size_t size)
+{
+    if (size == 8) {
+        return value;
+    }
+    const unsigned shift = 64 - size * 8;
+    return static_cast<int64_t>(value << shift) >> shift;
+}
+
+/**
+ * Check whether a signed value fits in the given number of bytes.
+ */
+inline bool
+fitsIn(int64_t value, std::size_t size)
+{
+    if (size == 8) {
+        return true;
+    }
+    const int64_t limit = int64_t(1) << (size * 8 - 1);
+    return (value >= -limit) && (value < limit);
+}
+
+} // anonymous namespace
+
+BDI::BDI(const Params *p)
+    : BaseCacheCompressor(p), useMoreCompressors(p->use_more_compressors)
+{
+    fatal_if(blkSize < 16, "BDI requires blocks of at least 16 bytes");
+}
+
+std::unique_ptr<BDI::BDICompData>
+BDI::tryBaseDelta(const uint64_t* cache_line, Encoding encoding,
+                  std::size_t base_size, std::size_t delta_size) const
+{
+    const std::size_t num_values = blkSize / base_size;
+    std::unique_ptr<BDICompData> comp_data(
+        new BDICompData(encoding, base_size));
+    comp_data->deltas.reserve(num_values);
+    comp_data->useBase.reserve(num_values);
+
+    bool has_base = false;
+    for (std::size_t i = 0; i < num_values; i++) {
+        const uint64_t value = getValue(cache_line, base_size, i);
+
+        // Try the implicit zero base first
+        const int64_t immediate = signExtend(value, base_size);
+        if (fitsIn(immediate, delta_size)) {
+            comp_data->deltas.push_back(immediate);
+            comp_data->useBase.push_back(false);
+            continue;
+        }
+
+        // The first value that is not an immediate becomes the base
+        if (!has_base) {
+            comp_data->base = value;
+            has_base = true;
+        }
+
+        const int64_t delta = signExtend(value - comp_data->base, base_size);
+        if (!fitsIn(delta, delta_size)) {
+            return nullptr;
+        }
+        comp_data->deltas.push_back(delta);
+        comp_data->useBase.push_back(true);
+    }
+
+    // Header, base, one delta and one base selector bit per value
+    comp_data->setSizeBits(encodingBits + base_size * 8 +
+                           num_values * (delta_size * 8 + 1));
+
+    return comp_data;
+}
+
+std::unique_ptr<BaseCacheCompressor::CompressionData>
+BDI::compress(const uint64_t* cache_line)
+{
+    const std::size_t num_words = blkSize / 8;
+
+    // Check for a line of zeros, or of a single repeated 8-byte value
+    bool all_zero = true;
+    bool all_rep = true;
+    for (std::size_t i = 0; i < num_words; i++) {
+        all_zero &= (cache_line[i] == 0);
+        all_rep &= (cache_line[i] == cache_line[0]);
+    }
+    if (all_zero || all_rep) {
+        std::unique_ptr<BDICompData> comp_data(
+            new BDICompData(all_zero ? ZERO : REP_VALUES, 8));
+        comp_data->base = cache_line[0];
+        comp_data->setSizeBits(encodingBits + (all_zero ? 0 : 64));
+        encodingStats[comp_data->encoding]++;
+        return comp_data;
+    }
+
+    // Evaluate every base-delta encoding and keep the smallest one
+    struct { Encoding encoding; std::size_t base; std::size_t delta; }
+    const base_deltas[] = {
+        {BASE8_1, 8, 1}, {BASE8_2, 8, 2}, {BASE8_4, 8, 4},
+        {BASE4_1, 4, 1}, {BASE4_2, 4, 2}, {BASE2_1, 2, 1},
+    };
+
+    std::unique_ptr<BDICompData> best;
+    for (const auto& bd : base_deltas) {
+        if (!useMoreCompressors &&
+            (bd.encoding == BASE8_2 || bd.encoding == BASE8_4 ||
+             bd.encoding == BASE4_2)) {
+            continue;
+        }
+
+        std::unique_ptr<BDICompData> candidate =
+            tryBaseDelta(cache_line, bd.encoding, bd.base, bd.delta);
+        if (candidate &&
+            (!best || candidate->getSizeBits() < best->getSizeBits())) {
+            best = std::move(candidate);
+        }
+    }
+
+    // Fall back to storing the line as is
+    if (!best) {
+        best.reset(new BDICompData(UNCOMPRESSED, 8));
+        best->raw.assign(cache_line, cache_line + num_words);
+        best->setSizeBits(encodingBits + blkSize * 8);
+    }
+
+    DPRINTF(CacheComp, "BDI: selected encoding %d\n", best->encoding);
+    encodingStats[best->encoding]++;
+
+    return best;
+}
+
+void
+BDI::decompress(const CompressionData* comp_data, uint64_t* cache_line)
+{
+    const BDICompData* bdi_data =
+        static_cast<const BDICompData*>(comp_data);
+    const std::size_t num_words = blkSize / 8;
+
+    switch (bdi_data->encoding) {
+      case ZERO:
+      case REP_VALUES:
+        for (std::size_t i = 0; i < num_words; i++) {
+            cache_line[i] = bdi_data->base;
+        }
+        break;
+      case UNCOMPRESSED:
+        for (std::size_t i = 0; i < num_words; i++) {
+            cache_line[i] = bdi_data->raw[i];
+        }
+        break;
+      default:
+        for (std::size_t i = 0; i < bdi_data->deltas.size(); i++) {
+            const uint64_t base = bdi_data->useBase[i] ? bdi_data->base : 0;
+            setValue(cache_line, bdi_data->baseSize, i,
+                     base + bdi_data->deltas[i]);
+        }
+        break;
+    }
+}
+
+void
+BDI::regStats()
+{
+    BaseCacheCompressor::regStats();
+
+    static const char *encodingNames[NUM_ENCODINGS] = {
+        "Zero", "Repeated_Values", "Base8_1", "Base8_2", "Base8_4",
+        "Base4_1", "Base4_2", "Base2_1", "Uncompressed"
+    };
+
+    encodingStats
+        .init(NUM_ENCODINGS)
+        .name(name() + ".encoding")
+        .desc("Number of times each compression encoding was selected")
+        .flags(Stats::nozero)
+        ;
+    for (unsigned i = 0; i < NUM_ENCODINGS; ++i) {
+        encodingStats.subname(i, encodingNames[i]);
+    }
+}
+
+BDI*
+BDIParams::create()
+{
+    return new BDI(this);
+}
@@ -0,0 +1,147 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ * Definition of "Base-Delta-Immediate Compression: Practical Data
+ * Compression for On-Chip Caches".
+ */
+
+#ifndef __MEM_CACHE_COMPRESSORS_BDI_HH__
+#define __MEM_CACHE_COMPRESSORS_BDI_HH__
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "mem/cache/compressors/base.hh"
+
+struct BDIParams;
+
+/**
+ * Base-Delta-Immediate compressor, as described in Pekhimenko et al.,
+ * "Base-Delta-Immediate Compression: Practical Data Compression for On-Chip
+ * Caches", PACT 2012.
+ *
+ * The line is split into values of a given base size, and each value is
+ * represented either by an immediate delta (an implicit zero base) or by a
+ * delta to a single explicit base, which is the first value that cannot be
+ * represented as an immediate. A one bit mask per value tells the bases
+ * apart. All encodings are evaluated and the smallest one is chosen.
+ */
+class BDI : public BaseCacheCompressor
+{
+  protected:
+    /**
+     * Possible encodings. The value of each encoding is stored in the
+     * compressed data header.
+     */
+    enum Encoding {
+        ZERO, REP_VALUES, BASE8_1, BASE8_2, BASE8_4, BASE4_1, BASE4_2,
+        BASE2_1, UNCOMPRESSED, NUM_ENCODINGS
+    };
+
+    /** Size of the encoding header, in bits. */
+    static const std::size_t encodingBits = 4;
+
+    class BDICompData;
+
+    /**
+     * If set, all combinations of base and delta sizes are tried. Otherwise
+     * only the smallest delta size of each base size is used.
+     */
+    const bool useMoreCompressors;
+
+    /** Number of times each encoding was selected. */
+    Stats::Vector encodingStats;
+
+    /**
+     * Try to apply a base-delta encoding to the line.
+     *
+     * @param cache_line The line to be compressed.
+     * @param encoding The base-delta encoding to be used.
+     * @param base_size Size of the base and of each value, in bytes.
+     * @param delta_size Size of each delta, in bytes.
+     * @return The compressed data, or nullptr if not compressible.
+     */
+    std::unique_ptr<BDICompData> tryBaseDelta(const uint64_t* cache_line,
+        Encoding encoding, std::size_t base_size,
+        std::size_t delta_size) const;
+
+    std::unique_ptr<BaseCacheCompressor::CompressionData> compress(
+        const uint64_t* cache_line) override;
+
+    void decompress(const CompressionData* comp_data,
+                    uint64_t* cache_line) override;
+
+  public:
+    /** Convenience typedef. */
+    typedef BDIParams Params;
+
+    /**
+     * Default constructor.
+     */
+    BDI(const Params *p);
+
+    /**
+     * Default destructor.
+     */
+    ~BDI() {};
+
+    void regStats() override;
+};
+
+/**
+ * Compressed data of the BDI compressor. Holds the chosen encoding, the
+ * explicit base and one delta plus a base selector per value.
+ */
+class BDI::BDICompData : public CompressionData
+{
+  public:
+    /** Encoding used to compress the line. */
+    Encoding encoding;
+
+    /** Size of each uncompressed value, in bytes. */
+    std::size_t baseSize;
+
+    /** Explicit base; REP_VALUES stores the repeated value here. */
+    uint64_t base;
+
+    /** Deltas, one per value, sign-extended to 64 bits. */
+    std::vector<int64_t> deltas;
+
+    /** Whether each value uses the explicit base or the implicit zero. */
+    std::vector<bool> useBase;
+
+    /** Raw line copy, only used by uncompressed lines. */
+    std::vector<uint64_t> raw;
+
+    BDICompData(Encoding encoding, std::size_t base_size)
+        : CompressionData(), encoding(encoding), baseSize(base_size),
+          base(0)
+    {
+    }
+};
+
+#endif //__MEM_CACHE_COMPRESSORS_BDI_HH__
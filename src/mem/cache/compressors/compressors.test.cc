@@ -0,0 +1,179 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "mem/cache/compressors/bdi.hh"
+#include "mem/cache/compressors/cpack.hh"
+#include "mem/cache/compressors/fpc.hh"
+#include "params/BDI.hh"
+#include "params/CPack.hh"
+#include "params/FPC.hh"
+
+namespace {
+
+const unsigned BlkSize = 64;
+const unsigned BlkWords = BlkSize / sizeof(uint64_t);
+
+typedef std::vector<uint64_t> Line;
+
+/** Gives access to the raw compression and decompression of a line */
+template <class Compressor>
+class RoundTrip : public Compressor
+{
+  public:
+    /** The compressors update their stats as they compress */
+    RoundTrip(const typename Compressor::Params *p)
+        : Compressor(p)
+    {
+        this->regStats();
+    }
+
+    /**
+     * Compress a line, then decompress it.
+     *
+     * @param line Line to compress.
+     * @param size_bits Compressed size of the line, in bits.
+     * @return The decompressed line.
+     */
+    Line
+    run(const Line &line, std::size_t &size_bits)
+    {
+        auto comp_data = this->compress(line.data());
+        size_bits = comp_data->getSizeBits();
+
+        Line out(BlkWords, 0xdeadbeefdeadbeefULL);
+        this->decompress(comp_data.get(), out.data());
+        return out;
+    }
+};
+
+template <class Params>
+void
+initParams(Params &p, const std::string &name)
+{
+    p.name = name;
+    p.eventq_index = 0;
+    p.block_size = BlkSize;
+    p.size_threshold = BlkSize;
+    p.compression_latency = Cycles(1);
+    p.decompression_latency = Cycles(1);
+}
+
+/** Lines of every kind the compressors have a special case for */
+std::vector<std::pair<std::string, Line>>
+testLines()
+{
+    std::vector<std::pair<std::string, Line>> lines;
+
+    lines.emplace_back("zero", Line(BlkWords, 0));
+    lines.emplace_back("repeated", Line(BlkWords, 0x0123456789abcdefULL));
+
+    Line narrow(BlkWords);
+    for (unsigned i = 0; i < BlkWords; i++)
+        narrow[i] = 0x7fff000012340000ULL + i * 3;
+    lines.emplace_back("narrow delta", narrow);
+
+    Line small(BlkWords);
+    for (unsigned i = 0; i < BlkWords; i++)
+        small[i] = (i % 2) ? uint64_t(-int64_t(i)) : i;
+    lines.emplace_back("small values", small);
+
+    Line halves(BlkWords);
+    for (unsigned i = 0; i < BlkWords; i++)
+        halves[i] = (uint64_t(0x1234 + i) << 32) | (0xabcd0000 + i);
+    lines.emplace_back("halfword patterns", halves);
+
+    std::mt19937_64 rng(0x5eed);
+    for (unsigned n = 0; n < 16; n++) {
+        Line random(BlkWords);
+        for (auto &word : random)
+            word = rng();
+        lines.emplace_back("random " + std::to_string(n), random);
+    }
+
+    return lines;
+}
+
+template <class Compressor>
+void
+checkRoundTrips(RoundTrip<Compressor> &compressor)
+{
+    for (const auto &test : testLines()) {
+        std::size_t size_bits = 0;
+        EXPECT_EQ(test.second, compressor.run(test.second, size_bits))
+            << test.first;
+        EXPECT_GT(size_bits, 0) << test.first;
+    }
+
+    // Highly compressible lines must actually get smaller
+    std::size_t zero_bits = 0;
+    compressor.run(Line(BlkWords, 0), zero_bits);
+    EXPECT_LT(zero_bits, BlkSize * 8);
+}
+
+} // anonymous namespace
+
+/**
+ * Create a compressor. Stats can't be unregistered, so the compressors
+ * and their parameters are never freed, which keeps a new compressor from
+ * reusing the address of the stats of an old one.
+ */
+template <class Compressor>
+RoundTrip<Compressor> &
+makeCompressor(const typename Compressor::Params *p)
+{
+    return *new RoundTrip<Compressor>(p);
+}
+
+TEST(CompressorTest, BDIRoundTrip)
+{
+    for (bool more : {false, true}) {
+        auto *p = new BDIParams;
+        initParams(*p, more ? "bdi_all" : "bdi");
+        p->use_more_compressors = more;
+        checkRoundTrips(makeCompressor<BDI>(p));
+    }
+}
+
+TEST(CompressorTest, FPCRoundTrip)
+{
+    auto *p = new FPCParams;
+    initParams(*p, "fpc");
+    checkRoundTrips(makeCompressor<FPC>(p));
+}
+
+TEST(CompressorTest, CPackRoundTrip)
+{
+    auto *p = new CPackParams;
+    initParams(*p, "cpack");
+    p->dictionary_size = 16;
+    checkRoundTrips(makeCompressor<CPack>(p));
+}
@@ -0,0 +1,212 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ * Implementation of the CPack cache compressor.
+ */
+
+#include "mem/cache/compressors/cpack.hh"
+
+#include <cassert>
+
+#include "base/bitfield.hh"
+#include "base/intmath.hh"
+#include "base/logging.hh"
+#include "params/CPack.hh"
+
+CPack::CPack(const Params *p)
+    : BaseCacheCompressor(p), dictionarySize(p->dictionary_size),
+      indexBits(ceilLog2(p->dictionary_size)),
+      dictionary(p->dictionary_size, 0), numEntries(0), nextEntry(0)
+{
+    fatal_if(dictionarySize == 0 || dictionarySize > 256,
+             "CPack dictionary must have between 1 and 256 entries");
+}
+
+void
+CPack::resetDictionary()
+{
+    numEntries = 0;
+    nextEntry = 0;
+}
+
+void
+CPack::addToDictionary(uint32_t word)
+{
+    dictionary[nextEntry] = word;
+    nextEntry = (nextEntry + 1) % dictionarySize;
+    if (numEntries < dictionarySize) {
+        numEntries++;
+    }
+}
+
+CPack::Pattern
+CPack::matchDictionary(uint32_t word, std::size_t& index) const
+{
+    Pattern best = XXXX;
+    for (std::size_t i = 0; i < numEntries; i++) {
+        const uint32_t entry = dictionary[i];
+        if (entry == word) {
+            index = i;
+            return MMMM;
+        } else if (bits(entry, 31, 8) == bits(word, 31, 8)) {
+            index = i;
+            best = MMMX;
+        } else if (best == XXXX && bits(entry, 31, 16) == bits(word, 31, 16)) {
+            index = i;
+            best = MMXX;
+        }
+    }
+    return best;
+}
+
+std::size_t
+CPack::patternBits(Pattern pattern) const
+{
+    switch (pattern) {
+      case ZZZZ: return 2;
+      case XXXX: return 2 + 32;
+      case MMMM: return 2 + indexBits;
+      case MMXX: return 4 + indexBits + 16;
+      case ZZZX: return 4 + 8;
+      case MMMX: return 4 + indexBits + 8;
+      default: panic("Invalid CPack pattern %d", pattern);
+    }
+}
+
+std::unique_ptr<BaseCacheCompressor::CompressionData>
+CPack::compress(const uint64_t* cache_line)
+{
+    std::unique_ptr<CPackCompData> comp_data(new CPackCompData());
+    const std::size_t num_words = blkSize / 4;
+    std::size_t size_bits = 0;
+
+    // The dictionary only lives for the duration of a line
+    resetDictionary();
+    comp_data->entries.reserve(num_words);
+
+    for (std::size_t i = 0; i < num_words; i++) {
+        const uint32_t word = bits(cache_line[i / 2], 32 * (i % 2) + 31,
+                                   32 * (i % 2));
+
+        CPackCompData::Entry entry = {XXXX, 0, word};
+        if (word == 0) {
+            entry.pattern = ZZZZ;
+        } else if (bits(word, 31, 8) == 0) {
+            entry.pattern = ZZZX;
+            entry.data = bits(word, 7, 0);
+        } else {
+            std::size_t index = 0;
+            entry.pattern = matchDictionary(word, index);
+            entry.index = index;
+            if (entry.pattern == MMXX) {
+                entry.data = bits(word, 15, 0);
+            } else if (entry.pattern == MMMX) {
+                entry.data = bits(word, 7, 0);
+            }
+
+            if (entry.pattern != MMMM) {
+                addToDictionary(word);
+            }
+        }
+
+        comp_data->entries.push_back(entry);
+        size_bits += patternBits(entry.pattern);
+        patternStats[entry.pattern]++;
+    }
+
+    comp_data->setSizeBits(size_bits);
+
+    return comp_data;
+}
+
+void
+CPack::decompress(const CompressionData* comp_data, uint64_t* cache_line)
+{
+    const CPackCompData* cpack_data =
+        static_cast<const CPackCompData*>(comp_data);
+
+    // Rebuild the dictionary as the words are decompressed
+    resetDictionary();
+
+    std::size_t i = 0;
+    for (const auto& entry : cpack_data->entries) {
+        uint32_t word;
+        switch (entry.pattern) {
+          case ZZZZ:
+            word = 0;
+            break;
+          case ZZZX:
+            word = entry.data;
+            break;
+          case MMMM:
+            word = dictionary[entry.index];
+            break;
+          case MMXX:
+            word = (bits(dictionary[entry.index], 31, 16) << 16) | entry.data;
+            addToDictionary(word);
+            break;
+          case MMMX:
+            word = (bits(dictionary[entry.index], 31, 8) << 8) | entry.data;
+            addToDictionary(word);
+            break;
+          default:
+            word = entry.data;
+            addToDictionary(word);
+            break;
+        }
+
+        replaceBits(cache_line[i / 2], 32 * (i % 2) + 31, 32 * (i % 2), word);
+        i++;
+    }
+
+    assert(i == blkSize / 4);
+}
+
+void
+CPack::regStats()
+{
+    BaseCacheCompressor::regStats();
+
+    static const char *patternNames[NUM_PATTERNS] = {
+        "ZZZZ", "XXXX", "MMMM", "MMXX", "ZZZX", "MMMX"
+    };
+
+    patternStats
+        .init(NUM_PATTERNS)
+        .name(name() + ".pattern")
+        .desc("Number of words encoded with each pattern")
+        .flags(Stats::nozero)
+        ;
+    for (unsigned i = 0; i < NUM_PATTERNS; ++i) {
+        patternStats.subname(i, patternNames[i]);
+    }
+}
+
+CPack*
+CPackParams::create()
+{
+    return new CPack(this);
+}
@@ -0,0 +1,157 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ * Definition of CPack compression, from "C-Pack: A High-Performance
+ * Microprocessor Cache Compression Algorithm".
+ */
+
+#ifndef __MEM_CACHE_COMPRESSORS_CPACK_HH__
+#define __MEM_CACHE_COMPRESSORS_CPACK_HH__
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "mem/cache/compressors/base.hh"
+
+struct CPackParams;
+
+/**
+ * C-Pack compressor, as described in Chen et al., "C-Pack: A
+ * High-Performance Microprocessor Cache Compression Algorithm", IEEE
+ * Transactions on VLSI Systems, 2010.
+ *
+ * Each 32-bit word is matched against zero patterns and against a small
+ * FIFO dictionary of recently seen words. Words that do not fully match
+ * a dictionary entry are pushed into it, so the decompressor can rebuild
+ * the same dictionary while it walks the compressed line.
+ */
+class CPack : public BaseCacheCompressor
+{
+  protected:
+    /**
+     * The patterns. The letters stand, from the most to the least
+     * significant byte, for a zero byte (z), a byte matching a dictionary
+     * entry (m), and an unmatched byte (x).
+     */
+    enum Pattern {
+        ZZZZ, XXXX, MMMM, MMXX, ZZZX, MMMX, NUM_PATTERNS
+    };
+
+    class CPackCompData;
+
+    /** Number of dictionary entries. */
+    const std::size_t dictionarySize;
+
+    /** Number of bits needed to index the dictionary. */
+    const std::size_t indexBits;
+
+    /** Dictionary. Used as a FIFO of the last unmatched words. */
+    std::vector<uint32_t> dictionary;
+
+    /** Number of valid dictionary entries. */
+    std::size_t numEntries;
+
+    /** Next dictionary entry to be replaced. */
+    std::size_t nextEntry;
+
+    /** Number of words encoded with each pattern. */
+    Stats::Vector patternStats;
+
+    /**
+     * Clear the dictionary contents.
+     */
+    void resetDictionary();
+
+    /**
+     * Push a word into the dictionary, replacing the oldest entry.
+     *
+     * @param word The word to be added.
+     */
+    void addToDictionary(uint32_t word);
+
+    /**
+     * Find the best dictionary match of a word.
+     *
+     * @param word The word to be matched.
+     * @param index Index of the matching entry.
+     * @return The pattern of the best match.
+     */
+    Pattern matchDictionary(uint32_t word, std::size_t& index) const;
+
+    /**
+     * Get the encoded size of a pattern, in bits.
+     *
+     * @param pattern The pattern.
+     * @return Number of bits, including the code.
+     */
+    std::size_t patternBits(Pattern pattern) const;
+
+    std::unique_ptr<BaseCacheCompressor::CompressionData> compress(
+        const uint64_t* cache_line) override;
+
+    void decompress(const CompressionData* comp_data,
+                    uint64_t* cache_line) override;
+
+  public:
+    /** Convenience typedef. */
+    typedef CPackParams Params;
+
+    /**
+     * Default constructor.
+     */
+    CPack(const Params *p);
+
+    /**
+     * Default destructor.
+     */
+    ~CPack() {};
+
+    void regStats() override;
+};
+
+/**
+ * Compressed data of the CPack compressor. Each entry holds the pattern
+ * of a word, the dictionary index it matched, and its unmatched bytes.
+ */
+class CPack::CPackCompData : public CompressionData
+{
+  public:
+    struct Entry
+    {
+        Pattern pattern;
+
+        /** Index of the matched dictionary entry. */
+        uint8_t index;
+
+        /** Unmatched bytes of the word. */
+        uint32_t data;
+    };
+
+    std::vector<Entry> entries;
+};
+
+#endif //__MEM_CACHE_COMPRESSORS_CPACK_HH__
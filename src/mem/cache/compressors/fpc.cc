@@ -0,0 +1,207 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ * Implementation of the FPC cache compressor.
+ */
+
+#include "mem/cache/compressors/fpc.hh"
+
+#include <cassert>
+
+#include "base/bitfield.hh"
+#include "base/logging.hh"
+#include "params/FPC.hh"
+
+FPC::FPC(const Params *p)
+    : BaseCacheCompressor(p)
+{
+}
+
+FPC::Pattern
+FPC::matchPattern(uint32_t word)
+{
+    const int32_t value = word;
+    if (value == 0) {
+        return ZERO_RUN;
+    } else if (value >= -8 && value < 8) {
+        return SIGN_EXTENDED_4_BITS;
+    } else if (value >= -128 && value < 128) {
+        return SIGN_EXTENDED_1_BYTE;
+    } else if (value >= -32768 && value < 32768) {
+        return SIGN_EXTENDED_HALFWORD;
+    } else if (bits(word, 15, 0) == 0) {
+        return ZERO_PADDED_HALFWORD;
+    }
+
+    const int16_t upper = bits(word, 31, 16);
+    const int16_t lower = bits(word, 15, 0);
+    if (upper >= -128 && upper < 128 && lower >= -128 && lower < 128) {
+        return SIGN_EXTENDED_TWO_HALFWORDS;
+    }
+
+    const uint32_t byte = bits(word, 7, 0);
+    if (word == (byte * 0x01010101)) {
+        return REP_BYTES;
+    }
+
+    return UNCOMPRESSED;
+}
+
+std::size_t
+FPC::patternBits(Pattern pattern)
+{
+    switch (pattern) {
+      case ZERO_RUN: return 3;
+      case SIGN_EXTENDED_4_BITS: return 4;
+      case SIGN_EXTENDED_1_BYTE: return 8;
+      case SIGN_EXTENDED_HALFWORD: return 16;
+      case ZERO_PADDED_HALFWORD: return 16;
+      case SIGN_EXTENDED_TWO_HALFWORDS: return 16;
+      case REP_BYTES: return 8;
+      case UNCOMPRESSED: return 32;
+      default: panic("Invalid FPC pattern %d", pattern);
+    }
+}
+
+std::unique_ptr<BaseCacheCompressor::CompressionData>
+FPC::compress(const uint64_t* cache_line)
+{
+    std::unique_ptr<FPCCompData> comp_data(new FPCCompData());
+    const std::size_t num_words = blkSize / 4;
+    std::size_t size_bits = 0;
+
+    for (std::size_t i = 0; i < num_words; i++) {
+        const uint32_t word = bits(cache_line[i / 2], 32 * (i % 2) + 31,
+                                   32 * (i % 2));
+        const Pattern pattern = matchPattern(word);
+
+        // Merge zero words into the current run while it is not full
+        if (pattern == ZERO_RUN && !comp_data->entries.empty()) {
+            FPCCompData::Entry& last = comp_data->entries.back();
+            if (last.pattern == ZERO_RUN && last.data < maxZeroRun) {
+                last.data++;
+                patternStats[ZERO_RUN]++;
+                continue;
+            }
+        }
+
+        uint32_t data;
+        switch (pattern) {
+          case ZERO_RUN: data = 1; break;
+          case SIGN_EXTENDED_4_BITS: data = bits(word, 3, 0); break;
+          case SIGN_EXTENDED_1_BYTE: data = bits(word, 7, 0); break;
+          case SIGN_EXTENDED_HALFWORD: data = bits(word, 15, 0); break;
+          case ZERO_PADDED_HALFWORD: data = bits(word, 31, 16); break;
+          case SIGN_EXTENDED_TWO_HALFWORDS:
+            data = (bits(word, 23, 16) << 8) | bits(word, 7, 0);
+            break;
+          case REP_BYTES: data = bits(word, 7, 0); break;
+          default: data = word; break;
+        }
+
+        comp_data->entries.push_back({pattern, data});
+        size_bits += prefixBits + patternBits(pattern);
+        patternStats[pattern]++;
+    }
+
+    comp_data->setSizeBits(size_bits);
+
+    return comp_data;
+}
+
+void
+FPC::decompress(const CompressionData* comp_data, uint64_t* cache_line)
+{
+    const FPCCompData* fpc_data = static_cast<const FPCCompData*>(comp_data);
+
+    std::size_t i = 0;
+    auto set_word = [&](uint32_t word) {
+        replaceBits(cache_line[i / 2], 32 * (i % 2) + 31, 32 * (i % 2), word);
+        i++;
+    };
+
+    for (const auto& entry : fpc_data->entries) {
+        switch (entry.pattern) {
+          case ZERO_RUN:
+            for (uint32_t j = 0; j < entry.data; j++) {
+                set_word(0);
+            }
+            break;
+          case SIGN_EXTENDED_4_BITS:
+            set_word(sext<4>(entry.data));
+            break;
+          case SIGN_EXTENDED_1_BYTE:
+            set_word(sext<8>(entry.data));
+            break;
+          case SIGN_EXTENDED_HALFWORD:
+            set_word(sext<16>(entry.data));
+            break;
+          case ZERO_PADDED_HALFWORD:
+            set_word(entry.data << 16);
+            break;
+          case SIGN_EXTENDED_TWO_HALFWORDS:
+            set_word((bits(sext<8>(bits(entry.data, 15, 8)), 15, 0) << 16) |
+                     bits(sext<8>(bits(entry.data, 7, 0)), 15, 0));
+            break;
+          case REP_BYTES:
+            set_word(entry.data * 0x01010101);
+            break;
+          default:
+            set_word(entry.data);
+            break;
+        }
+    }
+
+    assert(i == blkSize / 4);
+}
+
+void
+FPC::regStats()
+{
+    BaseCacheCompressor::regStats();
+
+    static const char *patternNames[NUM_PATTERNS] = {
+        "ZeroRun", "SignExtended4Bits", "SignExtended1Byte",
+        "SignExtendedHalfword", "ZeroPaddedHalfword",
+        "SignExtendedTwoHalfwords", "RepBytes", "Uncompressed"
+    };
+
+    patternStats
+        .init(NUM_PATTERNS)
+        .name(name() + ".pattern")
+        .desc("Number of words encoded with each pattern")
+        .flags(Stats::nozero)
+        ;
+    for (unsigned i = 0; i < NUM_PATTERNS; ++i) {
+        patternStats.subname(i, patternNames[i]);
+    }
+}
+
+FPC*
+FPCParams::create()
+{
+    return new FPC(this);
+}
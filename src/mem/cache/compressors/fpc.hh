@@ -0,0 +1,131 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ * Definition of "Frequent Pattern Compression: A Significance-Based
+ * Compression Scheme for L2 Caches".
+ */
+
+#ifndef __MEM_CACHE_COMPRESSORS_FPC_HH__
+#define __MEM_CACHE_COMPRESSORS_FPC_HH__
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "mem/cache/compressors/base.hh"
+
+struct FPCParams;
+
+/**
+ * Frequent Pattern Compression, as described in Alameldeen and Wood,
+ * "Frequent Pattern Compression: A Significance-Based Compression Scheme
+ * for L2 Caches", Technical Report 1500, University of Wisconsin, 2004.
+ *
+ * The line is processed as a sequence of 32-bit words. Each word is
+ * encoded with a three bit prefix followed by the bits needed by the
+ * pattern it matches. Runs of up to eight zero words share one prefix.
+ */
+class FPC : public BaseCacheCompressor
+{
+  protected:
+    /**
+     * The patterns, in the order of their prefixes.
+     */
+    enum Pattern {
+        ZERO_RUN, SIGN_EXTENDED_4_BITS, SIGN_EXTENDED_1_BYTE,
+        SIGN_EXTENDED_HALFWORD, ZERO_PADDED_HALFWORD,
+        SIGN_EXTENDED_TWO_HALFWORDS, REP_BYTES, UNCOMPRESSED, NUM_PATTERNS
+    };
+
+    /** Size of the prefix of each pattern, in bits. */
+    static const std::size_t prefixBits = 3;
+
+    /** Maximum number of zero words in a single zero run. */
+    static const std::size_t maxZeroRun = 8;
+
+    class FPCCompData;
+
+    /** Number of words encoded with each pattern. */
+    Stats::Vector patternStats;
+
+    /**
+     * Find the cheapest pattern that matches a word.
+     *
+     * @param word The word to be matched.
+     * @return The matching pattern.
+     */
+    static Pattern matchPattern(uint32_t word);
+
+    /**
+     * Get the number of data bits, excluding the prefix, of a pattern.
+     *
+     * @param pattern The pattern.
+     * @return Number of bits.
+     */
+    static std::size_t patternBits(Pattern pattern);
+
+    std::unique_ptr<BaseCacheCompressor::CompressionData> compress(
+        const uint64_t* cache_line) override;
+
+    void decompress(const CompressionData* comp_data,
+                    uint64_t* cache_line) override;
+
+  public:
+    /** Convenience typedef. */
+    typedef FPCParams Params;
+
+    /**
+     * Default constructor.
+     */
+    FPC(const Params *p);
+
+    /**
+     * Default destructor.
+     */
+    ~FPC() {};
+
+    void regStats() override;
+};
+
+/**
+ * Compressed data of the FPC compressor. Each entry holds a pattern and
+ * the data needed to rebuild its word, or the length of a zero run.
+ */
+class FPC::FPCCompData : public CompressionData
+{
+  public:
+    struct Entry
+    {
+        Pattern pattern;
+
+        /** Encoded bits, or the length of the run for zero runs. */
+        uint32_t data;
+    };
+
+    std::vector<Entry> entries;
+};
+
+#endif //__MEM_CACHE_COMPRESSORS_FPC_HH__
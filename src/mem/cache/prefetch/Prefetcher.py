@@ -141,6 +141,27 @@ class TaggedPrefetcher(QueuedPrefetcher):
 
     degree = Param.Int(2, "Number of prefetches to generate")
 
+class ArrayLabelPrefetcher(QueuedPrefetcher):
+    type = 'ArrayLabelPrefetcher'
+    cxx_class = 'ArrayLabelPrefetcher'
+    cxx_header = "mem/cache/prefetch/array_label.hh"
+
+    # Accelerators label their arrays with virtual address ranges
+    use_virtual_addresses = True
+    # Hits to prefetched blocks are needed to measure the usefulness
+    prefetch_on_access = True
+    on_inst = False
+
+    max_conf = Param.Int(7, "Maximum confidence level")
+    thresh_conf = Param.Int(4, "Threshold confidence level")
+    min_conf = Param.Int(0, "Minimum confidence level")
+    start_conf = Param.Int(4, "Starting confidence for new arrays")
+
+    degree = Param.Int(4, "Number of prefetches to generate")
+
+    max_tracked_arrays = Param.Unsigned(16,
+        "Number of arrays with their own statistics")
+
 class SignaturePathPrefetcher(QueuedPrefetcher):
     type = 'SignaturePathPrefetcher'
     cxx_class = 'SignaturePathPrefetcher'
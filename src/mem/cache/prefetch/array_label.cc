@@ -0,0 +1,266 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Array-aware stream prefetcher definitions.
+ */
+
+#include "mem/cache/prefetch/array_label.hh"
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "base/logging.hh"
+#include "base/trace.hh"
+#include "debug/HWPrefetch.hh"
+#include "params/ArrayLabelPrefetcher.hh"
+
+ArrayLabelPrefetcher::ArrayLabelPrefetcher(
+    const ArrayLabelPrefetcherParams *p)
+    : QueuedPrefetcher(p), system(p->sys), maxConf(p->max_conf),
+      threshConf(p->thresh_conf), minConf(p->min_conf),
+      startConf(p->start_conf), degree(p->degree),
+      maxTrackedArrays(p->max_tracked_arrays)
+{
+    fatal_if(!useVirtualAddresses, "%s: array labels map virtual "
+             "addresses, so use_virtual_addresses must be set.", name());
+    fatal_if(maxTrackedArrays == 0, "%s: at least one array must be "
+             "tracked.", name());
+}
+
+unsigned
+ArrayLabelPrefetcher::getStatsIndex(const std::string &label)
+{
+    auto it = statsIndices.find(label);
+    if (it != statsIndices.end()) {
+        return it->second;
+    }
+
+    // Arrays past the tracked ones are accounted together in the last
+    // entry
+    if (statsIndices.size() == maxTrackedArrays) {
+        return maxTrackedArrays;
+    }
+
+    // Labels are only known once the accelerators run, after the stats
+    // are registered. The entries keep their fixed names, so report which
+    // array each of them accounts for instead
+    const unsigned idx = statsIndices.size();
+    statsIndices.emplace(label, idx);
+    inform("%s: array %s is accounted in stats entry array%d\n", name(),
+           label, idx);
+    return idx;
+}
+
+ArrayLabelPrefetcher::ArrayStream &
+ArrayLabelPrefetcher::getStream(const System::ArrayLabelRegion &region)
+{
+    auto it = streams.find(region.base);
+    if (it != streams.end() && it->second.size == region.size) {
+        return it->second;
+    }
+
+    // First access to the array: assume it is walked forward, one block
+    // at a time, until proven otherwise
+    ArrayStream &stream = streams[region.base];
+    stream.size = region.size;
+    stream.lastBlkAddr = MaxAddr;
+    stream.stride = blkSize;
+    stream.confidence = startConf;
+    stream.statsIdx = getStatsIndex(region.label);
+    return stream;
+}
+
+void
+ArrayLabelPrefetcher::notify(const PacketPtr &pkt, const PrefetchInfo &pfi)
+{
+    const System::ArrayLabelRegion *region =
+        system->findArrayLabelRegion(pfi.getAddr());
+    if (region) {
+        // The cache clears the prefetched flag of a block after notifying
+        // its first demand hit, so each prefetch is counted as used once.
+        // Misses are told apart by the probe that fired, as the cache
+        // has already allocated an MSHR for them by then
+        const unsigned idx = getStream(*region).statsIdx;
+        if (pfi.isCacheMiss()) {
+            pfArrayDemandMisses[idx]++;
+        } else if (hasBeenPrefetched(pkt->getAddr(), pkt->isSecure())) {
+            pfArrayUseful[idx]++;
+        }
+    }
+
+    QueuedPrefetcher::notify(pkt, pfi);
+}
+
+void
+ArrayLabelPrefetcher::calculatePrefetch(const PrefetchInfo &pfi,
+    std::vector<AddrPriority> &addresses)
+{
+    const System::ArrayLabelRegion *region =
+        system->findArrayLabelRegion(pfi.getAddr());
+    if (!region) {
+        DPRINTF(HWPrefetch, "Ignoring access %#x out of labelled arrays.\n",
+                pfi.getAddr());
+        return;
+    }
+
+    ArrayStream &stream = getStream(*region);
+    const Addr blk_addr = blockAddress(pfi.getAddr());
+
+    if (stream.lastBlkAddr != MaxAddr) {
+        // Further accesses to the same block do not tell anything new
+        if (blk_addr == stream.lastBlkAddr) {
+            return;
+        }
+
+        const int64_t new_stride = blk_addr - stream.lastBlkAddr;
+        const bool stride_match = (new_stride == stream.stride);
+
+        if (stride_match) {
+            if (stream.confidence < maxConf)
+                stream.confidence++;
+        } else {
+            if (stream.confidence > minConf)
+                stream.confidence--;
+            // If confidence has dropped below the threshold, train new stride
+            if (stream.confidence < threshConf)
+                stream.stride = new_stride;
+        }
+
+        DPRINTF(HWPrefetch, "Array %s: addr %#x stride %d (%s), conf %d\n",
+                region->label, pfi.getAddr(), new_stride,
+                stride_match ? "match" : "change", stream.confidence);
+    }
+    stream.lastBlkAddr = blk_addr;
+
+    // Abort prefetch generation if below confidence threshold
+    if (stream.confidence < threshConf)
+        return;
+
+    // Round strides up to at least one block
+    int64_t prefetch_stride = stream.stride;
+    if (std::abs(prefetch_stride) < blkSize) {
+        prefetch_stride = (prefetch_stride < 0) ? -(int64_t)blkSize :
+                                                  blkSize;
+    }
+
+    // Run ahead, stopping at the first block that holds no byte of the
+    // array
+    const Addr array_end = region->base + region->size;
+    for (int d = 1; d <= degree; d++) {
+        Addr new_addr = blockAddress(blk_addr + d * prefetch_stride);
+        if (new_addr + blkSize <= region->base || new_addr >= array_end) {
+            pfArrayClipped[stream.statsIdx] += degree - d + 1;
+            DPRINTF(HWPrefetch, "Array %s: stopping at its end, %#x.\n",
+                    region->label, new_addr);
+            break;
+        }
+        addresses.push_back(AddrPriority(new_addr, 0));
+    }
+}
+
+PacketPtr
+ArrayLabelPrefetcher::getPacket()
+{
+    if (!pfq.empty()) {
+        const System::ArrayLabelRegion *region =
+            system->findArrayLabelRegion(pfq.begin()->pfInfo.getAddr());
+        if (region) {
+            pfArrayIssued[getStream(*region).statsIdx]++;
+        }
+    }
+
+    return QueuedPrefetcher::getPacket();
+}
+
+void
+ArrayLabelPrefetcher::regStats()
+{
+    QueuedPrefetcher::regStats();
+
+    using namespace Stats;
+
+    pfArrayIssued
+        .init(maxTrackedArrays + 1)
+        .name(name() + ".pfArrayIssued")
+        .desc("number of prefetches issued per array")
+        .flags(total | nozero)
+        ;
+
+    pfArrayUseful
+        .init(maxTrackedArrays + 1)
+        .name(name() + ".pfArrayUseful")
+        .desc("number of demand hits to prefetched blocks per array")
+        .flags(total | nozero)
+        ;
+
+    pfArrayDemandMisses
+        .init(maxTrackedArrays + 1)
+        .name(name() + ".pfArrayDemandMisses")
+        .desc("number of demand misses per array")
+        .flags(total | nozero)
+        ;
+
+    pfArrayClipped
+        .init(maxTrackedArrays + 1)
+        .name(name() + ".pfArrayClipped")
+        .desc("number of prefetches dropped at the end of an array")
+        .flags(total | nozero)
+        ;
+
+    pfArrayAccuracy
+        .name(name() + ".pfArrayAccuracy")
+        .desc("fraction of the issued prefetches used per array")
+        .flags(total | nozero | nonan)
+        ;
+    pfArrayAccuracy = pfArrayUseful / pfArrayIssued;
+
+    pfArrayCoverage
+        .name(name() + ".pfArrayCoverage")
+        .desc("fraction of the demand misses removed per array")
+        .flags(total | nozero | nonan)
+        ;
+    pfArrayCoverage = pfArrayUseful / (pfArrayUseful + pfArrayDemandMisses);
+
+    // Array labels are only known at run time, so the entries have fixed
+    // names and the label of each one is reported when it gets bound
+    for (unsigned i = 0; i <= maxTrackedArrays; i++) {
+        const std::string subname =
+            i < maxTrackedArrays ? csprintf("array%d", i) : "others";
+        pfArrayIssued.subname(i, subname);
+        pfArrayUseful.subname(i, subname);
+        pfArrayDemandMisses.subname(i, subname);
+        pfArrayClipped.subname(i, subname);
+        pfArrayAccuracy.subname(i, subname);
+        pfArrayCoverage.subname(i, subname);
+    }
+}
+
+ArrayLabelPrefetcher*
+ArrayLabelPrefetcherParams::create()
+{
+   return new ArrayLabelPrefetcher(this);
+}
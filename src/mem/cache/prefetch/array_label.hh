@@ -0,0 +1,135 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Describes an array-aware stream prefetcher. Accelerators label the
+ * arrays they operate on with their virtual address ranges (see
+ * System::insertArrayLabelMapping()); this prefetcher learns one stride
+ * per labelled array and runs ahead of the accesses to it, without ever
+ * going past either end of the array.
+ */
+
+#ifndef __MEM_CACHE_PREFETCH_ARRAY_LABEL_HH__
+#define __MEM_CACHE_PREFETCH_ARRAY_LABEL_HH__
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "base/types.hh"
+#include "mem/cache/prefetch/queued.hh"
+#include "mem/packet.hh"
+#include "sim/system.hh"
+
+struct ArrayLabelPrefetcherParams;
+
+class ArrayLabelPrefetcher : public QueuedPrefetcher
+{
+  protected:
+    /** The system holding the labelled array regions. */
+    System *system;
+
+    const int maxConf;
+    const int threshConf;
+    const int minConf;
+    const int startConf;
+
+    /** Number of prefetches generated per access. */
+    const int degree;
+
+    /** Number of arrays that get their own statistics. */
+    const unsigned maxTrackedArrays;
+
+    /** Stream state of a labelled array. */
+    struct ArrayStream {
+        /** Base address of the region this state was learnt on. */
+        Addr base;
+        /** Size of that region, in bytes. */
+        Addr size;
+        /** Last block accessed in the array. */
+        Addr lastBlkAddr;
+        /** Current stride, in bytes. */
+        int64_t stride;
+        /** Confidence on the stride. */
+        int confidence;
+        /** Index of the statistics of this array. */
+        unsigned statsIdx;
+    };
+
+    /** Stream state of each array, indexed by its base address. */
+    std::unordered_map<Addr, ArrayStream> streams;
+
+    /** Statistics index assigned to each array label. */
+    std::unordered_map<std::string, unsigned> statsIndices;
+
+    /**
+     * Get the stream state of a region, creating it if the array is seen
+     * for the first time or if its mapping changed.
+     *
+     * @param region The labelled array region.
+     * @return The stream state of the array.
+     */
+    ArrayStream &getStream(const System::ArrayLabelRegion &region);
+
+    /**
+     * Get the statistics index of an array label. The first arrays get
+     * their own index, and the rest share the last one.
+     *
+     * @param label The array label.
+     * @return The index in the per-array statistics.
+     */
+    unsigned getStatsIndex(const std::string &label);
+
+    /** Prefetches issued to each array. */
+    Stats::Vector pfArrayIssued;
+    /** Demand hits to prefetched blocks of each array. */
+    Stats::Vector pfArrayUseful;
+    /** Demand misses to each array. */
+    Stats::Vector pfArrayDemandMisses;
+    /** Prefetches not generated because they were past an array end. */
+    Stats::Vector pfArrayClipped;
+    /** Fraction of the issued prefetches of each array that were used. */
+    Stats::Formula pfArrayAccuracy;
+    /** Fraction of the demand misses of each array that were removed. */
+    Stats::Formula pfArrayCoverage;
+
+  public:
+    ArrayLabelPrefetcher(const ArrayLabelPrefetcherParams *p);
+
+    ~ArrayLabelPrefetcher() {}
+
+    void notify(const PacketPtr &pkt, const PrefetchInfo &pfi) override;
+
+    void calculatePrefetch(const PrefetchInfo &pfi,
+                           std::vector<AddrPriority> &addresses) override;
+
+    PacketPtr getPacket() override;
+
+    void regStats() override;
+};
+
+#endif // __MEM_CACHE_PREFETCH_ARRAY_LABEL_HH__
@@ -56,23 +56,28 @@
 #include "params/BasePrefetcher.hh"
 #include "sim/system.hh"
 
-BasePrefetcher::PrefetchInfo::PrefetchInfo(PacketPtr pkt, Addr addr)
+BasePrefetcher::PrefetchInfo::PrefetchInfo(PacketPtr pkt, Addr addr, bool miss)
   : address(addr), pc(pkt->req->hasPC() ? pkt->req->getPC() : 0),
     masterId(pkt->req->masterId()), validPC(pkt->req->hasPC()),
-    secure(pkt->isSecure())
+    secure(pkt->isSecure()), cacheMiss(miss)
 {
 }
 
 BasePrefetcher::PrefetchInfo::PrefetchInfo(PrefetchInfo const &pfi, Addr addr)
   : address(addr), pc(pfi.pc), masterId(pfi.masterId), validPC(pfi.validPC),
-    secure(pfi.secure)
+    secure(pfi.secure), cacheMiss(pfi.cacheMiss)
+{
+}
+
+BasePrefetcher::PrefetchInfo::PrefetchInfo()
+  : address(0), pc(0), masterId(0), validPC(false), secure(false)
 {
 }
 
 void
 BasePrefetcher::PrefetchListener::notify(const PacketPtr &pkt)
 {
-    parent.probeNotify(pkt);
+    parent.probeNotify(pkt, isMiss);
 }
 
 BasePrefetcher::BasePrefetcher(const BasePrefetcherParams *p)
@@ -145,6 +150,20 @@ BasePrefetcher::inMissQueue(Addr addr, bool is_secure) const
     return cache->inMissQueue(addr, is_secure);
 }
 
+bool
+BasePrefetcher::hasBeenPrefetched(Addr addr, bool is_secure) const
+{
+    return cache->hasBeenPrefetched(addr, is_secure);
+}
+
+void
+BasePrefetcher::inCacheOrMissQueue(const std::vector<Addr> &addrs,
+                                   bool is_secure,
+                                   std::vector<bool> &present) const
+{
+    cache->inCacheOrMissQueue(addrs, is_secure, present);
+}
+
 bool
 BasePrefetcher::samePage(Addr a, Addr b) const
 {
@@ -182,7 +201,7 @@ BasePrefetcher::pageIthBlockAddress(Addr page, uint32_t blockIndex) const
 }
 
 void
-BasePrefetcher::probeNotify(const PacketPtr &pkt)
+BasePrefetcher::probeNotify(const PacketPtr &pkt, bool miss)
 {
     // Don't notify prefetcher on SWPrefetch, cache maintenance
     // operations or for writes that we are coaslescing.
@@ -193,10 +212,10 @@ BasePrefetcher::probeNotify(const PacketPtr &pkt)
     // Verify this access type is observed by prefetcher
     if (observeAccess(pkt)) {
         if (useVirtualAddresses && pkt->req->hasVaddr()) {
-            PrefetchInfo pfi(pkt, pkt->req->getVaddr());
+            PrefetchInfo pfi(pkt, pkt->req->getVaddr(), miss);
             notify(pkt, pfi);
         } else if (!useVirtualAddresses && pkt->req->hasPaddr()) {
-            PrefetchInfo pfi(pkt, pkt->req->getPaddr());
+            PrefetchInfo pfi(pkt, pkt->req->getPaddr(), miss);
             notify(pkt, pfi);
         }
     }
@@ -212,7 +231,7 @@ BasePrefetcher::regProbeListeners()
      */
     if (listeners.empty() && cache != nullptr) {
         ProbeManager *pm(cache->getProbeManager());
-        listeners.push_back(new PrefetchListener(*this, pm, "Miss"));
+        listeners.push_back(new PrefetchListener(*this, pm, "Miss", true));
         if (prefetchOnAccess) {
             listeners.push_back(new PrefetchListener(*this, pm, "Hit"));
         }
@@ -223,5 +242,6 @@ void
 BasePrefetcher::addEventProbe(SimObject *obj, const char *name)
 {
     ProbeManager *pm(obj->getProbeManager());
-    listeners.push_back(new PrefetchListener(*this, pm, name));
+    listeners.push_back(new PrefetchListener(*this, pm, name,
+                                             std::string(name) == "Miss"));
 }
@@ -50,6 +50,7 @@
 #define __MEM_CACHE_PREFETCH_BASE_HH__
 
 #include <cstdint>
+#include <vector>
 
 #include "base/statistics.hh"
 #include "base/types.hh"
@@ -67,12 +68,14 @@ class BasePrefetcher : public ClockedObject
     {
       public:
         PrefetchListener(BasePrefetcher &_parent, ProbeManager *pm,
-                         const std::string &name)
+                         const std::string &name, bool _isMiss = false)
             : ProbeListenerArgBase(pm, name),
-              parent(_parent) {}
+              parent(_parent), isMiss(_isMiss) {}
         void notify(const PacketPtr &pkt) override;
       protected:
         BasePrefetcher &parent;
+        /** Whether this listener is notified of cache misses */
+        const bool isMiss;
     };
 
     std::vector<PrefetchListener *> listeners;
@@ -93,6 +96,8 @@ class BasePrefetcher : public ClockedObject
         bool validPC;
         /** Whether this address targets the secure memory space. */
         bool secure;
+        /** Whether the access that generated this address missed. */
+        bool cacheMiss;
 
       public:
         /**
@@ -132,6 +137,16 @@ class BasePrefetcher : public ClockedObject
             return validPC;
         }
 
+        /**
+         * Returns true if the access that generated this address was
+         * notified as a cache miss
+         * @return true if the access missed in the cache
+         */
+        bool isCacheMiss() const
+        {
+            return cacheMiss;
+        }
+
         /**
          * Gets the requestor ID that generated this address
          * @return the requestor ID that generated this address
@@ -156,8 +171,9 @@ class BasePrefetcher : public ClockedObject
          * Constructs a PrefetchInfo using a PacketPtr.
          * @param pkt PacketPtr used to generate the PrefetchInfo
          * @param addr the address value of the new object
+         * @param miss whether the access missed in the cache
          */
-        PrefetchInfo(PacketPtr pkt, Addr addr);
+        PrefetchInfo(PacketPtr pkt, Addr addr, bool miss = false);
 
         /**
          * Constructs a PrefetchInfo using a new address value and
@@ -166,6 +182,12 @@ class BasePrefetcher : public ClockedObject
          * @param addr the address value of the new object
          */
         PrefetchInfo(PrefetchInfo const &pfi, Addr addr);
+
+        /**
+         * Constructs an empty PrefetchInfo, used to fill preallocated
+         * storage.
+         */
+        PrefetchInfo();
     };
 
     // PARAMETERS
@@ -214,6 +236,13 @@ class BasePrefetcher : public ClockedObject
     /** Determine if address is in cache miss queue */
     bool inMissQueue(Addr addr, bool is_secure) const;
 
+    /** Determine if address is in cache and was brought by a prefetch */
+    bool hasBeenPrefetched(Addr addr, bool is_secure) const;
+
+    /** Determine, for a batch of addresses, if each is in cache or MSHRs */
+    void inCacheOrMissQueue(const std::vector<Addr> &addrs, bool is_secure,
+                            std::vector<bool> &present) const;
+
     /** Determine if addresses are on the same page */
     bool samePage(Addr a, Addr b) const;
     /** Determine the address of the block in which a lays */
@@ -260,8 +289,9 @@ class BasePrefetcher : public ClockedObject
     /**
      * Process a notification event from the ProbeListener.
      * @param pkt The memory request causing the event
+     * @param miss Whether the event is a cache miss
      */
-    void probeNotify(const PacketPtr &pkt);
+    void probeNotify(const PacketPtr &pkt, bool miss);
 
     /**
      * Add a SimObject and a probe name to listen events from
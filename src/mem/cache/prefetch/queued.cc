@@ -48,11 +48,14 @@
 #include "params/QueuedPrefetcher.hh"
 
 QueuedPrefetcher::QueuedPrefetcher(const QueuedPrefetcherParams *p)
-    : BasePrefetcher(p), queueSize(p->queue_size), latency(p->latency),
-      queueSquash(p->queue_squash), queueFilter(p->queue_filter),
-      cacheSnoop(p->cache_snoop), tagPrefetch(p->tag_prefetch)
+    : BasePrefetcher(p), pfq(p->queue_size), queueSize(p->queue_size),
+      latency(p->latency), queueSquash(p->queue_squash),
+      queueFilter(p->queue_filter), cacheSnoop(p->cache_snoop),
+      tagPrefetch(p->tag_prefetch)
 {
-
+    fatal_if(queueSize < 2, "The prefetch queue must hold at least two "
+             "prefetches");
+    inFlight.reserve(queueSize);
 }
 
 QueuedPrefetcher::~QueuedPrefetcher()
@@ -69,16 +72,29 @@ QueuedPrefetcher::notify(const PacketPtr &pkt, const PrefetchInfo &pfi)
     Addr blk_addr = blockAddress(pfi.getAddr());
     bool is_secure = pfi.isSecure();
 
-    // Squash queued prefetches if demand miss to same line
+    // Squash queued prefetches if demand miss to same line. The queue only
+    // has to be walked if the line is known to be in it.
     if (queueSquash) {
-        auto itr = pfq.begin();
-        while (itr != pfq.end()) {
-            if (itr->pfInfo.getAddr() == blk_addr &&
-                itr->pfInfo.isSecure() == is_secure) {
-                delete itr->pkt;
-                itr = pfq.erase(itr);
-            } else {
-                ++itr;
+        const PrefetchInfo demand_pfi(pfi, blk_addr);
+        auto in_flight = inFlight.find(inFlightKey(demand_pfi));
+        if (in_flight != inFlight.end()) {
+            unsigned squashed = in_flight->second.count;
+            inFlight.erase(in_flight);
+
+            // Compact the queue, keeping the order of the other entries
+            iterator dst = pfq.begin();
+            for (iterator src = pfq.begin(); src != pfq.end(); ++src) {
+                if (src->pfInfo.sameAddr(demand_pfi)) {
+                    delete src->pkt;
+                } else {
+                    if (dst != src) {
+                        *dst = *src;
+                    }
+                    ++dst;
+                }
+            }
+            while (squashed--) {
+                pfq.pop_back();
             }
         }
     }
@@ -87,7 +103,8 @@ QueuedPrefetcher::notify(const PacketPtr &pkt, const PrefetchInfo &pfi)
     std::vector<AddrPriority> addresses;
     calculatePrefetch(pfi, addresses);
 
-    // Queue up generated prefetches
+    // Keep the candidates within the page of the access
+    candidates.clear();
     for (AddrPriority& addr_prio : addresses) {
 
         // Block align prefetch address
@@ -100,14 +117,41 @@ QueuedPrefetcher::notify(const PacketPtr &pkt, const PrefetchInfo &pfi)
             DPRINTF(HWPrefetch, "Found a pf candidate addr: %#x, "
                     "inserting into prefetch queue.\n", new_pfi.getAddr());
 
-            // Create and insert the request
-            insert(pkt, new_pfi, addr_prio.second);
+            candidates.push_back({new_pfi, addr_prio.second,
+                                  targetAddress(pkt, new_pfi), false, false});
         } else {
             // Record the number of page crossing prefetches generate
             pfSpanPage += 1;
             DPRINTF(HWPrefetch, "Ignoring page crossing prefetch.\n");
         }
     }
+
+    // Check all the candidates against the cache and MSHRs at once. The
+    // cache state does not change while they are queued, so this gives
+    // the same results as checking them one by one. Candidates that are
+    // already queued will most likely be filtered, so they are skipped.
+    if (cacheSnoop) {
+        snoopAddrs.clear();
+        for (const Candidate &cand : candidates) {
+            if (!queueFilter || !inFlight.count(inFlightKey(cand.pfInfo))) {
+                snoopAddrs.push_back(cand.target);
+            }
+        }
+        inCacheOrMissQueue(snoopAddrs, is_secure, snoopPresent);
+
+        unsigned snoop_idx = 0;
+        for (Candidate &cand : candidates) {
+            if (!queueFilter || !inFlight.count(inFlightKey(cand.pfInfo))) {
+                cand.snooped = true;
+                cand.present = snoopPresent[snoop_idx++];
+            }
+        }
+    }
+
+    // Queue up generated prefetches
+    for (const Candidate &cand : candidates) {
+        insert(cand);
+    }
 }
 
 PacketPtr
@@ -121,6 +165,7 @@ QueuedPrefetcher::getPacket()
     }
 
     PacketPtr pkt = pfq.front().pkt;
+    removeFromInFlight(pfq.front().pfInfo);
     pfq.pop_front();
 
     pfIssued++;
@@ -129,24 +174,79 @@ QueuedPrefetcher::getPacket()
     return pkt;
 }
 
-QueuedPrefetcher::const_iterator
-QueuedPrefetcher::inPrefetch(const PrefetchInfo &pfi) const
+QueuedPrefetcher::iterator
+QueuedPrefetcher::inPrefetch(const PrefetchInfo &pfi)
 {
-    for (const_iterator dp = pfq.begin(); dp != pfq.end(); dp++) {
+    // Most addresses are not queued, which the hashed set tells at once
+    if (!inFlight.count(inFlightKey(pfi))) {
+        return pfq.end();
+    }
+
+    for (iterator dp = pfq.begin(); dp != pfq.end(); dp++) {
         if (dp->pfInfo.sameAddr(pfi)) return dp;
     }
 
-    return pfq.end();
+    panic("Prefetch %#x is in flight but not queued", pfi.getAddr());
 }
 
-QueuedPrefetcher::iterator
-QueuedPrefetcher::inPrefetch(const PrefetchInfo &pfi)
+void
+QueuedPrefetcher::removeFromInFlight(const PrefetchInfo &pfi)
 {
-    for (iterator dp = pfq.begin(); dp != pfq.end(); dp++) {
-        if (dp->pfInfo.sameAddr(pfi)) return dp;
+    auto in_flight = inFlight.find(inFlightKey(pfi));
+    assert(in_flight != inFlight.end());
+    if (--in_flight->second.count == 0) {
+        inFlight.erase(in_flight);
     }
+}
 
-    return pfq.end();
+void
+QueuedPrefetcher::bubbleUp(iterator it)
+{
+    while (it != pfq.begin()) {
+        iterator prev = it;
+        --prev;
+        /* If the packet has higher priority, swap */
+        if (!(*it > *prev)) {
+            break;
+        }
+        std::swap(*it, *prev);
+        it = prev;
+    }
+}
+
+void
+QueuedPrefetcher::removeFromQueue(iterator it)
+{
+    delete it->pkt;
+    removeFromInFlight(it->pfInfo);
+
+    /* Shift the younger entries to fill the gap */
+    iterator next = it;
+    for (++next; next != pfq.end(); ++it, ++next) {
+        *it = *next;
+    }
+    pfq.pop_back();
+}
+
+Addr
+QueuedPrefetcher::targetAddress(const PacketPtr &pkt,
+                                const PrefetchInfo &pfi) const
+{
+    Addr target_addr = pfi.getAddr();
+    if (useVirtualAddresses) {
+        assert(pkt->req->hasPaddr());
+        //if we trained with virtual addresses, compute the phsysical address
+        if (pfi.getAddr() >= pkt->req->getVaddr()) {
+            //positive stride
+            target_addr = pkt->req->getPaddr() +
+                (pfi.getAddr() - pkt->req->getVaddr());
+        } else {
+            //negative stride
+            target_addr = pkt->req->getPaddr() -
+                (pkt->req->getVaddr() - pfi.getAddr());
+        }
+    }
+    return target_addr;
 }
 
 void
@@ -179,24 +279,26 @@ void
 QueuedPrefetcher::insert(const PacketPtr &pkt, PrefetchInfo &new_pfi,
                          int32_t priority)
 {
+    insert({new_pfi, priority, targetAddress(pkt, new_pfi), false, false});
+}
+
+void
+QueuedPrefetcher::insert(const Candidate &cand)
+{
+    const PrefetchInfo &new_pfi = cand.pfInfo;
+    const int32_t priority = cand.priority;
+
     if (queueFilter) {
-        iterator it = inPrefetch(new_pfi);
+        auto in_flight = inFlight.find(inFlightKey(new_pfi));
         /* If the address is already in the queue, update priority and leave */
-        if (it != pfq.end()) {
+        if (in_flight != inFlight.end()) {
             pfBufferHit++;
-            if (it->priority < priority) {
+            if (in_flight->second.priority < priority) {
                 /* Update priority value and position in the queue */
+                in_flight->second.priority = priority;
+                iterator it = inPrefetch(new_pfi);
                 it->priority = priority;
-                iterator prev = it;
-                bool cont = true;
-                while (cont && prev != pfq.begin()) {
-                    prev--;
-                    /* If the packet has higher priority, swap */
-                    if (*it > *prev) {
-                        std::swap(*it, *prev);
-                        it = prev;
-                    }
-                }
+                bubbleUp(it);
                 DPRINTF(HWPrefetch, "Prefetch addr already in "
                     "prefetch queue, priority updated\n");
             } else {
@@ -207,23 +309,10 @@ QueuedPrefetcher::insert(const PacketPtr &pkt, PrefetchInfo &new_pfi,
         }
     }
 
-    Addr target_addr = new_pfi.getAddr();
-    if (useVirtualAddresses) {
-        assert(pkt->req->hasPaddr());
-        //if we trained with virtual addresses, compute the phsysical address
-        if (new_pfi.getAddr() >= pkt->req->getVaddr()) {
-            //positive stride
-            target_addr = pkt->req->getPaddr() +
-                (new_pfi.getAddr() - pkt->req->getVaddr());
-        } else {
-            //negative stride
-            target_addr = pkt->req->getPaddr() -
-                (pkt->req->getVaddr() - new_pfi.getAddr());
-        }
-    }
-
-    if (cacheSnoop && (inCache(target_addr, new_pfi.isSecure()) ||
-                inMissQueue(target_addr, new_pfi.isSecure()))) {
+    const Addr target_addr = cand.target;
+    if (cacheSnoop && (cand.snooped ? cand.present :
+                       (inCache(target_addr, new_pfi.isSecure()) ||
+                        inMissQueue(target_addr, new_pfi.isSecure())))) {
         pfInCache++;
         DPRINTF(HWPrefetch, "Dropping redundant in "
                 "cache/MSHR prefetch addr:%#x\n", target_addr);
@@ -267,8 +356,7 @@ QueuedPrefetcher::insert(const PacketPtr &pkt, PrefetchInfo &new_pfi,
         }
         DPRINTF(HWPrefetch, "Prefetch queue full, removing lowest priority "
                             "oldest packet, addr: %#x", it->pfInfo.getAddr());
-        delete it->pkt;
-        pfq.erase(it);
+        removeFromQueue(it);
     }
 
     Tick pf_time = curTick() + clockPeriod() * latency;
@@ -276,19 +364,17 @@ QueuedPrefetcher::insert(const PacketPtr &pkt, PrefetchInfo &new_pfi,
             "addr:%#x priority: %3d tick:%lld.\n",
             target_addr, priority, pf_time);
 
-    /* Create the packet and find the spot to insert it */
-    DeferredPacket dpp(new_pfi, pf_time, pf_pkt, priority);
-    if (pfq.size() == 0) {
-        pfq.emplace_back(dpp);
+    /* Append the packet and move it to its spot, after all the packets of
+     * the same or higher priority */
+    pfq.push_back(DeferredPacket(new_pfi, pf_time, pf_pkt, priority));
+    bubbleUp(--pfq.end());
+
+    auto in_flight = inFlight.find(inFlightKey(new_pfi));
+    if (in_flight == inFlight.end()) {
+        inFlight.emplace(inFlightKey(new_pfi), InFlightEntry{1, priority});
     } else {
-        iterator it = pfq.end();
-        do {
-            --it;
-        } while (it != pfq.begin() && dpp > *it);
-        /* If we reach the head, we have to see if the new element is new head
-         * or not */
-        if (it == pfq.begin() && dpp <= *it)
-            it++;
-        pfq.insert(it, dpp);
+        in_flight->second.count++;
+        in_flight->second.priority =
+            std::max(in_flight->second.priority, priority);
     }
 }
@@ -41,9 +41,11 @@
 #define __MEM_CACHE_PREFETCH_QUEUED_HH__
 
 #include <cstdint>
-#include <list>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
+#include "base/circular_queue.hh"
 #include "base/statistics.hh"
 #include "base/types.hh"
 #include "mem/cache/prefetch/base.hh"
@@ -76,6 +78,10 @@ class QueuedPrefetcher : public BasePrefetcher
                        priority(prio) {
         }
 
+        /** Empty entry, used to fill the slots of the queue */
+        DeferredPacket() : pfInfo(), tick(0), pkt(nullptr), priority(0) {
+        }
+
         bool operator>(const DeferredPacket& that) const
         {
             return priority > that.priority;
@@ -91,7 +97,47 @@ class QueuedPrefetcher : public BasePrefetcher
     };
     using AddrPriority = std::pair<Addr, int32_t>;
 
-    std::list<DeferredPacket> pfq;
+    /**
+     * The prefetch queue, sorted by decreasing priority, and by age within
+     * a priority level. It is a ring bounded by the queue size, so issuing
+     * the head prefetch does not touch the rest of the entries.
+     */
+    CircularQueue<DeferredPacket> pfq;
+
+    /** Queued copies of a prefetch address, and their highest priority */
+    struct InFlightEntry {
+        unsigned count;
+        int32_t priority;
+    };
+
+    /**
+     * Hashed set of the addresses in the prefetch queue, keyed by
+     * inFlightKey(). Avoids scanning the queue to filter duplicates.
+     */
+    std::unordered_map<Addr, InFlightEntry> inFlight;
+
+    /** A prefetch candidate of the batch being filtered */
+    struct Candidate {
+        /** Prefetch info of the candidate */
+        PrefetchInfo pfInfo;
+        /** Priority of the candidate */
+        int32_t priority;
+        /** Address of the prefetch request */
+        Addr target;
+        /** Whether the cache and MSHRs were checked in the batch */
+        bool snooped;
+        /** Result of the batched check, if snooped */
+        bool present;
+    };
+
+    /** Candidates of the current batch, kept to reuse their storage */
+    std::vector<Candidate> candidates;
+
+    /** Addresses checked against the cache in the current batch */
+    std::vector<Addr> snoopAddrs;
+
+    /** Results of the batched check against the cache */
+    std::vector<bool> snoopPresent;
 
     // PARAMETERS
 
@@ -113,11 +159,50 @@ class QueuedPrefetcher : public BasePrefetcher
     /** Tag prefetch with PC of generating access? */
     const bool tagPrefetch;
 
-    using const_iterator = std::list<DeferredPacket>::const_iterator;
-    const_iterator inPrefetch(const PrefetchInfo &pfi) const;
-    using iterator = std::list<DeferredPacket>::iterator;
+    using iterator = CircularQueue<DeferredPacket>::iterator;
     iterator inPrefetch(const PrefetchInfo &pfi);
 
+    /** Key of a prefetch address in the in-flight set */
+    static Addr inFlightKey(const PrefetchInfo &pfi)
+    {
+        return (pfi.getAddr() << 1) | pfi.isSecure();
+    }
+
+    /**
+     * Compute the address of the request of a prefetch, translating it if
+     * the prefetcher is trained with virtual addresses.
+     *
+     * @param pkt The access that triggered the prefetch.
+     * @param pfi The prefetch information.
+     * @return The target address of the prefetch request.
+     */
+    Addr targetAddress(const PacketPtr &pkt, const PrefetchInfo &pfi) const;
+
+    /**
+     * Queue a prefetch candidate whose target is known.
+     *
+     * @param cand The candidate.
+     */
+    void insert(const Candidate &cand);
+
+    /**
+     * Move the entry at the given position towards the head of the queue
+     * until the queue is sorted again.
+     *
+     * @param it Position of the entry.
+     */
+    void bubbleUp(iterator it);
+
+    /**
+     * Remove the entry at the given position, deleting its packet.
+     *
+     * @param it Position of the entry.
+     */
+    void removeFromQueue(iterator it);
+
+    /** Account for a packet leaving the queue in the in-flight set */
+    void removeFromInFlight(const PrefetchInfo &pfi);
+
     // STATS
     Stats::Scalar pfIdentified;
     Stats::Scalar pfBufferHit;
@@ -139,11 +224,10 @@ class QueuedPrefetcher : public BasePrefetcher
 
     Tick nextPrefetchReadyTime() const override
     {
-        return pfq.empty() ? MaxTick : pfq.front().tick;
+        return pfq.empty() ? MaxTick : pfq.begin()->tick;
     }
 
     void regStats() override;
 };
 
 #endif //__MEM_CACHE_PREFETCH_QUEUED_HH__
-
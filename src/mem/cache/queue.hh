@@ -49,8 +49,11 @@
 #ifndef __MEM_CACHE_QUEUE_HH__
 #define __MEM_CACHE_QUEUE_HH__
 
+#include <algorithm>
 #include <cassert>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "base/logging.hh"
 #include "base/trace.hh"
@@ -97,6 +100,32 @@ class Queue : public Drainable
     /** Holds non allocated entries. */
     typename Entry::List freeList;
 
+    /**
+     * Index of the allocated entries keyed by block address. Each
+     * bucket keeps its entries in allocation order, i.e. the order in
+     * which they appear in the allocatedList, so that a lookup
+     * through the index returns the same entry as a scan of the list.
+     */
+    std::unordered_map<Addr, std::vector<Entry*>> allocatedIndex;
+
+    typename Entry::Iterator addToAllocatedList(Entry* entry)
+    {
+        allocatedIndex[entry->blkAddr].push_back(entry);
+        return allocatedList.insert(allocatedList.end(), entry);
+    }
+
+    void removeFromAllocatedList(Entry* entry)
+    {
+        auto idx = allocatedIndex.find(entry->blkAddr);
+        assert(idx != allocatedIndex.end());
+        auto &bucket = idx->second;
+        bucket.erase(std::find(bucket.begin(), bucket.end(), entry));
+        if (bucket.empty()) {
+            allocatedIndex.erase(idx);
+        }
+        allocatedList.erase(entry->allocIter);
+    }
+
     typename Entry::Iterator addToReadyList(Entry* entry)
     {
         if (readyList.empty() ||
@@ -104,6 +133,12 @@ class Queue : public Drainable
             return readyList.insert(readyList.end(), entry);
         }
 
+        // entries that are ready before everything else in the list,
+        // e.g. a re-requested entry, go straight to the front
+        if (readyList.front()->readyTime > entry->readyTime) {
+            return readyList.insert(readyList.begin(), entry);
+        }
+
         for (auto i = readyList.begin(); i != readyList.end(); ++i) {
             if ((*i)->readyTime > entry->readyTime) {
                 return readyList.insert(i, entry);
@@ -112,6 +147,16 @@ class Queue : public Drainable
         panic("Failed to add to ready list.");
     }
 
+    Entry* findPendingInReadyList(Addr blk_addr, bool is_secure) const
+    {
+        for (const auto& entry : readyList) {
+            if (entry->blkAddr == blk_addr && entry->isSecure == is_secure) {
+                return entry;
+            }
+        }
+        return nullptr;
+    }
+
     /** The number of entries that are in service. */
     int _numInService;
 
@@ -134,6 +179,7 @@ class Queue : public Drainable
         for (int i = 0; i < numEntries; ++i) {
             freeList.push_back(&entries[i]);
         }
+        allocatedIndex.reserve(numEntries);
     }
 
     bool isEmpty() const
@@ -162,7 +208,12 @@ class Queue : public Drainable
     Entry* findMatch(Addr blk_addr, bool is_secure,
                      bool ignore_uncacheable = true) const
     {
-        for (const auto& entry : allocatedList) {
+        auto idx = allocatedIndex.find(blk_addr);
+        if (idx == allocatedIndex.end()) {
+            return nullptr;
+        }
+
+        for (const auto& entry : idx->second) {
             // we ignore any entries allocated for uncacheable
             // accesses and simply ignore them when matching, in the
             // cache we never check for matches when adding new
@@ -170,7 +221,7 @@ class Queue : public Drainable
             // cacheable accesses being added to an WriteQueueEntry
             // serving an uncacheable access
             if (!(ignore_uncacheable && entry->isUncacheable()) &&
-                entry->blkAddr == blk_addr && entry->isSecure == is_secure) {
+                entry->isSecure == is_secure) {
                 return entry;
             }
         }
@@ -179,9 +230,14 @@ class Queue : public Drainable
 
     bool trySatisfyFunctional(PacketPtr pkt, Addr blk_addr)
     {
+        auto idx = allocatedIndex.find(blk_addr);
+        if (idx == allocatedIndex.end()) {
+            return false;
+        }
+
         pkt->pushLabel(label);
-        for (const auto& entry : allocatedList) {
-            if (entry->blkAddr == blk_addr && entry->trySatisfyFunctional(pkt)) {
+        for (const auto& entry : idx->second) {
+            if (entry->trySatisfyFunctional(pkt)) {
                 pkt->popLabel();
                 return true;
             }
@@ -198,12 +254,26 @@ class Queue : public Drainable
      */
     Entry* findPending(Addr blk_addr, bool is_secure) const
     {
-        for (const auto& entry : readyList) {
-            if (entry->blkAddr == blk_addr && entry->isSecure == is_secure) {
-                return entry;
+        auto idx = allocatedIndex.find(blk_addr);
+        if (idx == allocatedIndex.end()) {
+            return nullptr;
+        }
+
+        // An entry is on the readyList if and only if it is not in
+        // service, so the pending candidates are the entries of the
+        // bucket that are not in service
+        Entry* match = nullptr;
+        for (const auto& entry : idx->second) {
+            if (!entry->inService && entry->isSecure == is_secure) {
+                if (match) {
+                    // more than one candidate, the earliest one is
+                    // determined by the position in the readyList
+                    return findPendingInReadyList(blk_addr, is_secure);
+                }
+                match = entry;
             }
         }
-        return nullptr;
+        return match;
     }
 
     /**
@@ -231,7 +301,7 @@ class Queue : public Drainable
      */
     void deallocate(Entry *entry)
     {
-        allocatedList.erase(entry->allocIter);
+        removeFromAllocatedList(entry);
         freeList.push_front(entry);
         allocated--;
         if (entry->inService) {
@@ -32,6 +32,9 @@
 #define __MEM_CACHE_REPLACEMENT_POLICIES_BASE_HH__
 
 #include <memory>
+#include <typeinfo>
+#include <utility>
+#include <vector>
 
 #include "mem/cache/replacement_policies/replaceable_entry.hh"
 #include "params/BaseReplacementPolicy.hh"
@@ -42,6 +45,65 @@
  */
 typedef std::vector<ReplaceableEntry*> ReplacementCandidates;
 
+/**
+ * Contiguous storage for the replacement data of a policy. Entries are
+ * carved out of fixed-size chunks and the shared pointers handed out
+ * alias the chunk that holds them. This avoids a heap allocation per
+ * entry, and keeps the data of consecutively instantiated entries (i.e.,
+ * the ways of a set) next to each other in memory, so that a victim
+ * search over a set walks a dense array of small records.
+ *
+ * The type of the entries is chosen on allocation, so that a derived
+ * policy that extends its parent's replacement data reuses the parent's
+ * pool instead of declaring its own.
+ */
+class ReplacementDataPool
+{
+  private:
+    /** Number of entries held by a chunk. */
+    static const size_t chunkSize = 1024;
+
+    /** Chunk entries are currently being carved out of. */
+    std::shared_ptr<void> chunk;
+
+    /** Type of the entries held by the current chunk. */
+    const std::type_info *chunkType;
+
+    /** Number of entries constructed in the current chunk. */
+    size_t chunkUsed;
+
+  public:
+    ReplacementDataPool() : chunkType(nullptr), chunkUsed(0) {}
+
+    /**
+     * Construct a new replacement data entry in the pool.
+     *
+     * @tparam Data Type of the replacement data entry.
+     * @param args Arguments forwarded to the entry's constructor.
+     * @return A shared pointer to the new replacement data.
+     */
+    template <class Data, typename... Args>
+    std::shared_ptr<ReplacementData> allocate(Args&&... args)
+    {
+        // The chunk never grows past its reserved size, so that the
+        // entries already handed out are never relocated. A chunk only
+        // ever holds entries of a single type
+        if (!chunk || chunkUsed == chunkSize ||
+            *chunkType != typeid(Data)) {
+            auto new_chunk = std::make_shared<std::vector<Data>>();
+            new_chunk->reserve(chunkSize);
+            chunk = new_chunk;
+            chunkType = &typeid(Data);
+            chunkUsed = 0;
+        }
+        auto *entries = static_cast<std::vector<Data>*>(chunk.get());
+        entries->emplace_back(std::forward<Args>(args)...);
+        chunkUsed++;
+
+        return std::shared_ptr<ReplacementData>(chunk, &entries->back());
+    }
+};
+
 /**
  * A common base class of cache replacement policy objects.
  */
@@ -53,6 +115,11 @@ class BaseReplacementPolicy : public SimObject
       */
     typedef BaseReplacementPolicyParams Params;
 
+  protected:
+    /** Storage of the replacement data entries. */
+    ReplacementDataPool dataPool;
+
+  public:
     /**
      * Construct and initiliaze this replacement policy.
      */
@@ -31,6 +31,7 @@
 #include "mem/cache/replacement_policies/brrip_rp.hh"
 
 #include <cassert>
+#include <cstdint>
 #include <memory>
 
 #include "base/logging.hh" // For fatal_if
@@ -42,14 +43,16 @@ BRRIPRP::BRRIPRP(const Params *p)
       maxRRPV(p->max_RRPV), hitPriority(p->hit_priority), btp(p->btp)
 {
     fatal_if(maxRRPV <= 0, "max_RRPV should be greater than zero.\n");
+    fatal_if(maxRRPV >= UINT8_MAX, "max_RRPV should be smaller than %d.\n",
+             UINT8_MAX);
 }
 
 void
 BRRIPRP::invalidate(const std::shared_ptr<ReplacementData>& replacement_data)
 const
 {
-    std::shared_ptr<BRRIPReplData> casted_replacement_data =
-        std::static_pointer_cast<BRRIPReplData>(replacement_data);
+    BRRIPReplData* casted_replacement_data =
+        static_cast<BRRIPReplData*>(replacement_data.get());
 
     // Set RRPV to an invalid distance
     casted_replacement_data->rrpv = maxRRPV + 1;
@@ -58,8 +61,8 @@ const
 void
 BRRIPRP::touch(const std::shared_ptr<ReplacementData>& replacement_data) const
 {
-    std::shared_ptr<BRRIPReplData> casted_replacement_data =
-        std::static_pointer_cast<BRRIPReplData>(replacement_data);
+    BRRIPReplData* casted_replacement_data =
+        static_cast<BRRIPReplData*>(replacement_data.get());
 
     // Update RRPV if not 0 yet
     // Every hit in HP mode makes the entry the last to be evicted, while
@@ -74,8 +77,8 @@ BRRIPRP::touch(const std::shared_ptr<ReplacementData>& replacement_data) const
 void
 BRRIPRP::reset(const std::shared_ptr<ReplacementData>& replacement_data) const
 {
-    std::shared_ptr<BRRIPReplData> casted_replacement_data =
-        std::static_pointer_cast<BRRIPReplData>(replacement_data);
+    BRRIPReplData* casted_replacement_data =
+        static_cast<BRRIPReplData*>(replacement_data.get());
 
     // Reset RRPV
     // Replacement data is inserted as "long re-reference" if lower than btp,
@@ -93,27 +96,26 @@ BRRIPRP::getVictim(const ReplacementCandidates& candidates) const
     // There must be at least one replacement candidate
     assert(candidates.size() > 0);
 
-    // Use first candidate as dummy victim
-    ReplaceableEntry* victim = candidates[0];
-
-    // Store victim->rrpv in a variable to improve code readability
-    int victim_RRPV = std::static_pointer_cast<BRRIPReplData>(
-                        victim->replacementData)->rrpv;
-
-    // Visit all candidates to find victim
-    for (const auto& candidate : candidates) {
-        // Get candidate's rrpv
-        int candidate_RRPV = std::static_pointer_cast<BRRIPReplData>(
-                                    candidate->replacementData)->rrpv;
-
-        // Stop searching for victims if an invalid entry is found
-        if (candidate_RRPV == maxRRPV + 1) {
-            return candidate;
-        // Update victim entry if necessary
-        } else if (candidate_RRPV > victim_RRPV) {
-            victim = candidate;
-            victim_RRPV = candidate_RRPV;
-        }
+    // Visit all candidates to find the first invalid entry and the first
+    // entry with the highest RRPV. The scan selects instead of branching
+    const size_t num_candidates = candidates.size();
+    size_t invalid = num_candidates;
+    size_t victim = 0;
+    int victim_RRPV = -1;
+    for (size_t i = 0; i < num_candidates; i++) {
+        const int candidate_RRPV = static_cast<BRRIPReplData*>(
+            candidates[i]->replacementData.get())->rrpv;
+        const bool first_invalid = (invalid == num_candidates) &&
+                                   (candidate_RRPV == maxRRPV + 1);
+        invalid = first_invalid ? i : invalid;
+        const bool better = candidate_RRPV > victim_RRPV;
+        victim = better ? i : victim;
+        victim_RRPV = better ? candidate_RRPV : victim_RRPV;
+    }
+
+    // Invalid entries have the eviction priority
+    if (invalid != num_candidates) {
+        return candidates[invalid];
     }
 
     // Get difference of victim's RRPV to the highest possible RRPV in
@@ -124,18 +126,18 @@ BRRIPRP::getVictim(const ReplacementCandidates& candidates) const
     if (diff > 0){
         // Update RRPV of all candidates
         for (const auto& candidate : candidates) {
-            std::static_pointer_cast<BRRIPReplData>(
-                candidate->replacementData)->rrpv += diff;
+            static_cast<BRRIPReplData*>(
+                candidate->replacementData.get())->rrpv += diff;
         }
     }
 
-    return victim;
+    return candidates[victim];
 }
 
 std::shared_ptr<ReplacementData>
 BRRIPRP::instantiateEntry()
 {
-    return std::shared_ptr<ReplacementData>(new BRRIPReplData(maxRRPV));
+    return dataPool.allocate<BRRIPReplData>(maxRRPV);
 }
 
 BRRIPRP*
@@ -66,9 +66,10 @@ class BRRIPRP : public BaseReplacementPolicy
     {
         /**
          * Re-Reference Interval Prediction Value.
-         * A value equal to max_RRPV + 1 indicates an invalid entry.
+         * A value equal to max_RRPV + 1 indicates an invalid entry. It is
+         * kept in a byte so that a set's RRPVs fit in a few cache lines.
          */
-        int rrpv;
+        uint8_t rrpv;
 
         /**
          * Default constructor. Invalidate data.
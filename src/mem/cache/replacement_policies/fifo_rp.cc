@@ -45,8 +45,8 @@ FIFORP::invalidate(const std::shared_ptr<ReplacementData>& replacement_data)
 const
 {
     // Reset insertion tick
-    std::static_pointer_cast<FIFOReplData>(
-        replacement_data)->tickInserted = Tick(0);
+    static_cast<FIFOReplData*>(
+        replacement_data.get())->tickInserted = Tick(0);
 }
 
 void
@@ -59,8 +59,8 @@ void
 FIFORP::reset(const std::shared_ptr<ReplacementData>& replacement_data) const
 {
     // Set insertion tick
-    std::static_pointer_cast<FIFOReplData>(
-        replacement_data)->tickInserted = curTick();
+    static_cast<FIFOReplData*>(
+        replacement_data.get())->tickInserted = curTick();
 }
 
 ReplaceableEntry*
@@ -69,25 +69,26 @@ FIFORP::getVictim(const ReplacementCandidates& candidates) const
     // There must be at least one replacement candidate
     assert(candidates.size() > 0);
 
-    // Visit all candidates to find victim
-    ReplaceableEntry* victim = candidates[0];
-    for (const auto& candidate : candidates) {
-        // Update victim entry if necessary
-        if (std::static_pointer_cast<FIFOReplData>(
-                    candidate->replacementData)->tickInserted <
-                std::static_pointer_cast<FIFOReplData>(
-                    victim->replacementData)->tickInserted) {
-            victim = candidate;
-        }
+    // Visit all candidates to find victim. The scan selects instead of
+    // branching, and keeps the first candidate on ties
+    size_t victim = 0;
+    Tick victim_tick = static_cast<FIFOReplData*>(
+        candidates[0]->replacementData.get())->tickInserted;
+    for (size_t i = 1; i < candidates.size(); i++) {
+        const Tick tick = static_cast<FIFOReplData*>(
+            candidates[i]->replacementData.get())->tickInserted;
+        const bool better = tick < victim_tick;
+        victim = better ? i : victim;
+        victim_tick = better ? tick : victim_tick;
     }
 
-    return victim;
+    return candidates[victim];
 }
 
 std::shared_ptr<ReplacementData>
 FIFORP::instantiateEntry()
 {
-    return std::shared_ptr<ReplacementData>(new FIFOReplData());
+    return dataPool.allocate<FIFOReplData>();
 }
 
 FIFORP*
@@ -45,21 +45,21 @@ LFURP::invalidate(const std::shared_ptr<ReplacementData>& replacement_data)
 const
 {
     // Reset reference count
-    std::static_pointer_cast<LFUReplData>(replacement_data)->refCount = 0;
+    static_cast<LFUReplData*>(replacement_data.get())->refCount = 0;
 }
 
 void
 LFURP::touch(const std::shared_ptr<ReplacementData>& replacement_data) const
 {
     // Update reference count
-    std::static_pointer_cast<LFUReplData>(replacement_data)->refCount++;
+    static_cast<LFUReplData*>(replacement_data.get())->refCount++;
 }
 
 void
 LFURP::reset(const std::shared_ptr<ReplacementData>& replacement_data) const
 {
     // Reset reference count
-    std::static_pointer_cast<LFUReplData>(replacement_data)->refCount = 1;
+    static_cast<LFUReplData*>(replacement_data.get())->refCount = 1;
 }
 
 ReplaceableEntry*
@@ -68,25 +68,26 @@ LFURP::getVictim(const ReplacementCandidates& candidates) const
     // There must be at least one replacement candidate
     assert(candidates.size() > 0);
 
-    // Visit all candidates to find victim
-    ReplaceableEntry* victim = candidates[0];
-    for (const auto& candidate : candidates) {
-        // Update victim entry if necessary
-        if (std::static_pointer_cast<LFUReplData>(
-                    candidate->replacementData)->refCount <
-                std::static_pointer_cast<LFUReplData>(
-                    victim->replacementData)->refCount) {
-            victim = candidate;
-        }
+    // Visit all candidates to find victim. The scan selects instead of
+    // branching, and keeps the first candidate on ties
+    size_t victim = 0;
+    unsigned victim_count = static_cast<LFUReplData*>(
+        candidates[0]->replacementData.get())->refCount;
+    for (size_t i = 1; i < candidates.size(); i++) {
+        const unsigned count = static_cast<LFUReplData*>(
+            candidates[i]->replacementData.get())->refCount;
+        const bool better = count < victim_count;
+        victim = better ? i : victim;
+        victim_count = better ? count : victim_count;
     }
 
-    return victim;
+    return candidates[victim];
 }
 
 std::shared_ptr<ReplacementData>
 LFURP::instantiateEntry()
 {
-    return std::shared_ptr<ReplacementData>(new LFUReplData());
+    return dataPool.allocate<LFUReplData>();
 }
 
 LFURP*
@@ -45,24 +45,24 @@ LRURP::invalidate(const std::shared_ptr<ReplacementData>& replacement_data)
 const
 {
     // Reset last touch timestamp
-    std::static_pointer_cast<LRUReplData>(
-        replacement_data)->lastTouchTick = Tick(0);
+    static_cast<LRUReplData*>(
+        replacement_data.get())->lastTouchTick = Tick(0);
 }
 
 void
 LRURP::touch(const std::shared_ptr<ReplacementData>& replacement_data) const
 {
     // Update last touch timestamp
-    std::static_pointer_cast<LRUReplData>(
-        replacement_data)->lastTouchTick = curTick();
+    static_cast<LRUReplData*>(
+        replacement_data.get())->lastTouchTick = curTick();
 }
 
 void
 LRURP::reset(const std::shared_ptr<ReplacementData>& replacement_data) const
 {
     // Set last touch timestamp
-    std::static_pointer_cast<LRUReplData>(
-        replacement_data)->lastTouchTick = curTick();
+    static_cast<LRUReplData*>(
+        replacement_data.get())->lastTouchTick = curTick();
 }
 
 ReplaceableEntry*
@@ -71,25 +71,26 @@ LRURP::getVictim(const ReplacementCandidates& candidates) const
     // There must be at least one replacement candidate
     assert(candidates.size() > 0);
 
-    // Visit all candidates to find victim
-    ReplaceableEntry* victim = candidates[0];
-    for (const auto& candidate : candidates) {
-        // Update victim entry if necessary
-        if (std::static_pointer_cast<LRUReplData>(
-                    candidate->replacementData)->lastTouchTick <
-                std::static_pointer_cast<LRUReplData>(
-                    victim->replacementData)->lastTouchTick) {
-            victim = candidate;
-        }
+    // Visit all candidates to find victim. The scan selects instead of
+    // branching, and keeps the first candidate on ties
+    size_t victim = 0;
+    Tick victim_tick = static_cast<LRUReplData*>(
+        candidates[0]->replacementData.get())->lastTouchTick;
+    for (size_t i = 1; i < candidates.size(); i++) {
+        const Tick tick = static_cast<LRUReplData*>(
+            candidates[i]->replacementData.get())->lastTouchTick;
+        const bool better = tick < victim_tick;
+        victim = better ? i : victim;
+        victim_tick = better ? tick : victim_tick;
     }
 
-    return victim;
+    return candidates[victim];
 }
 
 std::shared_ptr<ReplacementData>
 LRURP::instantiateEntry()
 {
-    return std::shared_ptr<ReplacementData>(new LRUReplData());
+    return dataPool.allocate<LRUReplData>();
 }
 
 LRURP*
@@ -46,8 +46,8 @@ RandomRP::invalidate(const std::shared_ptr<ReplacementData>& replacement_data)
 const
 {
     // Unprioritize replacement data victimization
-    std::static_pointer_cast<RandomReplData>(
-        replacement_data)->valid = false;
+    static_cast<RandomReplData*>(
+        replacement_data.get())->valid = false;
 }
 
 void
@@ -59,8 +59,8 @@ void
 RandomRP::reset(const std::shared_ptr<ReplacementData>& replacement_data) const
 {
     // Unprioritize replacement data victimization
-    std::static_pointer_cast<RandomReplData>(
-        replacement_data)->valid = true;
+    static_cast<RandomReplData*>(
+        replacement_data.get())->valid = true;
 }
 
 ReplaceableEntry*
@@ -70,26 +70,26 @@ RandomRP::getVictim(const ReplacementCandidates& candidates) const
     assert(candidates.size() > 0);
 
     // Choose one candidate at random
-    ReplaceableEntry* victim = candidates[random_mt.random<unsigned>(0,
-                                    candidates.size() - 1)];
+    const size_t num_candidates = candidates.size();
+    size_t victim = random_mt.random<unsigned>(0, num_candidates - 1);
 
     // Visit all candidates to search for an invalid entry. If one is found,
-    // its eviction is prioritized
-    for (const auto& candidate : candidates) {
-        if (!std::static_pointer_cast<RandomReplData>(
-                    candidate->replacementData)->valid) {
-            victim = candidate;
-            break;
-        }
+    // its eviction is prioritized. The scan selects instead of branching
+    size_t invalid = num_candidates;
+    for (size_t i = 0; i < num_candidates; i++) {
+        const bool valid = static_cast<RandomReplData*>(
+            candidates[i]->replacementData.get())->valid;
+        invalid = (invalid == num_candidates && !valid) ? i : invalid;
     }
+    victim = (invalid != num_candidates) ? invalid : victim;
 
-    return victim;
+    return candidates[victim];
 }
 
 std::shared_ptr<ReplacementData>
 RandomRP::instantiateEntry()
 {
-    return std::shared_ptr<ReplacementData>(new RandomReplData());
+    return dataPool.allocate<RandomReplData>();
 }
 
 RandomRP*
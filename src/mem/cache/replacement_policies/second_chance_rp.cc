@@ -41,13 +41,14 @@ SecondChanceRP::SecondChanceRP(const Params *p)
 
 void
 SecondChanceRP::useSecondChance(
-    const std::shared_ptr<SecondChanceReplData>& replacement_data) const
+    const std::shared_ptr<ReplacementData>& replacement_data) const
 {
     // Reset FIFO data
     FIFORP::reset(replacement_data);
 
     // Use second chance
-    replacement_data->hasSecondChance = false;
+    static_cast<SecondChanceReplData*>(
+        replacement_data.get())->hasSecondChance = false;
 }
 
 void
@@ -57,8 +58,8 @@ SecondChanceRP::invalidate(
     FIFORP::invalidate(replacement_data);
 
     // Do not give a second chance to invalid entries
-    std::static_pointer_cast<SecondChanceReplData>(
-        replacement_data)->hasSecondChance = false;
+    static_cast<SecondChanceReplData*>(
+        replacement_data.get())->hasSecondChance = false;
 }
 
 void
@@ -67,8 +68,8 @@ SecondChanceRP::touch(const std::shared_ptr<ReplacementData>& replacement_data)
     FIFORP::touch(replacement_data);
 
     // Whenever an entry is touched, it is given a second chance
-    std::static_pointer_cast<SecondChanceReplData>(
-        replacement_data)->hasSecondChance = true;
+    static_cast<SecondChanceReplData*>(
+        replacement_data.get())->hasSecondChance = true;
 }
 
 void
@@ -77,8 +78,8 @@ SecondChanceRP::reset(const std::shared_ptr<ReplacementData>& replacement_data)
     FIFORP::reset(replacement_data);
 
     // Entries are inserted with a second chance
-    std::static_pointer_cast<SecondChanceReplData>(
-        replacement_data)->hasSecondChance = true;
+    static_cast<SecondChanceReplData*>(
+        replacement_data.get())->hasSecondChance = true;
 }
 
 ReplaceableEntry*
@@ -90,9 +91,9 @@ SecondChanceRP::getVictim(const ReplacementCandidates& candidates) const
     // Search for invalid entries, as they have the eviction priority
     for (const auto& candidate : candidates) {
         // Cast candidate's replacement data
-        std::shared_ptr<SecondChanceReplData> candidate_replacement_data =
-            std::static_pointer_cast<SecondChanceReplData>(
-                candidate->replacementData);
+        SecondChanceReplData* candidate_replacement_data =
+            static_cast<SecondChanceReplData*>(
+                candidate->replacementData.get());
 
         // Stop iteration if found an invalid entry
         if ((candidate_replacement_data->tickInserted == Tick(0)) &&
@@ -109,13 +110,13 @@ SecondChanceRP::getVictim(const ReplacementCandidates& candidates) const
         victim = FIFORP::getVictim(candidates);
 
         // Cast victim's replacement data for code readability
-        std::shared_ptr<SecondChanceReplData> victim_replacement_data =
-            std::static_pointer_cast<SecondChanceReplData>(
-                victim->replacementData);
+        SecondChanceReplData* victim_replacement_data =
+            static_cast<SecondChanceReplData*>(
+                victim->replacementData.get());
 
         // If victim has a second chance, use it and repeat search
         if (victim_replacement_data->hasSecondChance) {
-            useSecondChance(victim_replacement_data);
+            useSecondChance(victim->replacementData);
         } else {
             // Found victim
             search_victim = false;
@@ -128,7 +129,7 @@ SecondChanceRP::getVictim(const ReplacementCandidates& candidates) const
 std::shared_ptr<ReplacementData>
 SecondChanceRP::instantiateEntry()
 {
-    return std::shared_ptr<ReplacementData>(new SecondChanceReplData());
+    return dataPool.allocate<SecondChanceReplData>();
 }
 
 SecondChanceRP*
@@ -70,7 +70,7 @@ class SecondChanceRP : public FIFORP
      * @param replacement_data Entry that will use its second chance.
      */
     void useSecondChance(
-        const std::shared_ptr<SecondChanceReplData>& replacement_data) const;
+        const std::shared_ptr<ReplacementData>& replacement_data) const;
 
   public:
     /** Convenience typedef. */
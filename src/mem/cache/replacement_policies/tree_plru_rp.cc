@@ -36,8 +36,6 @@
 
 #include "mem/cache/replacement_policies/tree_plru_rp.hh"
 
-#include <cmath>
-
 #include "base/intmath.hh"
 #include "base/logging.hh"
 #include "params/TreePLRURP.hh"
@@ -51,7 +49,7 @@
 static uint64_t
 parentIndex(const uint64_t index)
 {
-    return std::floor((index-1)/2);
+    return (index-1)/2;
 }
 
 /**
@@ -98,8 +96,7 @@ TreePLRURP::TreePLRUReplData::TreePLRUReplData(
 }
 
 TreePLRURP::TreePLRURP(const Params *p)
-    : BaseReplacementPolicy(p), numLeaves(p->num_leaves), count(0),
-      treeInstance(nullptr)
+    : BaseReplacementPolicy(p), numLeaves(p->num_leaves), count(0)
 {
     fatal_if(!isPowerOf2(numLeaves),
              "Number of leaves must be non-zero and a power of 2");
@@ -110,8 +107,8 @@ TreePLRURP::invalidate(
     const std::shared_ptr<ReplacementData>& replacement_data) const
 {
     // Cast replacement data
-    std::shared_ptr<TreePLRUReplData> treePLRU_replacement_data =
-        std::static_pointer_cast<TreePLRUReplData>(replacement_data);
+    TreePLRUReplData* treePLRU_replacement_data =
+        static_cast<TreePLRUReplData*>(replacement_data.get());
     PLRUTree* tree = treePLRU_replacement_data->tree.get();
 
     // Index of the tree entry we are currently checking
@@ -136,8 +133,8 @@ TreePLRURP::touch(const std::shared_ptr<ReplacementData>& replacement_data)
 const
 {
     // Cast replacement data
-    std::shared_ptr<TreePLRUReplData> treePLRU_replacement_data =
-        std::static_pointer_cast<TreePLRUReplData>(replacement_data);
+    TreePLRUReplData* treePLRU_replacement_data =
+        static_cast<TreePLRUReplData*>(replacement_data.get());
     PLRUTree* tree = treePLRU_replacement_data->tree.get();
 
     // Index of the tree entry we are currently checking
@@ -172,8 +169,8 @@ TreePLRURP::getVictim(const ReplacementCandidates& candidates) const
     assert(candidates.size() > 0);
 
     // Get tree
-    const PLRUTree* tree = std::static_pointer_cast<TreePLRUReplData>(
-            candidates[0]->replacementData)->tree.get();
+    const PLRUTree* tree = static_cast<TreePLRUReplData*>(
+            candidates[0]->replacementData.get())->tree.get();
 
     // Index of the tree entry we are currently checking. Start with root.
     uint64_t tree_index = 0;
@@ -198,18 +195,16 @@ TreePLRURP::instantiateEntry()
 {
     // Generate a tree instance every numLeaves created
     if (count % numLeaves == 0) {
-        treeInstance = new PLRUTree(numLeaves - 1, false);
+        treeInstance = std::make_shared<PLRUTree>(numLeaves - 1, false);
     }
 
     // Create replacement data using current tree instance
-    TreePLRUReplData* treePLRUReplData = new TreePLRUReplData(
-        (count % numLeaves) + numLeaves - 1,
-        std::shared_ptr<PLRUTree>(treeInstance));
+    const uint64_t index = (count % numLeaves) + numLeaves - 1;
 
     // Update instance counter
     count++;
 
-    return std::shared_ptr<ReplacementData>(treePLRUReplData);
+    return dataPool.allocate<TreePLRUReplData>(index, treeInstance);
 }
 
 TreePLRURP*
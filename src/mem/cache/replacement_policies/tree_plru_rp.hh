@@ -117,8 +117,10 @@ class TreePLRURP : public BaseReplacementPolicy
 
     /**
      * Holds the latest temporary tree instance created by instantiateEntry().
+     * It is shared with the replacement data of the entries of its set, so
+     * that the tree is released only once all of them are gone.
      */
-    PLRUTree* treeInstance;
+    std::shared_ptr<PLRUTree> treeInstance;
 
   protected:
     /**
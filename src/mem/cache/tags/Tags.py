@@ -101,6 +101,21 @@ class SectorTags(BaseTags):
     replacement_policy = Param.BaseReplacementPolicy(
         Parent.replacement_policy, "Replacement policy")
 
+class CompressedTags(SectorTags):
+    type = 'CompressedTags'
+    cxx_header = "mem/cache/tags/compressed_tags.hh"
+
+    # Maximum number of compressed blocks per tag
+    max_compression_ratio = Param.Int(2,
+        "Maximum number of compressed blocks per tag.")
+
+    # We simulate superblocks as sector blocks
+    num_blocks_per_sector = Self.max_compression_ratio
+
+    # We virtually increase the number of data blocks per tag by multiplying
+    # the cache size by the compression ratio
+    size = Parent.size * Self.max_compression_ratio
+
 class FALRU(BaseTags):
     type = 'FALRU'
     cxx_class = 'FALRU'
@@ -183,7 +183,7 @@ class BaseTags : public ClockedObject
     /**
      * Computes stats just prior to dump event
      */
-    void computeStats();
+    virtual void computeStats();
 
     /**
      * Print all tags used
@@ -275,10 +275,12 @@ class BaseTags : public ClockedObject
      *
      * @param addr Address to find a victim for.
      * @param is_secure True if the target memory space is secure.
+     * @param size Size, in bits, of the data to be allocated.
      * @param evict_blks Cache blocks to be evicted.
      * @return Cache block to be replaced.
      */
     virtual CacheBlk* findVictim(Addr addr, const bool is_secure,
+                                 const std::size_t size,
                                  std::vector<CacheBlk*>& evict_blks) const = 0;
 
     /**
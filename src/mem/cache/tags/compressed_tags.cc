@@ -0,0 +1,240 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Definitions of a compressed set associative tag store using superblocks.
+ */
+
+#include "mem/cache/tags/compressed_tags.hh"
+
+#include <cassert>
+
+#include "base/logging.hh"
+#include "mem/cache/replacement_policies/base.hh"
+#include "mem/cache/tags/indexing_policies/base.hh"
+
+CompressedTags::CompressedTags(const Params *p)
+    : SectorTags(p)
+{
+    fatal_if(numBlocksPerSector < 2,
+             "A compressed cache must fit at least two blocks per superblock");
+}
+
+void
+CompressedTags::tagsInit()
+{
+    blks = std::vector<CompressionBlk>(numBlocks);
+    superBlks = std::vector<SuperBlk>(numSectors);
+
+    // Initialize all blocks
+    unsigned blk_index = 0;       // index into blks array
+    for (unsigned superblock_index = 0; superblock_index < numSectors;
+         superblock_index++)
+    {
+        // Locate next cache superblock
+        SuperBlk* superblock = &superBlks[superblock_index];
+
+        // Link block to indexing policy
+        indexingPolicy->setEntry(superblock, superblock_index);
+
+        // Associate a replacement data entry to the superblock
+        superblock->replacementData = replacementPolicy->instantiateEntry();
+
+        // Set its blk size
+        superblock->setBlkSize(blkSize);
+
+        // Initialize all blocks in this superblock
+        superblock->blks.resize(numBlocksPerSector, nullptr);
+        for (unsigned k = 0; k < numBlocksPerSector; ++k){
+            // Select block within the superblock to be linked
+            SectorSubBlk*& blk = superblock->blks[k];
+
+            // Locate next cache block
+            blk = &blks[blk_index];
+
+            // Associate a data chunk to the block
+            blk->data = &dataBlks[blkSize*blk_index];
+
+            // Associate superblock to this block
+            blk->setSectorBlock(superblock);
+
+            // Associate the superblock replacement data to this block
+            blk->replacementData = superblock->replacementData;
+
+            // Set its index and sector offset
+            blk->setSectorOffset(k);
+
+            // Update block index
+            ++blk_index;
+        }
+    }
+}
+
+CacheBlk*
+CompressedTags::findVictim(Addr addr, const bool is_secure,
+                           const std::size_t compressed_size,
+                           std::vector<CacheBlk*>& evict_blks) const
+{
+    // Get all possible locations of this superblock
+    const std::vector<ReplaceableEntry*>& superblock_entries =
+        indexingPolicy->getPossibleEntries(addr);
+
+    // Check if the superblock this address belongs to has been allocated
+    const Addr tag = extractTag(addr);
+    const int offset = extractSectorOffset(addr);
+    SuperBlk* victim_superblock = nullptr;
+    for (const auto& entry : superblock_entries) {
+        SuperBlk* superblock = static_cast<SuperBlk*>(entry);
+        if ((tag == superblock->getTag()) && superblock->isValid() &&
+            (is_secure == superblock->isSecure())) {
+            victim_superblock = superblock;
+            break;
+        }
+    }
+
+    // Co-allocate if the superblock is present, all of its blocks are
+    // compressed, and the new block fits in its share of the data entry
+    if (victim_superblock != nullptr) {
+        // It would be a hit if victim was valid, and upgrades do not call
+        // findVictim, so it cannot happen
+        assert(!victim_superblock->blks[offset]->isValid());
+
+        if (victim_superblock->isCompressed() &&
+            victim_superblock->canCoAllocate(compressed_size)) {
+            return victim_superblock->blks[offset];
+        }
+
+        // Otherwise the present superblock is replaced, so that a tag is
+        // never held by more than one superblock of a set
+    } else {
+        // Choose replacement victim from replacement candidates
+        victim_superblock = static_cast<SuperBlk*>(
+            replacementPolicy->getVictim(superblock_entries));
+    }
+
+    // The whole superblock must be evicted to make room for the new one
+    for (const auto& blk : victim_superblock->blks) {
+        evict_blks.push_back(blk);
+    }
+
+    return victim_superblock->blks[offset];
+}
+
+void
+CompressedTags::insertBlock(const Addr addr, const bool is_secure,
+                            const int src_master_ID, const uint32_t task_ID,
+                            CacheBlk *blk)
+{
+    // A block inserted in a valid superblock has been co-allocated
+    if (static_cast<CompressionBlk*>(blk)->getSectorBlock()->isValid()) {
+        coAllocations++;
+    }
+
+    SectorTags::insertBlock(addr, is_secure, src_master_ID, task_ID, blk);
+}
+
+void
+CompressedTags::forEachBlk(std::function<void(CacheBlk &)> visitor)
+{
+    for (CompressionBlk& blk : blks) {
+        visitor(blk);
+    }
+}
+
+bool
+CompressedTags::anyBlk(std::function<bool(CacheBlk &)> visitor)
+{
+    for (CompressionBlk& blk : blks) {
+        if (visitor(blk)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void
+CompressedTags::regStats()
+{
+    SectorTags::regStats();
+
+    coAllocations
+        .name(name() + ".co_allocations")
+        .desc("Number of blocks allocated in an already valid superblock")
+        ;
+
+    validBlks
+        .name(name() + ".valid_blks")
+        .desc("Number of valid blocks")
+        ;
+
+    compressedBlks
+        .name(name() + ".compressed_blks")
+        .desc("Number of valid blocks stored compressed")
+        ;
+
+    validSuperBlks
+        .name(name() + ".valid_superblocks")
+        .desc("Number of valid superblocks")
+        ;
+
+    blksPerSuperBlk
+        .name(name() + ".blks_per_superblock")
+        .desc("Average number of valid blocks per valid superblock")
+        ;
+    blksPerSuperBlk = validBlks / validSuperBlks;
+}
+
+void
+CompressedTags::computeStats()
+{
+    SectorTags::computeStats();
+
+    validBlks = 0;
+    compressedBlks = 0;
+    validSuperBlks = 0;
+    for (const SuperBlk& superblock : superBlks) {
+        if (superblock.isValid()) {
+            validSuperBlks++;
+        }
+    }
+    for (const CompressionBlk& blk : blks) {
+        if (blk.isValid()) {
+            validBlks++;
+            if (blk.isCompressed()) {
+                compressedBlks++;
+            }
+        }
+    }
+}
+
+CompressedTags *
+CompressedTagsParams::create()
+{
+    // There must be a indexing policy
+    fatal_if(!indexing_policy, "An indexing policy is required");
+
+    return new CompressedTags(this);
+}
@@ -0,0 +1,168 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of a compressed set associative tag store using superblocks.
+ */
+
+#ifndef __MEM_CACHE_TAGS_COMPRESSED_TAGS_HH__
+#define __MEM_CACHE_TAGS_COMPRESSED_TAGS_HH__
+
+#include <vector>
+
+#include "base/statistics.hh"
+#include "mem/cache/tags/sector_tags.hh"
+#include "mem/cache/tags/super_blk.hh"
+#include "params/CompressedTags.hh"
+
+class BaseCache;
+
+/**
+ * A CompressedTags cache tag store.
+ * @sa  \ref gem5MemorySystem "gem5 Memory System"
+ *
+ * The Compression Ratio (CR) of a superblock is defined by
+ *     CR = uncompressed_size / compressed_size.
+ *
+ * The CompressedTags placement policy divides the cache into s sets of w
+ * superblocks (ways). Each superblock can then contain up to CR compressed
+ * blocks, which are contiguous in the address space and therefore share
+ * the superblock tag.
+ *
+ * For each tag entry there can be multiple data blocks. We have the same
+ * number of tags a conventional cache would have, but we instantiate the
+ * maximum number of data blocks (i.e., the number of tag entries * CR) per
+ * cache to implement the tag store. The data is always kept uncompressed;
+ * only the compressed sizes decide which blocks may share an entry.
+ */
+class CompressedTags : public SectorTags
+{
+  private:
+    /** The cache blocks. */
+    std::vector<CompressionBlk> blks;
+    /** The cache superblocks. */
+    std::vector<SuperBlk> superBlks;
+
+    /**
+     * @defgroup CompressedTagsStats Compressed tags statistics.
+     * @{
+     */
+
+    /** Number of blocks allocated in an already valid superblock. */
+    Stats::Scalar coAllocations;
+
+    /** Number of valid blocks, sampled when stats are dumped. */
+    Stats::Scalar validBlks;
+
+    /** Number of valid compressed blocks, sampled when stats are dumped. */
+    Stats::Scalar compressedBlks;
+
+    /** Number of valid superblocks, sampled when stats are dumped. */
+    Stats::Scalar validSuperBlks;
+
+    /** Average number of blocks per valid superblock. */
+    Stats::Formula blksPerSuperBlk;
+
+    /**
+     * @}
+     */
+
+  public:
+    /** Convenience typedef. */
+     typedef CompressedTagsParams Params;
+
+    /**
+     * Construct and initialize this tag store.
+     */
+    CompressedTags(const Params *p);
+
+    /**
+     * Destructor.
+     */
+    virtual ~CompressedTags() {};
+
+    /**
+     * Initialize blocks as SuperBlk and CompressionBlk instances.
+     */
+    void tagsInit() override;
+
+    /**
+     * Find replacement victim based on address. Checks if data can be
+     * co-allocated before choosing blocks to be evicted. A superblock can
+     * only be co-allocated if all of its valid blocks are compressed and
+     * the new block fits in its share of the data entry. Otherwise the
+     * whole superblock is replaced.
+     *
+     * @param addr Address to find a victim for.
+     * @param is_secure True if the target memory space is secure.
+     * @param compressed_size Size, in bits, of new block to allocate.
+     * @param evict_blks Cache blocks to be evicted.
+     * @return Cache block to be replaced.
+     */
+    CacheBlk* findVictim(Addr addr, const bool is_secure,
+                         const std::size_t compressed_size,
+                         std::vector<CacheBlk*>& evict_blks) const override;
+
+    /**
+     * Insert the new block into the cache and update replacement data.
+     * Keeps track of the blocks that are co-allocated.
+     *
+     * @param addr Address of the block.
+     * @param is_secure Whether the block is in secure space or not.
+     * @param src_master_ID The source requestor ID.
+     * @param task_ID The new task ID.
+     * @param blk The block to update.
+     */
+    void insertBlock(const Addr addr, const bool is_secure,
+                     const int src_master_ID, const uint32_t task_ID,
+                     CacheBlk *blk) override;
+
+    /**
+     * Visit each sub-block in the tags and apply a visitor.
+     *
+     * @param visitor Visitor to call on each block.
+     */
+    void forEachBlk(std::function<void(CacheBlk &)> visitor) override;
+
+    /**
+     * Find if any of the sub-blocks satisfies a condition.
+     *
+     * @param visitor Visitor to call on each block.
+     */
+    bool anyBlk(std::function<bool(CacheBlk &)> visitor) override;
+
+    /**
+     * Register local statistics.
+     */
+    void regStats() override;
+
+    /**
+     * Computes stats just prior to dump event.
+     */
+    void computeStats() override;
+};
+
+#endif //__MEM_CACHE_TAGS_COMPRESSED_TAGS_HH__
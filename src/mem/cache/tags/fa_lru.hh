@@ -218,10 +218,12 @@ class FALRU : public BaseTags
      *
      * @param addr Address to find a victim for.
      * @param is_secure True if the target memory space is secure.
+     * @param size Size, in bits, of the data to be allocated.
      * @param evict_blks Cache blocks to be evicted.
      * @return Cache block to be replaced.
      */
     CacheBlk* findVictim(Addr addr, const bool is_secure,
+                         const std::size_t size,
                          std::vector<CacheBlk*>& evict_blks) const override;
 
     /**
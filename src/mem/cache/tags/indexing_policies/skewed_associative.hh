@@ -137,6 +137,12 @@ class SkewedAssociative : public BaseIndexingPolicy
      */
     uint32_t extractSet(const Addr addr, const uint32_t way) const;
 
+    /**
+     * Entries selected by the last call to getPossibleEntries(). Kept
+     * around so that the lookup does not allocate a new vector.
+     */
+    mutable std::vector<ReplaceableEntry*> possibleEntries;
+
   public:
     /** Convenience typedef. */
      typedef SkewedAssociativeParams Params;
@@ -159,8 +165,8 @@ class SkewedAssociative : public BaseIndexingPolicy
      * @param addr The addr to a find possible entries for.
      * @return The possible entries.
      */
-    std::vector<ReplaceableEntry*> getPossibleEntries(const Addr addr) const
-                                                                   override;
+    const std::vector<ReplaceableEntry*>& getPossibleEntries(
+                                        const Addr addr) const override;
 
     /**
      * Regenerate an entry's address from its tag and assigned set and way.
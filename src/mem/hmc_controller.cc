@@ -1,14 +1,19 @@
 #include "mem/hmc_controller.hh"
 
+#include "base/cprintf.hh"
 #include "base/random.hh"
 #include "debug/HMCController.hh"
 
 HMCController::HMCController(const HMCControllerParams* p) :
     NoncoherentXBar(p),
     n_master_ports(p->port_master_connection_count),
-    rr_counter(0)
+    rr_counter(0),
+    num_vaults(p->num_vaults),
+    vault_size(p->vault_size)
 {
     assert(p->port_slave_connection_count == 1);
+    fatal_if(num_vaults == 0 || vault_size == 0,
+             "%s needs at least one vault of non-zero size\n", name());
 }
 
 HMCController*
@@ -39,6 +44,54 @@ int HMCController::rotate_counter()
     return current_value;
 }
 
+unsigned HMCController::vault_of(Addr addr) const
+{
+    return (addr / vault_size) % num_vaults;
+}
+
+void HMCController::regStats()
+{
+    NoncoherentXBar::regStats();
+
+    using namespace Stats;
+
+    vaultReqs
+        .init(num_vaults)
+        .name(name() + ".vault_reqs")
+        .desc("Requests forwarded per vault")
+        .flags(total | nozero | nonan);
+
+    vaultBytes
+        .init(num_vaults)
+        .name(name() + ".vault_bytes")
+        .desc("Data forwarded per vault (bytes)")
+        .flags(total | nozero | nonan);
+
+    vaultRefusals
+        .init(num_vaults)
+        .name(name() + ".vault_refusals")
+        .desc("Refusals per vault as the serial link was busy, "
+              "counting each retry of a request again")
+        .flags(total | nozero | nonan);
+
+    vaultLinkReqs
+        .init(num_vaults, masterPorts.size())
+        .name(name() + ".vault_link_reqs")
+        .desc("Requests forwarded per vault and serial link")
+        .flags(total | nozero | nonan);
+
+    for (unsigned i = 0; i < num_vaults; i++) {
+        const std::string vault = csprintf("vault%d", i);
+        vaultReqs.subname(i, vault);
+        vaultBytes.subname(i, vault);
+        vaultRefusals.subname(i, vault);
+        vaultLinkReqs.subname(i, vault);
+    }
+
+    for (int j = 0; j < masterPorts.size(); j++)
+        vaultLinkReqs.ysubname(j, masterPorts[j]->getSlavePort().name());
+}
+
 bool HMCController::recvTimingReq(PacketPtr pkt, PortID slave_port_id)
 {
     // determine the source port based on the id
@@ -50,12 +103,14 @@ bool HMCController::recvTimingReq(PacketPtr pkt, PortID slave_port_id)
     // For now, this is a simple round robin counter, for distribution the
     //  load among the serial links
     PortID master_port_id = rotate_counter();
+    unsigned vault = vault_of(pkt->getAddr());
 
     // test if the layer should be considered occupied for the current
     // port
     if (!reqLayers[master_port_id]->tryTiming(src_port)) {
         DPRINTF(HMCController, "recvTimingReq: src %s %s 0x%x BUSY\n",
                 src_port->name(), pkt->cmdString(), pkt->getAddr());
+        vaultRefusals[vault]++;
         return false;
     }
 
@@ -98,6 +153,7 @@ bool HMCController::recvTimingReq(PacketPtr pkt, PortID slave_port_id)
         reqLayers[master_port_id]->failedTiming(src_port,
                                                 clockEdge(Cycles(1)));
 
+        vaultRefusals[vault]++;
         return false;
     }
 
@@ -113,6 +169,9 @@ bool HMCController::recvTimingReq(PacketPtr pkt, PortID slave_port_id)
     pktCount[slave_port_id][master_port_id]++;
     pktSize[slave_port_id][master_port_id] += pkt_size;
     transDist[pkt_cmd]++;
+    vaultReqs[vault]++;
+    vaultBytes[vault] += pkt_size;
+    vaultLinkReqs[vault][master_port_id]++;
 
     return true;
 }
@@ -98,6 +98,28 @@ private:
      * @return the next value of the counter
      */
     int rotate_counter();
+
+    // Number of vaults in the cube, and the size of the contiguous
+    //  address chunk mapped to each of them
+    unsigned num_vaults;
+    Addr vault_size;
+
+    /**
+     * Function for finding the vault a request is destined to
+     * @return the vault index of the address
+     */
+    unsigned vault_of(Addr addr) const;
+
+    virtual void regStats();
+
+    // Per-vault scheduling stats: requests and bytes forwarded, refusals
+    //  because the selected link was busy (a request refused and retried
+    //  several times counts several times), and the distribution of the
+    //  requests of each vault over the serial links
+    Stats::Vector vaultReqs;
+    Stats::Vector vaultBytes;
+    Stats::Vector vaultRefusals;
+    Stats::Vector2d vaultLinkReqs;
 };
 
 #endif //__MEM_HMC_CONTROLLER_HH__
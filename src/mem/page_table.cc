@@ -37,6 +37,8 @@
  */
 #include "mem/page_table.hh"
 
+#include <algorithm>
+#include <iterator>
 #include <string>
 
 #include "base/compiler.hh"
@@ -45,6 +47,89 @@
 #include "sim/faults.hh"
 #include "sim/serialize.hh"
 
+void
+EmulationPageTable::flushTranslationCache()
+{
+    for (auto &t : translationCache)
+        t.valid = false;
+}
+
+EmulationPageTable::PTableItr
+EmulationPageTable::findExtent(Addr vaddr)
+{
+    auto it = pTable.upper_bound(vaddr);
+    if (it == pTable.begin())
+        return pTable.end();
+
+    --it;
+    if (vaddr - it->first >= it->second.size)
+        return pTable.end();
+
+    return it;
+}
+
+void
+EmulationPageTable::splitAt(Addr vaddr)
+{
+    auto it = findExtent(vaddr);
+    if (it == pTable.end() || it->first == vaddr)
+        return;
+
+    Addr offset = vaddr - it->first;
+    Extent &head = it->second;
+    pTable.emplace_hint(std::next(it), vaddr,
+        Extent{head.size - offset, head.paddr + offset, head.flags});
+    head.size = offset;
+}
+
+Addr
+EmulationPageTable::carve(Addr vaddr, Addr size,
+                          std::vector<std::pair<Addr, Extent>> *removed)
+{
+    splitAt(vaddr);
+    splitAt(vaddr + size);
+
+    Addr mapped = 0;
+    auto it = pTable.lower_bound(vaddr);
+    while (it != pTable.end() && it->first < vaddr + size) {
+        mapped += it->second.size;
+        if (removed)
+            removed->push_back(*it);
+        it = pTable.erase(it);
+    }
+
+    flushTranslationCache();
+    return mapped;
+}
+
+void
+EmulationPageTable::insertExtent(Addr vaddr, const Extent &extent)
+{
+    auto it = pTable.emplace(vaddr, extent).first;
+
+    // Merge with the following extent if this one continues into it
+    auto next = std::next(it);
+    if (next != pTable.end() && vaddr + extent.size == next->first &&
+        extent.paddr + extent.size == next->second.paddr &&
+        extent.flags == next->second.flags) {
+        it->second.size += next->second.size;
+        pTable.erase(next);
+    }
+
+    // And with the preceding one if it continues into this one
+    if (it != pTable.begin()) {
+        auto prev = std::prev(it);
+        if (prev->first + prev->second.size == vaddr &&
+            prev->second.paddr + prev->second.size == it->second.paddr &&
+            prev->second.flags == it->second.flags) {
+            prev->second.size += it->second.size;
+            pTable.erase(it);
+        }
+    }
+
+    flushTranslationCache();
+}
+
 void
 EmulationPageTable::map(Addr vaddr, Addr paddr, int64_t size, uint64_t flags)
 {
@@ -54,22 +139,24 @@ EmulationPageTable::map(Addr vaddr, Addr paddr, int64_t size, uint64_t flags)
 
     DPRINTF(MMU, "Allocating Page: %#x-%#x\n", vaddr, vaddr + size);
 
-    while (size > 0) {
-        auto it = pTable.find(vaddr);
-        if (it != pTable.end()) {
-            // already mapped
-            panic_if(!clobber,
-                     "EmulationPageTable::allocate: addr %#x already mapped",
-                     vaddr);
-            it->second = Entry(paddr, flags);
-        } else {
-            pTable.emplace(vaddr, Entry(paddr, flags));
-        }
+    if (size <= 0)
+        return;
 
-        size -= pageSize;
-        vaddr += pageSize;
-        paddr += pageSize;
+    // the region covers every page it touches
+    Addr len = roundUp(size, pageSize);
+
+    if (!clobber) {
+        auto it = pTable.lower_bound(vaddr);
+        auto prev = findExtent(vaddr);
+        panic_if(prev != pTable.end() ||
+                 (it != pTable.end() && it->first < vaddr + len),
+                 "EmulationPageTable::allocate: addr %#x already mapped",
+                 prev != pTable.end() ? vaddr : it->first);
+    } else {
+        carve(vaddr, len);
     }
+
+    insertExtent(vaddr, Extent{len, paddr, flags});
 }
 
 void
@@ -81,24 +168,27 @@ EmulationPageTable::remap(Addr vaddr, int64_t size, Addr new_vaddr)
     DPRINTF(MMU, "moving pages from vaddr %08p to %08p, size = %d\n", vaddr,
             new_vaddr, size);
 
-    while (size > 0) {
-        auto new_it M5_VAR_USED = pTable.find(new_vaddr);
-        auto old_it = pTable.find(vaddr);
-        assert(old_it != pTable.end() && new_it == pTable.end());
+    if (size <= 0)
+        return;
 
-        pTable.emplace(new_vaddr, old_it->second);
-        pTable.erase(old_it);
-        size -= pageSize;
-        vaddr += pageSize;
-        new_vaddr += pageSize;
-    }
+    Addr len = roundUp(size, pageSize);
+
+    std::vector<std::pair<Addr, Extent>> moved;
+    Addr mapped M5_VAR_USED = carve(vaddr, len, &moved);
+    assert(mapped == len && isUnmapped(new_vaddr, len));
+
+    for (const auto &extent : moved)
+        insertExtent(extent.first - vaddr + new_vaddr, extent.second);
 }
 
 void
 EmulationPageTable::getMappings(std::vector<std::pair<Addr, Addr>> *addr_maps)
 {
-    for (auto &iter : pTable)
-        addr_maps->push_back(std::make_pair(iter.first, iter.second.paddr));
+    for (auto &iter : pTable) {
+        for (Addr offset = 0; offset < iter.second.size; offset += pageSize)
+            addr_maps->push_back(std::make_pair(iter.first + offset,
+                                                iter.second.paddr + offset));
+    }
 }
 
 void
@@ -108,13 +198,12 @@ EmulationPageTable::unmap(Addr vaddr, int64_t size)
 
     DPRINTF(MMU, "Unmapping page: %#x-%#x\n", vaddr, vaddr + size);
 
-    while (size > 0) {
-        auto it = pTable.find(vaddr);
-        assert(it != pTable.end());
-        pTable.erase(it);
-        size -= pageSize;
-        vaddr += pageSize;
-    }
+    if (size <= 0)
+        return;
+
+    Addr len = roundUp(size, pageSize);
+    Addr mapped M5_VAR_USED = carve(vaddr, len);
+    assert(mapped == len);
 }
 
 bool
@@ -123,21 +212,36 @@ EmulationPageTable::isUnmapped(Addr vaddr, int64_t size)
     // starting address must be page aligned
     assert(pageOffset(vaddr) == 0);
 
-    for (int64_t offset = 0; offset < size; offset += pageSize)
-        if (pTable.find(vaddr + offset) != pTable.end())
-            return false;
+    if (size <= 0)
+        return true;
 
-    return true;
+    if (findExtent(vaddr) != pTable.end())
+        return false;
+
+    auto it = pTable.lower_bound(vaddr);
+    return it == pTable.end() || it->first >= vaddr + size;
 }
 
 const EmulationPageTable::Entry *
 EmulationPageTable::lookup(Addr vaddr)
 {
     Addr page_addr = pageAlign(vaddr);
-    PTableItr iter = pTable.find(page_addr);
-    if (iter == pTable.end())
-        return nullptr;
-    return &(iter->second);
+    CachedTranslation &cached = translationCache[
+        (page_addr / pageSize) % translationCache.size()];
+
+    if (!cached.valid || cached.vpage != page_addr) {
+        PTableItr iter = findExtent(page_addr);
+        if (iter == pTable.end())
+            return nullptr;
+
+        cached.vpage = page_addr;
+        cached.ppage = iter->second.paddr + (page_addr - iter->first);
+        cached.flags = iter->second.flags;
+        cached.valid = true;
+    }
+
+    lookupEntry = Entry(cached.ppage, cached.flags);
+    return &lookupEntry;
 }
 
 bool
@@ -169,6 +273,36 @@ EmulationPageTable::translate(const RequestPtr &req)
     return NoFault;
 }
 
+Addr
+EmulationPageTable::translateRange(Addr vaddr, Addr size,
+                                   std::vector<PhysExtent> &extents)
+{
+    Addr done = 0;
+
+    while (done < size) {
+        auto it = findExtent(vaddr + done);
+        if (it == pTable.end())
+            break;
+
+        Addr offset = vaddr + done - it->first;
+        Addr paddr = it->second.paddr + offset;
+        Addr len = std::min(it->second.size - offset, size - done);
+
+        if (!extents.empty() &&
+            extents.back().paddr + extents.back().size == paddr) {
+            extents.back().size += len;
+        } else {
+            extents.push_back({paddr, len});
+        }
+
+        done += len;
+    }
+
+    DPRINTF(MMU, "Translated range: %#x-%#x (%d bytes mapped)\n", vaddr,
+            vaddr + size, done);
+    return done;
+}
+
 void
 EmulationPageTable::serialize(CheckpointOut &cp) const
 {
@@ -181,6 +315,7 @@ EmulationPageTable::serialize(CheckpointOut &cp) const
         paramOut(cp, "vaddr", pte.first);
         paramOut(cp, "paddr", pte.second.paddr);
         paramOut(cp, "flags", pte.second.flags);
+        paramOut(cp, "size", pte.second.size);
     }
     assert(count == pTable.size());
 }
@@ -201,7 +336,11 @@ EmulationPageTable::unserialize(CheckpointIn &cp)
         UNSERIALIZE_SCALAR(paddr);
         UNSERIALIZE_SCALAR(flags);
 
-        pTable.emplace(vaddr, Entry(paddr, flags));
+        // checkpoints of the per-page table hold a page per entry
+        Addr size;
+        if (!optParamIn(cp, "size", size, false))
+            size = pageSize;
+
+        insertExtent(vaddr, Extent{size, paddr, flags});
     }
 }
-
@@ -37,8 +37,10 @@
 #ifndef __MEM_PAGE_TABLE_HH__
 #define __MEM_PAGE_TABLE_HH__
 
+#include <array>
+#include <map>
 #include <string>
-#include <unordered_map>
+#include <vector>
 
 #include "base/intmath.hh"
 #include "base/types.hh"
@@ -59,14 +61,91 @@ class EmulationPageTable : public Serializable
         Entry() {}
     };
 
+    /** A physically contiguous part of a virtual range */
+    struct PhysExtent
+    {
+        Addr paddr;
+        Addr size;
+    };
+
   protected:
-    typedef std::unordered_map<Addr, Entry> PTable;
+    /**
+     * A run of pages that is contiguous both virtually and physically
+     * and shares the same mapping flags.
+     */
+    struct Extent
+    {
+        Addr size;
+        Addr paddr;
+        uint64_t flags;
+    };
+
+    /**
+     * The extents of the page table, keyed by their virtual start
+     * address. Extents never overlap, and adjacent ones are merged
+     * when they continue each other, so that large mappings cost a
+     * single entry regardless of their number of pages.
+     */
+    typedef std::map<Addr, Extent> PTable;
     typedef PTable::iterator PTableItr;
     PTable pTable;
 
     const Addr pageSize;
     const Addr offsetMask;
 
+    /** A recently used translation of a single page */
+    struct CachedTranslation
+    {
+        Addr vpage;
+        Addr ppage;
+        uint64_t flags;
+        bool valid;
+    };
+
+    /**
+     * Direct-mapped cache of page translations, sparing the lookups of
+     * the pages in use the walk of the extent map. It is flushed on
+     * any change to the mappings.
+     */
+    std::array<CachedTranslation, 64> translationCache;
+
+    /** Entry handed out by lookup() */
+    Entry lookupEntry;
+
+    /**
+     * Find the extent containing an address.
+     *
+     * @param vaddr The virtual address.
+     * @return The extent, or the end of the table if vaddr is unmapped.
+     */
+    PTableItr findExtent(Addr vaddr);
+
+    /**
+     * Split the extent containing an address, if any, so that an
+     * extent starts at the address.
+     */
+    void splitAt(Addr vaddr);
+
+    /**
+     * Remove the mappings of a region, splitting the extents crossing
+     * its bounds.
+     *
+     * @param vaddr The page aligned start of the region.
+     * @param size The page aligned length of the region.
+     * @param removed If not null, set to the removed extents.
+     * @return The number of bytes of the region that were mapped.
+     */
+    Addr carve(Addr vaddr, Addr size,
+               std::vector<std::pair<Addr, Extent>> *removed = nullptr);
+
+    /**
+     * Insert an extent in an unmapped region, merging it with its
+     * neighbours when they continue each other.
+     */
+    void insertExtent(Addr vaddr, const Extent &extent);
+
+    void flushTranslationCache();
+
     const uint64_t _pid;
     const std::string _name;
 
@@ -78,6 +157,7 @@ class EmulationPageTable : public Serializable
             _pid(_pid), _name(__name)
     {
         assert(isPowerOf2(pageSize));
+        flushTranslationCache();
     }
 
     uint64_t pid() const { return _pid; };
@@ -127,7 +207,8 @@ class EmulationPageTable : public Serializable
     /**
      * Lookup function
      * @param vaddr The virtual address.
-     * @return The page table entry corresponding to vaddr.
+     * @return The page table entry corresponding to vaddr, which stays
+     *         valid until the next call to lookup.
      */
     const Entry *lookup(Addr vaddr);
 
@@ -153,6 +234,19 @@ class EmulationPageTable : public Serializable
      */
     Fault translate(const RequestPtr &req);
 
+    /**
+     * Translate a virtual range in one go, appending the physical
+     * extents backing it to a vector. Physically contiguous parts are
+     * merged, also with the last extent already in the vector.
+     * @param vaddr The virtual start address of the range.
+     * @param size The length of the range.
+     * @param extents Vector the physical extents are appended to.
+     * @return The number of bytes translated, less than size if the
+     *         range runs into an unmapped page.
+     */
+    Addr translateRange(Addr vaddr, Addr size,
+                        std::vector<PhysExtent> &extents);
+
     void getMappings(std::vector<std::pair<Addr, Addr>> *addr_mappings);
 
     void serialize(CheckpointOut &cp) const override;
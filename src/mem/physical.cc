@@ -238,6 +238,12 @@ PhysicalMemory::isMemAddr(Addr addr) const
     return addrMap.contains(addr) != addrMap.end();
 }
 
+bool
+PhysicalMemory::isMemRange(Addr addr, Addr size) const
+{
+    return addrMap.contains(RangeSize(addr, size)) != addrMap.end();
+}
+
 AddrRangeList
 PhysicalMemory::getConfAddrRanges() const
 {
@@ -294,6 +300,13 @@ PhysicalMemory::functionalAccess(PacketPtr pkt)
     m->second->functionalAccess(pkt);
 }
 
+void
+PhysicalMemory::addWriteObserver(MemWriteObserver *observer)
+{
+    for (auto *m : memories)
+        m->addWriteObserver(observer);
+}
+
 void
 PhysicalMemory::serialize(CheckpointOut &cp) const
 {
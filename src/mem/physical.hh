@@ -47,6 +47,7 @@
  * Forward declaration to avoid header dependencies.
  */
 class AbstractMemory;
+class MemWriteObserver;
 
 /**
  * A single entry for the backing store.
@@ -182,6 +183,16 @@ class PhysicalMemory : public Serializable
      */
     bool isMemAddr(Addr addr) const;
 
+    /**
+     * Check if a range of physical addresses is held by a single memory
+     * that is part of the global address map.
+     *
+     * @param addr Start of the range
+     * @param size Size of the range
+     * @return Whether the range corresponds to a single memory
+     */
+    bool isMemRange(Addr addr, Addr size) const;
+
     /**
      * Get the memory ranges for all memories that are to be reported
      * to the configuration table. The ranges are merged before they
@@ -233,6 +244,15 @@ class PhysicalMemory : public Serializable
      */
     void functionalAccess(PacketPtr pkt);
 
+    /**
+     * Register an observer of the writes to every memory that is part
+     * of the global address map.
+     *
+     * @param observer The write observer
+     * @sa AbstractMemory::addWriteObserver
+     */
+    void addWriteObserver(MemWriteObserver *observer);
+
     /**
      * Serialize all the memories in the system. This is independent
      * of the logical memory layout, and the serialization only sees
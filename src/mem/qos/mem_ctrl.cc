@@ -81,6 +81,51 @@ void
 MemCtrl::init()
 {
     AbstractMemory::init();
+
+    // All the masters are known by now, so size the per-master state
+    // once rather than growing it on the request path
+    resizeMasters(_system->maxMasters());
+}
+
+void
+MemCtrl::RequestTimes::push(Addr addr, Tick tick, uint64_t entries)
+{
+    if (count == ring.size()) {
+        // Unroll the ring into a buffer of twice the size
+        std::vector<Entry> grown(ring.size() * 2);
+        for (size_t i = 0; i < count; ++i)
+            grown[i] = ring[(head + i) & (ring.size() - 1)];
+        ring.swap(grown);
+        head = 0;
+    }
+
+    ring[(head + count) & (ring.size() - 1)] = Entry{addr, tick, entries};
+    ++count;
+}
+
+bool
+MemCtrl::RequestTimes::pop(Addr addr, Tick &tick)
+{
+    const size_t mask = ring.size() - 1;
+
+    for (size_t i = 0; i < count; ++i) {
+        Entry &entry = ring[(head + i) & mask];
+        if (entry.entries == 0 || entry.addr != addr)
+            continue;
+
+        tick = entry.tick;
+        --entry.entries;
+
+        // Retire the consumed requests at the head of the ring
+        while (count > 0 && ring[head].entries == 0) {
+            head = (head + 1) & mask;
+            --count;
+        }
+
+        return true;
+    }
+
+    return false;
 }
 
 void
@@ -95,7 +140,7 @@ MemCtrl::logRequest(BusState dir, MasterID m_id, uint8_t qos,
             "QoSMemCtrl::logRequest MASTER %s [id %d] address %d"
             " prio %d this master q packets %d"
             " - queue size %d - requested entries %d\n",
-            masters[m_id], m_id, addr, qos, packetPriorities[m_id][qos],
+            masterName(m_id), m_id, addr, qos, queuedEntries(m_id, qos),
             (dir == READ) ? readQueueSizes[qos]: writeQueueSizes[qos],
             entries);
 
@@ -107,19 +152,19 @@ MemCtrl::logRequest(BusState dir, MasterID m_id, uint8_t qos,
         totalWriteQueueSize += entries;
     }
 
-    packetPriorities[m_id][qos] += entries;
-    for (auto j = 0; j < entries; ++j) {
-        requestTimes[m_id][addr].push_back(curTick());
-    }
+    MasterState &master = masterStates[m_id];
+    queuedEntries(m_id, qos) += entries;
+    master.queued += entries;
+    master.requestTimes.push(addr, curTick(), entries);
 
     // Record statistics
     avgPriority[m_id].sample(qos);
 
     // Compute avg priority distance
 
-    for (uint8_t i = 0; i < packetPriorities[m_id].size(); ++i) {
-        uint8_t distance =
-            (abs(int(qos) - int(i))) * packetPriorities[m_id][i];
+    const uint64_t *queued = &queuedEntries(m_id, 0);
+    for (uint8_t i = 0; i < numPriorities(); ++i) {
+        uint8_t distance = (abs(int(qos) - int(i))) * queued[i];
 
         if (distance > 0) {
             avgPriorityDistance[m_id].sample(distance);
@@ -127,15 +172,14 @@ MemCtrl::logRequest(BusState dir, MasterID m_id, uint8_t qos,
                     "QoSMemCtrl::logRequest MASTER %s [id %d]"
                     " registering priority distance %d for priority %d"
                     " (packets %d)\n",
-                    masters[m_id], m_id, distance, i,
-                    packetPriorities[m_id][i]);
+                    masterName(m_id), m_id, distance, i, queued[i]);
         }
     }
 
     DPRINTF(QOS,
             "QoSMemCtrl::logRequest MASTER %s [id %d] prio %d "
             "this master q packets %d - new queue size %d\n",
-            masters[m_id], m_id, qos, packetPriorities[m_id][qos],
+            masterName(m_id), m_id, qos, queuedEntries(m_id, qos),
             (dir == READ) ? readQueueSizes[qos]: writeQueueSizes[qos]);
 
 }
@@ -151,7 +195,7 @@ MemCtrl::logResponse(BusState dir, MasterID m_id, uint8_t qos,
             "QoSMemCtrl::logResponse MASTER %s [id %d] address %d prio"
             " %d this master q packets %d"
             " - queue size %d - requested entries %d\n",
-            masters[m_id], m_id, addr, qos, packetPriorities[m_id][qos],
+            masterName(m_id), m_id, addr, qos, queuedEntries(m_id, qos),
             (dir == READ) ? readQueueSizes[qos]: writeQueueSizes[qos],
             entries);
 
@@ -163,28 +207,21 @@ MemCtrl::logResponse(BusState dir, MasterID m_id, uint8_t qos,
         totalWriteQueueSize -= entries;
     }
 
-    panic_if(packetPriorities[m_id][qos] == 0,
+    panic_if(queuedEntries(m_id, qos) == 0,
              "QoSMemCtrl::logResponse master %s negative packets for priority"
-             " %d", masters[m_id], qos);
+             " %d", masterName(m_id), qos);
 
-    packetPriorities[m_id][qos] -= entries;
+    MasterState &master = masterStates[m_id];
+    queuedEntries(m_id, qos) -= entries;
+    master.queued -= entries;
 
     for (auto j = 0; j < entries; ++j) {
-        auto it = requestTimes[m_id].find(addr);
-        panic_if(it == requestTimes[m_id].end(),
+        // Load and remove the request time
+        Tick requestTime;
+        panic_if(!master.requestTimes.pop(addr, requestTime),
                  "QoSMemCtrl::logResponse master %s unmatched response for"
-                 " address %d received", masters[m_id], addr);
-
-        // Load request time
-        uint64_t requestTime = it->second.front();
-
-        // Remove request entry
-        it->second.pop_front();
+                 " address %d received", masterName(m_id), addr);
 
-        // Remove whole address entry if last one
-        if (it->second.empty()) {
-            requestTimes[m_id].erase(it);
-        }
         // Compute latency
         double latency = (double) (curTick() + delay - requestTime)
                 / SimClock::Float::s;
@@ -205,7 +242,7 @@ MemCtrl::logResponse(BusState dir, MasterID m_id, uint8_t qos,
     DPRINTF(QOS,
             "QoSMemCtrl::logResponse MASTER %s [id %d] prio %d "
             "this master q packets %d - new queue size %d\n",
-            masters[m_id], m_id, qos, packetPriorities[m_id][qos],
+            masterName(m_id), m_id, qos, queuedEntries(m_id, qos),
             (dir == READ) ? readQueueSizes[qos]: writeQueueSizes[qos]);
 }
 
@@ -266,17 +303,31 @@ MemCtrl::selectNextBusState()
     return bus_state;
 }
 
+void
+MemCtrl::resizeMasters(size_t num_masters)
+{
+    if (num_masters > masterStates.size()) {
+        masterStates.resize(num_masters);
+        packetPriorities.resize(num_masters * numPriorities(), 0);
+    }
+}
+
 void
 MemCtrl::addMaster(MasterID m_id)
 {
     if (!hasMaster(m_id)) {
-        masters.emplace(m_id, _system->getMasterName(m_id));
-        packetPriorities[m_id].resize(numPriorities(), 0);
+        // Masters registered after init are still accepted
+        resizeMasters(m_id + 1);
+
+        MasterState &master = masterStates[m_id];
+        master.active = true;
+        master.name = _system->getMasterName(m_id);
+        activeMasters.push_back(m_id);
 
         DPRINTF(QOS,
                 "QoSMemCtrl::addMaster registering"
                 " Master %s [id %d]\n",
-                masters[m_id], m_id);
+                master.name, m_id);
     }
 }
 
@@ -44,9 +44,8 @@
 #include "params/QoSMemCtrl.hh"
 #include "sim/system.hh"
 
-#include <unordered_map>
+#include <string>
 #include <vector>
-#include <deque>
 
 #ifndef __MEM_QOS_MEM_CTRL_HH__
 #define __MEM_QOS_MEM_CTRL_HH__
@@ -86,15 +85,103 @@ class MemCtrl: public AbstractMemory
      */
     const bool qosSyncroScheduler;
 
-    /** Hash of master ID - master name */
-    std::unordered_map<MasterID, const std::string> masters;
+    /**
+     * Ring buffer of the requests of a master waiting for a response,
+     * in arrival order. A response consumes the oldest request to the
+     * same address, and as responses mostly come back in order the
+     * match is typically found at the head of the ring.
+     */
+    class RequestTimes
+    {
+      private:
+        /** An outstanding request and its arrival time */
+        struct Entry
+        {
+            Addr addr;
+            Tick tick;
+            /** Number of queue entries still waiting for a response */
+            uint64_t entries;
+        };
+
+        /** Ring storage, its size always being a power of 2 */
+        std::vector<Entry> ring;
+
+        /** Position of the oldest request in the ring */
+        size_t head;
+
+        /** Number of requests in the ring, including consumed ones */
+        size_t count;
+
+      public:
+        RequestTimes() : ring(16), head(0), count(0) {}
+
+        /**
+         * Record a request.
+         *
+         * @param addr request address
+         * @param tick arrival time of the request
+         * @param entries number of queue entries of the request
+         */
+        void push(Addr addr, Tick tick, uint64_t entries);
+
+        /**
+         * Consume one entry of the oldest request to an address.
+         *
+         * @param addr response address
+         * @param tick set to the arrival time of the matching request
+         * @return false if no request matches the address
+         */
+        bool pop(Addr addr, Tick &tick);
+    };
+
+    /** Bookkeeping of a master, indexed by master ID */
+    struct MasterState
+    {
+        MasterState() : active(false), queued(0) {}
+
+        /** Set once the controller receives traffic from the master */
+        bool active;
+
+        /** Master name, cached for debug output */
+        std::string name;
+
+        /** Number of entries queued over all priorities */
+        uint64_t queued;
 
-    /** Hash of masters - number of packets queued per priority */
-    std::unordered_map<MasterID, std::vector<uint64_t> > packetPriorities;
+        /** Outstanding requests and their arrival times */
+        RequestTimes requestTimes;
+    };
 
-    /** Hash of masters - address of request - queue of times of request */
-    std::unordered_map<MasterID,
-            std::unordered_map<uint64_t, std::deque<uint64_t>> > requestTimes;
+    /** Per-master state, sized to the system masters at init */
+    std::vector<MasterState> masterStates;
+
+    /** IDs of the masters that have sent traffic, in arrival order */
+    std::vector<MasterID> activeMasters;
+
+    /**
+     * Number of entries queued per master and priority, flattened as
+     * [master ID * number of priorities + priority]
+     */
+    std::vector<uint64_t> packetPriorities;
+
+    /**
+     * Get the number of entries a master has queued at a priority.
+     *
+     * @param m_id master id
+     * @param prio QoS priority
+     * @return reference to the counter
+     */
+    uint64_t& queuedEntries(MasterID m_id, uint8_t prio)
+    { return packetPriorities[m_id * _numPriorities + prio]; }
+
+    /**
+     * Get the name of a registered master.
+     *
+     * @param m_id master id
+     * @return the master name
+     */
+    const std::string& masterName(MasterID m_id) const
+    { return masterStates[m_id].name; }
 
     /**
      * Vector of QoS priorities/last service time. Refreshed at every
@@ -144,6 +231,14 @@ class MemCtrl: public AbstractMemory
     /** registers statistics */
     void regStats() override;
 
+    /**
+     * Size the per-master state for a number of masters, keeping the
+     * state of the ones already registered
+     *
+     * @param num_masters number of master IDs to hold
+     */
+    void resizeMasters(size_t num_masters);
+
     /**
      * Initializes dynamically counters and
      * statistics for a given Master
@@ -289,7 +384,7 @@ class MemCtrl: public AbstractMemory
      */
     bool hasMaster(MasterID m_id) const
     {
-        return masters.find(m_id) != masters.end();
+        return m_id < masterStates.size() && masterStates[m_id].active;
     }
 
     /**
@@ -349,7 +444,7 @@ MemCtrl::escalateQueues(Queues& queues, uint64_t queue_entry_size,
     auto it = queues[curr_prio].begin();
     while (it != queues[curr_prio].end()) {
         // No packets left to move
-        if (packetPriorities[m_id][curr_prio] == 0)
+        if (queuedEntries(m_id, curr_prio) == 0)
             break;
 
         auto pkt = *it;
@@ -370,24 +465,24 @@ MemCtrl::escalateQueues(Queues& queues, uint64_t queue_entry_size,
                     "packet addr %d size %d (p size %d) from priority %d "
                     "to priority %d - "
                     "this master packets %d (entries to move %d)\n",
-                    masters[m_id], m_id, pkt->getAddr(),
+                    masterName(m_id), m_id, pkt->getAddr(),
                     pkt->getSize(),
                     queue_entry_size, curr_prio, tgt_prio,
-                    packetPriorities[m_id][curr_prio], moved_entries);
+                    queuedEntries(m_id, curr_prio), moved_entries);
 
 
             if (pkt->isRead()) {
                 panic_if(readQueueSizes[curr_prio] < moved_entries,
                          "QoSMemCtrl::escalate master %s negative READ "
                          "packets for priority %d",
-                        masters[m_id], tgt_prio);
+                        masterName(m_id), tgt_prio);
                 readQueueSizes[curr_prio] -= moved_entries;
                 readQueueSizes[tgt_prio] += moved_entries;
             } else if (pkt->isWrite()) {
                 panic_if(writeQueueSizes[curr_prio] < moved_entries,
                          "QoSMemCtrl::escalate master %s negative WRITE "
                          "packets for priority %d",
-                        masters[m_id], tgt_prio);
+                        masterName(m_id), tgt_prio);
                 writeQueueSizes[curr_prio] -= moved_entries;
                 writeQueueSizes[tgt_prio] += moved_entries;
             }
@@ -399,13 +494,13 @@ MemCtrl::escalateQueues(Queues& queues, uint64_t queue_entry_size,
             // Erase element from source packet queue, this will
             // increment the iterator
             it = queues[curr_prio].erase(it);
-            panic_if(packetPriorities[m_id][curr_prio] < moved_entries,
+            panic_if(queuedEntries(m_id, curr_prio) < moved_entries,
                      "QoSMemCtrl::escalate master %s negative packets "
                      "for priority %d",
-                     masters[m_id], tgt_prio);
+                     masterName(m_id), tgt_prio);
 
-            packetPriorities[m_id][curr_prio] -= moved_entries;
-            packetPriorities[m_id][tgt_prio] += moved_entries;
+            queuedEntries(m_id, curr_prio) -= moved_entries;
+            queuedEntries(m_id, tgt_prio) += moved_entries;
         } else {
             // Increment iterator to next location in the queue
             it++;
@@ -425,23 +520,32 @@ MemCtrl::escalate(std::initializer_list<Queues*> queues,
 
     DPRINTF(QOS,
             "QoSMemCtrl::escalate Master %s [id %d] to priority "
-            "%d (currently %d packets)\n",masters[m_id], m_id, tgt_prio,
-            packetPriorities[m_id][tgt_prio]);
+            "%d (currently %d packets)\n", masterName(m_id), m_id, tgt_prio,
+            queuedEntries(m_id, tgt_prio));
+
+    // Nothing to move if all the packets of the master are already
+    // at the target priority, which is the common case when the
+    // policy keeps assigning the same priority to a master
+    uint64_t to_move =
+        masterStates[m_id].queued - queuedEntries(m_id, tgt_prio);
 
-    for (uint8_t curr_prio = 0; curr_prio < numPriorities(); ++curr_prio) {
+    for (uint8_t curr_prio = 0;
+         to_move > 0 && curr_prio < numPriorities(); ++curr_prio) {
         // Skip target priority
         if (curr_prio == tgt_prio)
             continue;
 
+        to_move -= queuedEntries(m_id, curr_prio);
+
         // Process other priority packet
-        while (packetPriorities[m_id][curr_prio] > 0) {
+        while (queuedEntries(m_id, curr_prio) > 0) {
             DPRINTF(QOS,
                     "QoSMemCtrl::escalate MID %d checking priority %d "
                     "(packets %d)- current packets in prio %d:  %d\n"
                     "\t(source read %d source write %d target read %d, "
                     "target write %d)\n",
-                    m_id, curr_prio, packetPriorities[m_id][curr_prio],
-                    tgt_prio, packetPriorities[m_id][tgt_prio],
+                    m_id, curr_prio, queuedEntries(m_id, curr_prio),
+                    tgt_prio, queuedEntries(m_id, tgt_prio),
                     readQueueSizes[curr_prio],
                     writeQueueSizes[curr_prio], readQueueSizes[tgt_prio],
                     writeQueueSizes[tgt_prio]);
@@ -457,7 +561,7 @@ MemCtrl::escalate(std::initializer_list<Queues*> queues,
     DPRINTF(QOS,
             "QoSMemCtrl::escalate Completed master %s [id %d] to priority %d "
             "(now %d packets)\n\t(total read %d, total write %d)\n",
-            masters[m_id], m_id, tgt_prio, packetPriorities[m_id][tgt_prio],
+            masterName(m_id), m_id, tgt_prio, queuedEntries(m_id, tgt_prio),
             readQueueSizes[tgt_prio], writeQueueSizes[tgt_prio]);
 }
 
@@ -476,20 +580,20 @@ MemCtrl::qosSchedule(std::initializer_list<Queues*> queues,
 
     if (qosSyncroScheduler) {
         // Call the scheduling function on all other masters.
-        for (const auto& m : masters) {
+        for (size_t i = 0; i < activeMasters.size(); ++i) {
+            const MasterID m_id = activeMasters[i];
 
-            if (m.first == pkt->masterId())
+            if (m_id == pkt->masterId())
                 continue;
 
-            uint8_t prio = schedule(m.first, 0);
+            uint8_t prio = schedule(m_id, 0);
 
             if (qosPriorityEscalation) {
                 DPRINTF(QOS,
                         "QoSMemCtrl::qosSchedule: (syncro) escalating "
                         "MASTER %s to assigned priority %d\n",
-                        _system->getMasterName(m.first),
-                        prio);
-                escalate(queues, queue_entry_size, m.first, prio);
+                        masterName(m_id), prio);
+                escalate(queues, queue_entry_size, m_id, prio);
             }
         }
     }
@@ -43,6 +43,8 @@
 #endif // X86_ISA
 #include "mem/ruby/system/GPUCoalescer.hh"
 
+#include <algorithm>
+
 #include "cpu/testers/rubytest/RubyTester.hh"
 #include "debug/GPUCoalescer.hh"
 #include "debug/MemoryAccess.hh"
@@ -128,6 +130,9 @@ GPUCoalescer::GPUCoalescer(const Params *p)
 
     m_outstanding_count = 0;
 
+    lastCoalescedLine = 0;
+    lastCoalescedReqs = nullptr;
+
     m_max_outstanding_requests = 0;
     m_deadlock_threshold = 0;
     m_instCache_ptr = nullptr;
@@ -625,11 +630,16 @@ GPUCoalescer::hitCallback(GPUCoalescerRequest* srequest,
     // update the data
     //
     // MUST AD DOING THIS FOR EACH REQUEST IN COALESCER
-    int len = reqCoalescer[request_line_address].size();
+    CoalescingTable::iterator coalesced =
+        reqCoalescer.find(request_line_address);
+    assert(coalesced != reqCoalescer.end());
+    const std::vector<RequestDesc> &reqs = coalesced->second;
+    int len = reqs.size();
     std::vector<PacketPtr> mylist;
+    mylist.reserve(len);
     for (int i = 0; i < len; ++i) {
-        PacketPtr pkt = reqCoalescer[request_line_address][i].pkt;
-        assert(type == reqCoalescer[request_line_address][i].primaryType);
+        PacketPtr pkt = reqs[i].pkt;
+        assert(type == reqs[i].primaryType);
         request_address = pkt->getAddr();
         request_line_address = makeLineAddress(pkt->getAddr());
         if (pkt->getPtr<uint8_t>()) {
@@ -669,12 +679,32 @@ GPUCoalescer::hitCallback(GPUCoalescerRequest* srequest,
         mylist.push_back(pkt);
     }
     delete srequest;
-    reqCoalescer.erase(request_line_address);
-    assert(!reqCoalescer.count(request_line_address));
+    eraseCoalescedReqs(coalesced);
 
+    completeHitCallback(mylist, len);
+}
 
+std::vector<RequestDesc> *
+GPUCoalescer::findCoalescedReqs(Addr line_addr)
+{
+    if (lastCoalescedReqs && lastCoalescedLine == line_addr)
+        return lastCoalescedReqs;
 
-    completeHitCallback(mylist, len);
+    CoalescingTable::iterator it = reqCoalescer.find(line_addr);
+    if (it == reqCoalescer.end())
+        return nullptr;
+
+    lastCoalescedLine = line_addr;
+    lastCoalescedReqs = &it->second;
+    return lastCoalescedReqs;
+}
+
+void
+GPUCoalescer::eraseCoalescedReqs(CoalescingTable::iterator it)
+{
+    if (lastCoalescedReqs == &it->second)
+        lastCoalescedReqs = nullptr;
+    reqCoalescer.erase(it);
 }
 
 bool
@@ -837,33 +867,36 @@ GPUCoalescer::makeRequest(PacketPtr pkt)
 
     // Check if this request can be coalesced with previous
     // requests from this cycle.
-    if (!reqCoalescer.count(line_addr)) {
+    std::vector<RequestDesc> *reqs = findCoalescedReqs(line_addr);
+    if (!reqs) {
         // This is the first access to this cache line.
         // A new request to the memory subsystem has to be
         // made in the next cycle for this cache line, so
         // add this line addr to the "newRequests" queue
         newRequests.push_back(line_addr);
+        reqs = &reqCoalescer[line_addr];
+        lastCoalescedLine = line_addr;
+        lastCoalescedReqs = reqs;
 
     // There was a request to this cache line in this cycle,
     // let us see if we can coalesce this request with the previous
     // requests from this cycle
-    } else if (primary_type !=
-               reqCoalescer[line_addr][0].primaryType) {
+    } else if (primary_type != reqs->front().primaryType) {
         // can't coalesce loads, stores and atomics!
         return RequestStatus_Aliased;
     } else if (pkt->req->isLockedRMW() ||
-               reqCoalescer[line_addr][0].pkt->req->isLockedRMW()) {
+               reqs->front().pkt->req->isLockedRMW()) {
         // can't coalesce locked accesses, but can coalesce atomics!
         return RequestStatus_Aliased;
     } else if (pkt->req->hasContextId() && pkt->req->isRelease() &&
                pkt->req->contextId() !=
-               reqCoalescer[line_addr][0].pkt->req->contextId()) {
+               reqs->front().pkt->req->contextId()) {
         // can't coalesce releases from different wavefronts
         return RequestStatus_Aliased;
     }
 
     // in addition to the packet, we need to save both request types
-    reqCoalescer[line_addr].emplace_back(pkt, primary_type, secondary_type);
+    reqs->emplace_back(pkt, primary_type, secondary_type);
     if (!issueEvent.scheduled())
         schedule(issueEvent, curTick());
     // TODO: issue hardware prefetches here
@@ -905,9 +938,10 @@ GPUCoalescer::issueRequest(PacketPtr pkt, RubyRequestType secondary_type)
     uint32_t blockSize = RubySystem::getBlockSizeBytes();
     std::vector<bool> accessMask(blockSize,false);
     std::vector< std::pair<int,AtomicOpFunctor*> > atomicOps;
-    uint32_t tableSize = reqCoalescer[line_addr].size();
+    const std::vector<RequestDesc> &reqs = *findCoalescedReqs(line_addr);
+    uint32_t tableSize = reqs.size();
     for (int i = 0; i < tableSize; i++) {
-        PacketPtr tmpPkt = reqCoalescer[line_addr][i].pkt;
+        PacketPtr tmpPkt = reqs[i].pkt;
         uint32_t tmpOffset = (tmpPkt->getAddr()) - line_addr;
         uint32_t tmpSize = tmpPkt->getSize();
         if (tmpPkt->isAtomicOp()) {
@@ -918,9 +952,8 @@ GPUCoalescer::issueRequest(PacketPtr pkt, RubyRequestType secondary_type)
             dataBlock.setData(tmpPkt->getPtr<uint8_t>(),
                               tmpOffset, tmpSize);
         }
-        for (int j = 0; j < tmpSize; j++) {
-            accessMask[tmpOffset + j] = true;
-        }
+        std::fill(accessMask.begin() + tmpOffset,
+                  accessMask.begin() + tmpOffset + tmpSize, true);
     }
     std::shared_ptr<RubyRequest> msg;
     if (pkt->isAtomicOp()) {
@@ -1011,8 +1044,13 @@ GPUCoalescer::completeIssue()
         // first request for each cacheline, the remaining requests
         // can be coalesced with the first request. So, only
         // one request is issued per cacheline.
-        RequestDesc info = reqCoalescer[newRequests[i]][0];
+        const std::vector<RequestDesc> &reqs =
+            *findCoalescedReqs(newRequests[i]);
+        RequestDesc info = reqs.front();
         PacketPtr pkt = info.pkt;
+        coalescedAccesses += reqs.size();
+        issuedLineRequests++;
+        accessesPerLineHist.sample(reqs.size());
         DPRINTF(GPUCoalescer, "Completing for newReq %d: paddr %#x\n",
                 i, pkt->req->getPaddr());
         // Insert this request to the read/writeRequestTables. These tables
@@ -1084,14 +1122,17 @@ GPUCoalescer::atomicCallback(Addr address,
     Addr request_address = pkt->getAddr();
     Addr request_line_address = makeLineAddress(pkt->getAddr());
 
-    int len = reqCoalescer[request_line_address].size();
+    CoalescingTable::iterator coalesced =
+        reqCoalescer.find(request_line_address);
+    assert(coalesced != reqCoalescer.end());
+    const std::vector<RequestDesc> &reqs = coalesced->second;
+    int len = reqs.size();
     std::vector<PacketPtr> mylist;
+    mylist.reserve(len);
     for (int i = 0; i < len; ++i) {
-        PacketPtr pkt = reqCoalescer[request_line_address][i].pkt;
-        assert(srequest->m_type ==
-               reqCoalescer[request_line_address][i].primaryType);
+        PacketPtr pkt = reqs[i].pkt;
+        assert(srequest->m_type == reqs[i].primaryType);
         request_address = (pkt->getAddr());
-        request_line_address = makeLineAddress(request_address);
         if (pkt->getPtr<uint8_t>() &&
             srequest->m_type != RubyRequestType_ATOMIC_NO_RETURN) {
             /* atomics are done in memory, and return the data *before* the atomic op... */
@@ -1120,8 +1161,7 @@ GPUCoalescer::atomicCallback(Addr address,
         mylist.push_back(pkt);
     }
     delete srequest;
-    reqCoalescer.erase(request_line_address);
-    assert(!reqCoalescer.count(request_line_address));
+    eraseCoalescedReqs(coalesced);
 
     completeHitCallback(mylist, len);
 }
@@ -1374,4 +1414,26 @@ GPUCoalescer::regStats()
         .name(name() + ".cp_st_misses")
         .desc("stores that miss in the GPU")
         ;
+
+    // coalescing efficiency
+    coalescedAccesses
+        .name(name() + ".coalesced_accesses")
+        .desc("accesses merged into line requests")
+        ;
+    issuedLineRequests
+        .name(name() + ".issued_line_requests")
+        .desc("line requests issued to the memory system")
+        ;
+    accessesPerLineRequest
+        .name(name() + ".accesses_per_line_request")
+        .desc("average number of accesses coalesced into a line request")
+        .precision(2)
+        ;
+    accessesPerLineRequest = coalescedAccesses / issuedLineRequests;
+    accessesPerLineHist
+        .init(16)
+        .name(name() + ".accesses_per_line_hist")
+        .desc("histogram of the accesses coalesced into a line request")
+        .flags(Stats::nozero)
+        ;
 }
@@ -279,6 +279,16 @@ class GPUCoalescer : public RubyPort
     CoalescingTable reqCoalescer;
     std::vector<Addr> newRequests;
 
+    // The lanes of a vector access arrive one after the other and
+    // mostly fall in the same few lines, so remember the entry of the
+    // last line looked up. Elements of an unordered_map do not move
+    // on rehash, only erasing the line invalidates it.
+    Addr lastCoalescedLine;
+    std::vector<RequestDesc> *lastCoalescedReqs;
+
+    std::vector<RequestDesc> *findCoalescedReqs(Addr line_addr);
+    void eraseCoalescedReqs(CoalescingTable::iterator it);
+
     typedef std::unordered_map<Addr, GPUCoalescerRequest*> RequestTable;
     RequestTable m_writeRequestTable;
     RequestTable m_readRequestTable;
@@ -319,6 +329,12 @@ class GPUCoalescer : public RubyPort
     Stats::Scalar CP_TCCStHits;
     Stats::Scalar CP_StMiss;
 
+    // coalescing efficiency
+    Stats::Scalar coalescedAccesses;
+    Stats::Scalar issuedLineRequests;
+    Stats::Formula accessesPerLineRequest;
+    Stats::Histogram accessesPerLineHist;
+
     //! Histogram for number of outstanding requests per cycle.
     Stats::Histogram m_outstandReqHist;
 
@@ -44,12 +44,15 @@
 
 #include "mem/se_translating_port_proxy.hh"
 
+#include <algorithm>
+#include <cstring>
 #include <string>
 
 #include "arch/isa_traits.hh"
-#include "base/chunk_generator.hh"
 #include "config/the_isa.hh"
+#include "mem/packet.hh"
 #include "mem/page_table.hh"
+#include "mem/physical.hh"
 #include "sim/process.hh"
 #include "sim/system.hh"
 
@@ -65,18 +68,125 @@ SETranslatingPortProxy::~SETranslatingPortProxy()
 { }
 
 bool
-SETranslatingPortProxy::tryReadBlob(Addr addr, uint8_t *p, int size) const
+SETranslatingPortProxy::translateRange(Addr addr, int size, AllocType alloc,
+                                       std::vector<PhysRun> &runs) const
 {
-    int prevSize = 0;
+    runs.clear();
 
-    for (ChunkGenerator gen(addr, size, PageBytes); !gen.done(); gen.next()) {
-        Addr paddr;
+    while (size > 0) {
+        // translate as much as is mapped in one go
+        Addr done = pTable->translateRange(addr, size, runs);
+        addr += done;
+        size -= done;
+
+        if (size == 0)
+            break;
+
+        // addr is now the start of an unmapped page
+        if (alloc == Always) {
+            process->allocateMem(roundDown(addr, PageBytes), PageBytes);
+        } else if (alloc == NextPage) {
+            // check if we've accessed the next page on the stack
+            if (!process->fixupStackFault(addr))
+                panic("Page table fault when accessing virtual address "
+                      "%#x during functional write\n", addr);
+        } else {
+            return false;
+        }
+    }
+
+    return true;
+}
 
-        if (!pTable->translate(gen.addr(),paddr))
+bool
+SETranslatingPortProxy::translateIov(const std::vector<IoVec> &iov,
+                                     AllocType alloc,
+                                     std::vector<PhysRun> &runs) const
+{
+    runs.clear();
+
+    std::vector<PhysRun> vec_runs;
+    for (const auto &vec : iov) {
+        if (!translateRange(vec.base, vec.len, alloc, vec_runs))
             return false;
 
-        PortProxy::readBlobPhys(paddr, 0, p + prevSize, gen.size());
-        prevSize += gen.size();
+        for (const auto &run : vec_runs) {
+            if (!runs.empty() &&
+                runs.back().paddr + runs.back().size == run.paddr) {
+                runs.back().size += run.size;
+            } else {
+                runs.push_back(run);
+            }
+        }
+    }
+
+    return true;
+}
+
+bool
+SETranslatingPortProxy::isDirect(Addr paddr, int size) const
+{
+    // Caches are only bypassed in atomic mode, where nothing is in flight
+    // either, so the memories are the only ones holding the data. The
+    // run must then be held by a single memory to be accessed directly.
+    System *system = process->system;
+    return system->bypassCaches() &&
+        system->getPhysMem().isMemRange(paddr, size);
+}
+
+void
+SETranslatingPortProxy::accessDirect(MemCmd cmd, Addr paddr, uint8_t *p,
+                                     int size) const
+{
+    auto req = std::make_shared<Request>(paddr, size, 0,
+                                         Request::funcMasterId);
+    Packet pkt(req, cmd);
+    pkt.dataStatic(p);
+    process->system->getPhysMem().functionalAccess(&pkt);
+}
+
+void
+SETranslatingPortProxy::readPhys(Addr paddr, uint8_t *p, int size) const
+{
+    if (isDirect(paddr, size))
+        accessDirect(MemCmd::ReadReq, paddr, p, size);
+    else
+        PortProxy::readBlobPhys(paddr, 0, p, size);
+}
+
+void
+SETranslatingPortProxy::writePhys(Addr paddr, const uint8_t *p,
+                                  int size) const
+{
+    // The memory only reads the data of a write
+    if (isDirect(paddr, size))
+        accessDirect(MemCmd::WriteReq, paddr, const_cast<uint8_t *>(p),
+                     size);
+    else
+        PortProxy::writeBlobPhys(paddr, 0, p, size);
+}
+
+void
+SETranslatingPortProxy::memsetPhys(Addr paddr, uint8_t val, int size) const
+{
+    if (isDirect(paddr, size)) {
+        std::vector<uint8_t> buf(size, val);
+        accessDirect(MemCmd::WriteReq, paddr, buf.data(), size);
+    } else {
+        PortProxy::memsetBlobPhys(paddr, 0, val, size);
+    }
+}
+
+bool
+SETranslatingPortProxy::tryReadBlob(Addr addr, uint8_t *p, int size) const
+{
+    std::vector<PhysRun> runs;
+    if (!translateRange(addr, size, Never, runs))
+        return false;
+
+    for (const auto &run : runs) {
+        readPhys(run.paddr, p, run.size);
+        p += run.size;
     }
 
     return true;
@@ -94,28 +204,13 @@ bool
 SETranslatingPortProxy::tryWriteBlob(Addr addr, const uint8_t *p,
                                      int size) const
 {
-    int prevSize = 0;
-
-    for (ChunkGenerator gen(addr, size, PageBytes); !gen.done(); gen.next()) {
-        Addr paddr;
+    std::vector<PhysRun> runs;
+    if (!translateRange(addr, size, allocating, runs))
+        return false;
 
-        if (!pTable->translate(gen.addr(), paddr)) {
-            if (allocating == Always) {
-                process->allocateMem(roundDown(gen.addr(), PageBytes),
-                                     PageBytes);
-            } else if (allocating == NextPage) {
-                // check if we've accessed the next page on the stack
-                if (!process->fixupStackFault(gen.addr()))
-                    panic("Page table fault when accessing virtual address %#x "
-                            "during functional write\n", gen.addr());
-            } else {
-                return false;
-            }
-            pTable->translate(gen.addr(), paddr);
-        }
-
-        PortProxy::writeBlobPhys(paddr, 0, p + prevSize, gen.size());
-        prevSize += gen.size();
+    for (const auto &run : runs) {
+        writePhys(run.paddr, p, run.size);
+        p += run.size;
     }
 
     return true;
@@ -132,22 +227,16 @@ SETranslatingPortProxy::writeBlob(Addr addr, const uint8_t *p, int size) const
 bool
 SETranslatingPortProxy::tryMemsetBlob(Addr addr, uint8_t val, int size) const
 {
-    for (ChunkGenerator gen(addr, size, PageBytes); !gen.done(); gen.next()) {
-        Addr paddr;
-
-        if (!pTable->translate(gen.addr(), paddr)) {
-            if (allocating == Always) {
-                process->allocateMem(roundDown(gen.addr(), PageBytes),
-                                     PageBytes);
-                pTable->translate(gen.addr(), paddr);
-            } else {
-                return false;
-            }
-        }
-
-        PortProxy::memsetBlobPhys(paddr, 0, val, gen.size());
+    // Only allocate the pages that are missing when always allowed to
+    std::vector<PhysRun> runs;
+    if (!translateRange(addr, size, allocating == Always ? Always : Never,
+                        runs)) {
+        return false;
     }
 
+    for (const auto &run : runs)
+        memsetPhys(run.paddr, val, run.size);
+
     return true;
 }
 
@@ -162,19 +251,17 @@ SETranslatingPortProxy::memsetBlob(Addr addr, uint8_t val, int size) const
 bool
 SETranslatingPortProxy::tryWriteString(Addr addr, const char *str) const
 {
-    uint8_t c;
+    int size = std::strlen(str) + 1;
 
-    Addr vaddr = addr;
-
-    do {
-        c = *str++;
-        Addr paddr;
-
-        if (!pTable->translate(vaddr++, paddr))
-            return false;
+    std::vector<PhysRun> runs;
+    if (!translateRange(addr, size, Never, runs))
+        return false;
 
-        PortProxy::writeBlob(paddr, &c, 1);
-    } while (c);
+    const uint8_t *p = (const uint8_t *)str;
+    for (const auto &run : runs) {
+        writePhys(run.paddr, p, run.size);
+        p += run.size;
+    }
 
     return true;
 }
@@ -189,21 +276,30 @@ SETranslatingPortProxy::writeString(Addr addr, const char *str) const
 bool
 SETranslatingPortProxy::tryReadString(std::string &str, Addr addr) const
 {
-    uint8_t c;
+    // Read a cache line at a time, which never crosses a page, until
+    // the terminating null character shows up.
+    const unsigned line_size = process->system->cacheLineSize();
+    std::vector<uint8_t> buf(line_size);
 
     Addr vaddr = addr;
 
     while (true) {
         Addr paddr;
 
-        if (!pTable->translate(vaddr++, paddr))
+        if (!pTable->translate(vaddr, paddr))
             return false;
 
-        PortProxy::readBlob(paddr, &c, 1);
-        if (c == '\0')
+        int size = line_size - (vaddr % line_size);
+        readPhys(paddr, buf.data(), size);
+
+        const uint8_t *end = (const uint8_t *)std::memchr(buf.data(), 0, size);
+        if (end) {
+            str.append((const char *)buf.data(), end - buf.data());
             break;
+        }
 
-        str += c;
+        str.append((const char *)buf.data(), size);
+        vaddr += size;
     }
 
     return true;
@@ -216,3 +312,43 @@ SETranslatingPortProxy::readString(std::string &str, Addr addr) const
         fatal("readString(0x%x, ...) failed", addr);
 }
 
+bool
+SETranslatingPortProxy::tryReadv(const std::vector<IoVec> &iov,
+                                 uint8_t *p) const
+{
+    std::vector<PhysRun> runs;
+    if (!translateIov(iov, Never, runs))
+        return false;
+
+    for (const auto &run : runs) {
+        readPhys(run.paddr, p, run.size);
+        p += run.size;
+    }
+
+    return true;
+}
+
+bool
+SETranslatingPortProxy::tryWritev(const std::vector<IoVec> &iov,
+                                  const uint8_t *p, int size) const
+{
+    // Only the buffers, or the part of them, that size covers
+    std::vector<IoVec> used;
+    for (const auto &vec : iov) {
+        if (size <= 0)
+            break;
+        used.push_back({vec.base, std::min(vec.len, size)});
+        size -= used.back().len;
+    }
+
+    std::vector<PhysRun> runs;
+    if (!translateIov(used, allocating, runs))
+        return false;
+
+    for (const auto &run : runs) {
+        writePhys(run.paddr, p, run.size);
+        p += run.size;
+    }
+
+    return true;
+}
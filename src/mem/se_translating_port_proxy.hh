@@ -45,9 +45,11 @@
 #ifndef __MEM_SE_TRANSLATING_PORT_PROXY_HH__
 #define __MEM_SE_TRANSLATING_PORT_PROXY_HH__
 
+#include <vector>
+
+#include "mem/page_table.hh"
 #include "mem/port_proxy.hh"
 
-class EmulationPageTable;
 class Process;
 
 /**
@@ -74,11 +76,62 @@ class SETranslatingPortProxy : public PortProxy
         NextPage
     };
 
+    /** A buffer in the virtual address space, as in an iovec. */
+    struct IoVec
+    {
+        Addr base;
+        int len;
+    };
+
   private:
     EmulationPageTable *pTable;
     Process *process;
     AllocType allocating;
 
+    /** A physically contiguous part of a virtual range. */
+    typedef EmulationPageTable::PhysExtent PhysRun;
+
+    /**
+     * Translate a whole virtual range before any of it is accessed,
+     * merging the pages that are physically contiguous.
+     *
+     * @param addr Virtual start address of the range.
+     * @param size Size of the range, in bytes.
+     * @param alloc How to handle the pages that are not mapped.
+     * @param runs Set to the physical runs making up the range.
+     * @return false if a page is not mapped and could not be allocated.
+     */
+    bool translateRange(Addr addr, int size, AllocType alloc,
+                        std::vector<PhysRun> &runs) const;
+
+    /**
+     * Translate a list of virtual buffers, merging the runs of
+     * consecutive buffers which are physically contiguous.
+     */
+    bool translateIov(const std::vector<IoVec> &iov, AllocType alloc,
+                      std::vector<PhysRun> &runs) const;
+
+    /**
+     * Whether a physical range can be accessed in the backing store
+     * directly, bypassing the memory system. Only while the system
+     * bypasses caches, so no cache can hold the data.
+     */
+    bool isDirect(Addr paddr, int size) const;
+
+    /** Access a physical range directly in the memory holding it. */
+    void accessDirect(MemCmd cmd, Addr paddr, uint8_t *p, int size) const;
+
+    /**
+     * @{
+     * Access a physical range with functional accesses, so that caches
+     * and packets in flight in the memory system are observed, or
+     * directly when no cache can hold the data.
+     */
+    void readPhys(Addr paddr, uint8_t *p, int size) const;
+    void writePhys(Addr paddr, const uint8_t *p, int size) const;
+    void memsetPhys(Addr paddr, uint8_t val, int size) const;
+    /** @} */
+
   public:
     SETranslatingPortProxy(MasterPort& port, Process* p, AllocType alloc);
     ~SETranslatingPortProxy();
@@ -91,6 +144,18 @@ class SETranslatingPortProxy : public PortProxy
     bool tryWriteString(Addr addr, const char *str) const;
     bool tryReadString(std::string &str, Addr addr) const;
 
+    /**
+     * Gather the virtual buffers of iov into p, which must hold the sum
+     * of their lengths.
+     */
+    bool tryReadv(const std::vector<IoVec> &iov, uint8_t *p) const;
+    /**
+     * Scatter the first size bytes of p into the virtual buffers of
+     * iov, in order.
+     */
+    bool tryWritev(const std::vector<IoVec> &iov, const uint8_t *p,
+                   int size) const;
+
     void readBlob(Addr addr, uint8_t *p, int size) const override;
     void writeBlob(Addr addr, const uint8_t *p, int size) const override;
     void memsetBlob(Addr addr, uint8_t val, int size) const override;
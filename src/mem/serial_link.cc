@@ -52,6 +52,9 @@
 
 #include "mem/serial_link.hh"
 
+#include <algorithm>
+
+#include "base/intmath.hh"
 #include "base/trace.hh"
 #include "debug/SerialLink.hh"
 #include "params/SerialLink.hh"
@@ -66,7 +69,7 @@ SerialLink::SerialLinkSlavePort::SerialLinkSlavePort(const std::string& _name,
       masterPort(_masterPort), delay(_delay),
       ranges(_ranges.begin(), _ranges.end()),
       outstandingResponses(0), retryReq(false),
-      respQueueLimit(_resp_limit),
+      respQueueLimit(_resp_limit), linkFreeAt(0),
       sendEvent([this]{ trySendTiming(); }, _name)
 {
 }
@@ -77,7 +80,7 @@ SerialLink::SerialLinkMasterPort::SerialLinkMasterPort(const std::string&
                                            Cycles _delay, int _req_limit)
     : MasterPort(_name, &_serial_link), serial_link(_serial_link),
       slavePort(_slavePort), delay(_delay), reqQueueLimit(_req_limit),
-      sendEvent([this]{ trySendTiming(); }, _name)
+      linkFreeAt(0), sendEvent([this]{ trySendTiming(); }, _name)
 {
 }
 
@@ -88,9 +91,13 @@ SerialLink::SerialLink(SerialLinkParams *p)
       masterPort(p->name + ".master", *this, slavePort,
                  ticksToCycles(p->delay), p->req_size),
       num_lanes(p->num_lanes),
-      link_speed(p->link_speed)
-
+      link_speed(p->link_speed),
+      flitSize(p->flit_size),
+      batchWindow(p->batch_window)
 {
+    fatal_if(num_lanes == 0 || link_speed == 0,
+             "%s needs at least one lane with a non-zero speed\n", name());
+    fatal_if(flitSize == 0, "%s has a zero flit size\n", name());
 }
 
 BaseMasterPort&
@@ -124,6 +131,43 @@ SerialLink::init()
     slavePort.sendRangeChange();
 }
 
+void
+SerialLink::regStats()
+{
+    MemObject::regStats();
+
+    slavePort.regStats();
+    masterPort.regStats();
+}
+
+void
+SerialLink::SerialLinkSlavePort::regStats()
+{
+    respBatchSize
+        .init(16)
+        .name(serial_link.name() + ".resp_batch_size")
+        .desc("Number of responses sent per send event")
+        .flags(Stats::nozero);
+}
+
+void
+SerialLink::SerialLinkMasterPort::regStats()
+{
+    reqBatchSize
+        .init(16)
+        .name(serial_link.name() + ".req_batch_size")
+        .desc("Number of requests sent per send event")
+        .flags(Stats::nozero);
+}
+
+Cycles
+SerialLink::serializationCycles(PacketPtr pkt) const
+{
+    // partially filled flits occupy the lanes as much as full ones
+    uint64_t bits = divCeil(pkt->getSize(), flitSize) * flitSize * 8;
+    return Cycles(divCeil(bits, num_lanes * link_speed));
+}
+
 bool
 SerialLink::SerialLinkSlavePort::respQueueFull() const
 {
@@ -154,10 +198,8 @@ SerialLink::SerialLinkMasterPort::recvTimingResp(PacketPtr pkt)
     // first flit, but the deserializer (at the host side in this case), will
     // have to wait to receive the whole packet. So we only account for the
     // deserialization latency.
-    Cycles cycles = delay;
-    cycles += Cycles(divCeil(pkt->getSize() * 8, serial_link.num_lanes
-                * serial_link.link_speed));
-     Tick t = serial_link.clockEdge(cycles);
+    Cycles cycles = delay + serial_link.serializationCycles(pkt);
+    Tick t = serial_link.clockEdge(cycles);
 
     //@todo: If the processor sends two uncached requests towards HMC and the
     // second one is smaller than the first one. It may happen that the second
@@ -215,9 +257,7 @@ SerialLink::SerialLinkSlavePort::recvTimingReq(PacketPtr pkt)
             // to check its integrity first. So everytime a packet crosses a
             // serial link, we should account for its deserialization latency
             // only.
-            Cycles cycles = delay;
-            cycles += Cycles(divCeil(pkt->getSize() * 8,
-                    serial_link.num_lanes * serial_link.link_speed));
+            Cycles cycles = delay + serial_link.serializationCycles(pkt);
             Tick t = serial_link.clockEdge(cycles);
 
             //@todo: If the processor sends two uncached requests towards HMC
@@ -254,7 +294,7 @@ SerialLink::SerialLinkMasterPort::schedTimingReq(PacketPtr pkt, Tick when)
     // should already be an event scheduled for sending the head
     // packet.
     if (transmitList.empty()) {
-        serial_link.schedule(sendEvent, when);
+        serial_link.schedule(sendEvent, std::max(when, linkFreeAt));
     }
 
     assert(transmitList.size() != reqQueueLimit);
@@ -271,7 +311,7 @@ SerialLink::SerialLinkSlavePort::schedTimingResp(PacketPtr pkt, Tick when)
     // should already be an event scheduled for sending the head
     // packet.
     if (transmitList.empty()) {
-        serial_link.schedule(sendEvent, when);
+        serial_link.schedule(sendEvent, std::max(when, linkFreeAt));
     }
 
     transmitList.emplace_back(DeferredPacket(pkt, when));
@@ -282,42 +322,66 @@ SerialLink::SerialLinkMasterPort::trySendTiming()
 {
     assert(!transmitList.empty());
 
-    DeferredPacket req = transmitList.front();
-
-    assert(req.tick <= curTick());
-
-    PacketPtr pkt = req.pkt;
-
-    DPRINTF(SerialLink, "trySend request addr 0x%x, queue size %d\n",
-            pkt->getAddr(), transmitList.size());
+    // Send every request that starts crossing the link before the end
+    // of the serialization window, and let the receiver account for
+    // its offset into the window through the header delay. With an
+    // empty window this sends the packets that are due right now.
+    const Tick window_end = curTick() + serial_link.batchWindow;
+    unsigned int sent = 0;
+    bool blocked = false;
+
+    while (!transmitList.empty()) {
+        DeferredPacket req = transmitList.front();
+
+        // Make sure bandwidth limitation is met
+        Tick start = std::max(req.tick, linkFreeAt);
+        if (start > curTick() && start >= window_end)
+            break;
+
+        PacketPtr pkt = req.pkt;
+
+        DPRINTF(SerialLink, "trySend request addr 0x%x, queue size %d\n",
+                pkt->getAddr(), transmitList.size());
+
+        // the packet may be gone once it is sent
+        Tick ser = serial_link.cyclesToTicks(
+            serial_link.serializationCycles(pkt));
+        const Tick offset = start - curTick();
+        pkt->headerDelay += offset;
+
+        if (!sendTimingReq(pkt)) {
+            // we try again once we receive a retry, and therefore
+            // there is no need to take any action other than leaving
+            // the header delay as it was
+            pkt->headerDelay -= offset;
+            blocked = true;
+            break;
+        }
 
-    if (sendTimingReq(pkt)) {
         // send successful
         transmitList.pop_front();
+        linkFreeAt = start + ser;
+        ++sent;
 
         DPRINTF(SerialLink, "trySend request successful\n");
+    }
 
-        // If there are more packets to send, schedule event to try again.
-        if (!transmitList.empty()) {
-            DeferredPacket next_req = transmitList.front();
-            DPRINTF(SerialLink, "Scheduling next send\n");
-
-            // Make sure bandwidth limitation is met
-            Cycles cycles = Cycles(divCeil(pkt->getSize() * 8,
-                serial_link.num_lanes * serial_link.link_speed));
-            Tick t = serial_link.clockEdge(cycles);
-            serial_link.schedule(sendEvent, std::max(next_req.tick, t));
-        }
+    if (sent != 0)
+        reqBatchSize.sample(sent);
 
-        // if we have stalled a request due to a full request queue,
-        // then send a retry at this point, also note that if the
-        // request we stalled was waiting for the response queue
-        // rather than the request queue we might stall it again
-        slavePort.retryStalledReq();
+    // If there are more packets to send, schedule event to try again.
+    if (!blocked && !transmitList.empty()) {
+        DPRINTF(SerialLink, "Scheduling next send\n");
+        serial_link.schedule(sendEvent,
+                             std::max(transmitList.front().tick, linkFreeAt));
     }
 
-    // if the send failed, then we try again once we receive a retry,
-    // and therefore there is no need to take any action
+    // if we have stalled a request due to a full request queue,
+    // then send a retry at this point, also note that if the
+    // request we stalled was waiting for the response queue
+    // rather than the request queue we might stall it again
+    if (sent != 0)
+        slavePort.retryStalledReq();
 }
 
 void
@@ -325,47 +389,68 @@ SerialLink::SerialLinkSlavePort::trySendTiming()
 {
     assert(!transmitList.empty());
 
-    DeferredPacket resp = transmitList.front();
-
-    assert(resp.tick <= curTick());
-
-    PacketPtr pkt = resp.pkt;
-
-    DPRINTF(SerialLink, "trySend response addr 0x%x, outstanding %d\n",
-            pkt->getAddr(), outstandingResponses);
+    // Same as for the requests, send every response that starts
+    // crossing the link within the serialization window.
+    const Tick window_end = curTick() + serial_link.batchWindow;
+    unsigned int sent = 0;
+    bool blocked = false;
+
+    while (!transmitList.empty()) {
+        DeferredPacket resp = transmitList.front();
+
+        // Make sure bandwidth limitation is met
+        Tick start = std::max(resp.tick, linkFreeAt);
+        if (start > curTick() && start >= window_end)
+            break;
+
+        PacketPtr pkt = resp.pkt;
+
+        DPRINTF(SerialLink, "trySend response addr 0x%x, outstanding %d\n",
+                pkt->getAddr(), outstandingResponses);
+
+        Tick ser = serial_link.cyclesToTicks(
+            serial_link.serializationCycles(pkt));
+        const Tick offset = start - curTick();
+        pkt->headerDelay += offset;
+
+        if (!sendTimingResp(pkt)) {
+            // we try again once we receive a retry, and therefore
+            // there is no need to take any action other than leaving
+            // the header delay as it was
+            pkt->headerDelay -= offset;
+            blocked = true;
+            break;
+        }
 
-    if (sendTimingResp(pkt)) {
         // send successful
         transmitList.pop_front();
+        linkFreeAt = start + ser;
+        ++sent;
+
         DPRINTF(SerialLink, "trySend response successful\n");
 
         assert(outstandingResponses != 0);
         --outstandingResponses;
+    }
 
-        // If there are more packets to send, schedule event to try again.
-        if (!transmitList.empty()) {
-            DeferredPacket next_resp = transmitList.front();
-            DPRINTF(SerialLink, "Scheduling next send\n");
-
-            // Make sure bandwidth limitation is met
-            Cycles cycles = Cycles(divCeil(pkt->getSize() * 8,
-                serial_link.num_lanes * serial_link.link_speed));
-            Tick t = serial_link.clockEdge(cycles);
-            serial_link.schedule(sendEvent, std::max(next_resp.tick, t));
-        }
+    if (sent != 0)
+        respBatchSize.sample(sent);
 
-        // if there is space in the request queue and we were stalling
-        // a request, it will definitely be possible to accept it now
-        // since there is guaranteed space in the response queue
-        if (!masterPort.reqQueueFull() && retryReq) {
-            DPRINTF(SerialLink, "Request waiting for retry, now retrying\n");
-            retryReq = false;
-            sendRetryReq();
-        }
+    // If there are more packets to send, schedule event to try again.
+    if (!blocked && !transmitList.empty()) {
+        DPRINTF(SerialLink, "Scheduling next send\n");
+        serial_link.schedule(sendEvent,
+                             std::max(transmitList.front().tick, linkFreeAt));
     }
 
-    // if the send failed, then we try again once we receive a retry,
-    // and therefore there is no need to take any action
+    // if there is space in the request queue and we were stalling
+    // a request, it will definitely be possible to accept it now
+    // since there is guaranteed space in the response queue
+    if (sent != 0 && !masterPort.reqQueueFull() && retryReq) {
+        DPRINTF(SerialLink, "Request waiting for retry, now retrying\n");
+        retryReq = false;
+        sendRetryReq();
+    }
 }
 
 void
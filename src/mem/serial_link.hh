@@ -55,6 +55,7 @@
 
 #include <deque>
 
+#include "base/statistics.hh"
 #include "base/types.hh"
 #include "mem/mem_object.hh"
 #include "params/SerialLink.hh"
@@ -65,6 +66,12 @@
  * serializer component at the transmitter side does not need to receive the
  * whole packet to start the serialization. But the deserializer waits for the
  * complete packet to check its integrity first.
+ *
+ * Packets are serialized in whole flits. To keep the host-side cost
+ * independent of the packet rate, each side of the link sends all the
+ * packets that start serializing within a configurable window from a
+ * single event, and conveys the remaining serialization offset to the
+ * receiver through the packet header delay.
   */
 class SerialLink : public MemObject
 {
@@ -131,6 +138,9 @@ class SerialLink : public MemObject
         /** Max queue size for reserved responses. */
         unsigned int respQueueLimit;
 
+        /** Tick at which the response lanes finish the last packet. */
+        Tick linkFreeAt;
+
         /**
          * Is this side blocked from accepting new response packets.
          *
@@ -148,6 +158,9 @@ class SerialLink : public MemObject
         /** Send event for the response queue. */
         EventFunctionWrapper sendEvent;
 
+        /** Number of responses sent per send event. */
+        Stats::Histogram respBatchSize;
+
       public:
 
         /**
@@ -182,6 +195,9 @@ class SerialLink : public MemObject
          */
         void retryStalledReq();
 
+        /** Register the per-direction batching statistics. */
+        void regStats();
+
       protected:
 
         /** When receiving a timing request from the peer port,
@@ -238,6 +254,9 @@ class SerialLink : public MemObject
         /** Max queue size for request packets */
         const unsigned int reqQueueLimit;
 
+        /** Tick at which the request lanes finish the last packet. */
+        Tick linkFreeAt;
+
         /**
          * Handle send event, scheduled when the packet at the head of
          * the outbound queue is ready to transmit (for timing
@@ -248,6 +267,9 @@ class SerialLink : public MemObject
         /** Send event for the request queue. */
         EventFunctionWrapper sendEvent;
 
+        /** Number of requests sent per send event. */
+        Stats::Histogram reqBatchSize;
+
       public:
 
         /**
@@ -290,6 +312,9 @@ class SerialLink : public MemObject
          */
         bool trySatisfyFunctional(PacketPtr pkt);
 
+        /** Register the per-direction batching statistics. */
+        void regStats();
+
       protected:
 
         /** When receiving a timing request from the peer port,
@@ -313,6 +338,24 @@ class SerialLink : public MemObject
     /** Speed of each link (Gb/s) in this serial link */
     uint64_t link_speed;
 
+    /** Size of a flit in bytes, the unit of serialization */
+    const unsigned flitSize;
+
+    /**
+     * Window within which packets that are ready to go are sent from
+     * a single event, zero sending one packet per event.
+     */
+    const Tick batchWindow;
+
+    /**
+     * Get the number of cycles it takes to serialize a packet, rounding
+     * it up to whole flits.
+     *
+     * @param pkt the packet to serialize
+     * @return serialization latency in cycles of the link clock
+     */
+    Cycles serializationCycles(PacketPtr pkt) const;
+
   public:
 
     virtual BaseMasterPort& getMasterPort(const std::string& if_name,
@@ -322,6 +365,8 @@ class SerialLink : public MemObject
 
     virtual void init();
 
+    virtual void regStats();
+
     typedef SerialLinkParams Params;
 
     SerialLink(SerialLinkParams *p);
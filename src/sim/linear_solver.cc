@@ -39,6 +39,10 @@
 
 #include "sim/linear_solver.hh"
 
+#include <cmath>
+
+#include "base/logging.hh"
+
 std::vector <double>
 LinearSystem::solve() const
 {
@@ -85,3 +89,107 @@ LinearSystem::solve() const
 
     return ret;
 }
+
+bool
+SparseLinearSystem::diagonallyDominant() const
+{
+    assert(!factorized);
+    for (unsigned row = 0; row < size(); row++) {
+        double diag = 0, others = 0;
+        for (const auto &c : rows[row]) {
+            if (c.first == row)
+                diag = std::fabs(c.second);
+            else
+                others += std::fabs(c.second);
+        }
+        // The diagonal of a node is the sum of the conductances of its
+        // neighbours, accumulated in a different order, so allow for
+        // rounding
+        if (diag < others * (1 - 1e-12))
+            return false;
+    }
+    return true;
+}
+
+void
+SparseLinearSystem::factorize()
+{
+    assert(!factorized);
+    const unsigned order = size();
+
+    // Do the elimination on a dense copy, this only happens once. Only the
+    // non-zero entries of a pivot row need to be propagated.
+    std::vector < std::vector <double> > a(order,
+                                            std::vector <double>(order, 0));
+    for (unsigned row = 0; row < order; row++)
+        for (const auto &c : rows[row])
+            a[row][c.first] = c.second;
+    for (auto &r : rows)
+        r.clear();
+
+    std::vector <unsigned> pivot_cols;
+    for (unsigned k = 0; k < order; k++) {
+        panic_if(a[k][k] == 0.0, "Singular linear system\n");
+
+        pivot_cols.clear();
+        for (unsigned j = k + 1; j < order; j++)
+            if (a[k][j] != 0.0)
+                pivot_cols.push_back(j);
+
+        for (unsigned i = k + 1; i < order; i++) {
+            if (a[i][k] == 0.0)
+                continue;
+            // Keep the multiplier in place, it is the entry of L
+            const double f = a[i][k] /= a[k][k];
+            for (auto j : pivot_cols)
+                a[i][j] -= f * a[k][j];
+        }
+    }
+
+    // Keep only the non-zero entries of the factors
+    lStart.assign(1, 0);
+    uStart.assign(1, 0);
+    uDiagInv.resize(order);
+    for (unsigned i = 0; i < order; i++) {
+        for (unsigned j = 0; j < order; j++) {
+            if (j == i || a[i][j] == 0.0)
+                continue;
+            auto &col = j < i ? lCol : uCol;
+            auto &val = j < i ? lVal : uVal;
+            col.push_back(j);
+            val.push_back(a[i][j]);
+        }
+        lStart.push_back(lCol.size());
+        uStart.push_back(uCol.size());
+        uDiagInv[i] = 1.0 / a[i][i];
+    }
+
+    factorized = true;
+}
+
+std::vector <double>
+SparseLinearSystem::solve(const std::vector <double> &b) const
+{
+    assert(factorized);
+    assert(b.size() == uDiagInv.size());
+    const unsigned order = b.size();
+
+    // L*y = b
+    std::vector <double> x(b);
+    for (unsigned i = 0; i < order; i++) {
+        double sum = x[i];
+        for (unsigned e = lStart[i]; e < lStart[i + 1]; e++)
+            sum -= lVal[e] * x[lCol[e]];
+        x[i] = sum;
+    }
+
+    // U*x = y
+    for (int i = order - 1; i >= 0; i--) {
+        double sum = x[i];
+        for (unsigned e = uStart[i]; e < uStart[i + 1]; e++)
+            sum -= uVal[e] * x[uCol[e]];
+        x[i] = sum * uDiagInv[i];
+    }
+
+    return x;
+}
@@ -41,6 +41,7 @@
 #define __SIM_LINEAR_SOLVER_HH__
 
 #include <cassert>
+#include <map>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -131,4 +132,52 @@ class LinearSystem {
     std::vector < LinearEquation > matrix;
 };
 
+/**
+ * This class describes a linear system A*x = b whose coefficient matrix A
+ * is sparse and constant, while b changes from one solve to the next. The
+ * matrix is assembled one coefficient at a time and factorized once
+ * (A = L*U), after which every solve only needs a forward and a backward
+ * substitution over the non-zero entries of the factors.
+ *
+ * No pivoting is done, so the matrix has to be diagonally dominant, like
+ * the nodal equations of an RC network are.
+ */
+class SparseLinearSystem {
+  public:
+    SparseLinearSystem(unsigned unknowns = 0)
+        : rows(unknowns), factorized(false) {}
+
+    // Number of unknowns
+    unsigned size() const { return rows.size(); }
+
+    // Add a value to a coefficient
+    void add(unsigned row, unsigned col, double value) {
+        assert(!factorized);
+        assert(row < size() && col < size());
+        rows[row][col] += value;
+    }
+
+    // Check that |a_ii| >= sum(|a_ij|, j != i) for every row, as the
+    // factorization relies on it. Only valid before factorizing.
+    bool diagonallyDominant() const;
+
+    // Factorize the matrix, no coefficients can be added afterwards
+    void factorize();
+
+    // Solve the system for a right hand side b
+    std::vector <double> solve(const std::vector <double> &b) const;
+
+  private:
+    /** Coefficients while assembling, by row and column */
+    std::vector < std::map <unsigned, double> > rows;
+
+    bool factorized;
+
+    /** Factors in compressed row form, L has an implicit unit diagonal */
+    std::vector <unsigned> lStart, lCol, uStart, uCol;
+    std::vector <double> lVal, uVal;
+    /** Inverse of the diagonal of U */
+    std::vector <double> uDiagInv;
+};
+
 #endif
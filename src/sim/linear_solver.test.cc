@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2026 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "sim/linear_solver.hh"
+
+namespace {
+
+/**
+ * The nodal equations of a small RC network, kept both as a dense
+ * LinearSystem and as a SparseLinearSystem with the same coefficients.
+ */
+class RCNetwork
+{
+  public:
+    static const unsigned nodes = 5;
+
+    RCNetwork() : dense(nodes), sparse(nodes), b(nodes, 0.0) {}
+
+    /** Conductance g between two nodes, -1 being the ambient at temp */
+    void
+    conductance(int n1, int n2, double g, double temp)
+    {
+        if (n1 >= 0)
+            stamp(n1, n2, g, temp);
+        if (n2 >= 0)
+            stamp(n2, n1, g, temp);
+    }
+
+    /** Heat injected into a node */
+    void power(unsigned n, double watts) { b[n] -= watts; }
+
+    std::vector<double>
+    solveDense()
+    {
+        for (unsigned i = 0; i < nodes; i++)
+            dense[i][dense[i].cnt()] = -b[i];
+        return dense.solve();
+    }
+
+    LinearSystem dense;
+    SparseLinearSystem sparse;
+    std::vector<double> b;
+
+  private:
+    void
+    stamp(int n, int other, double g, double temp)
+    {
+        dense[n][n] += -g;
+        sparse.add(n, n, -g);
+        if (other >= 0) {
+            dense[n][other] += g;
+            sparse.add(n, other, g);
+        } else {
+            b[n] -= g * temp;
+        }
+    }
+};
+
+} // anonymous namespace
+
+TEST(SparseLinearSystemTest, MatchesDenseSolve)
+{
+    RCNetwork net;
+    const double ambient = 25.0;
+    const double step = 0.01;
+
+    // A heat sink tied to the ambient, with three heat sources and a
+    // spreader hanging off it
+    net.conductance(0, -1, 1.0 / 0.5, ambient);
+    net.conductance(1, 0, 1.0 / 0.2, ambient);
+    net.conductance(2, 0, 1.0 / 0.3, ambient);
+    net.conductance(3, 1, 1.0 / 0.1, ambient);
+    net.conductance(3, 2, 1.0 / 0.4, ambient);
+    net.conductance(4, 3, 1.0 / 0.25, ambient);
+    for (unsigned n = 0; n < RCNetwork::nodes; n++)
+        net.conductance(n, -1, (n + 1) * 0.05 / step, ambient);
+    net.power(1, 2.0);
+    net.power(2, 0.5);
+    net.power(4, 1.5);
+
+    ASSERT_TRUE(net.sparse.diagonallyDominant());
+    net.sparse.factorize();
+
+    const std::vector<double> expected = net.solveDense();
+    const std::vector<double> actual = net.sparse.solve(net.b);
+
+    ASSERT_EQ(expected.size(), actual.size());
+    for (unsigned i = 0; i < expected.size(); i++)
+        EXPECT_NEAR(expected[i], actual[i], 1e-9) << "node " << i;
+}
+
+TEST(SparseLinearSystemTest, ReusesFactorization)
+{
+    RCNetwork net;
+    net.conductance(0, -1, 4.0, 20.0);
+    net.conductance(1, 0, 2.0, 20.0);
+    net.conductance(2, 1, 3.0, 20.0);
+    net.conductance(3, 1, 1.0, 20.0);
+    net.conductance(4, 2, 5.0, 20.0);
+    net.sparse.factorize();
+
+    // Only the right hand side changes between steps
+    for (unsigned n = 0; n < RCNetwork::nodes; n++) {
+        net.power(n, 1.0 + n);
+
+        const std::vector<double> expected = net.solveDense();
+        const std::vector<double> actual = net.sparse.solve(net.b);
+        for (unsigned i = 0; i < expected.size(); i++)
+            EXPECT_NEAR(expected[i], actual[i], 1e-9) << "node " << i;
+    }
+}
+
+TEST(SparseLinearSystemTest, DiagonalDominance)
+{
+    SparseLinearSystem dominant(2);
+    dominant.add(0, 0, -3.0);
+    dominant.add(0, 1, 3.0);
+    dominant.add(1, 0, 1.0);
+    dominant.add(1, 1, -2.0);
+    EXPECT_TRUE(dominant.diagonallyDominant());
+
+    // A node joined to three others, its diagonal is summed in the
+    // order of the conductances and the rest of its row in the order of
+    // the nodes, so the two sums differ in the last bit
+    SparseLinearSystem star(4);
+    const double g[] = {0.3, 0.2, 0.1};
+    for (unsigned i = 0; i < 3; i++) {
+        const unsigned n = 3 - i;
+        star.add(0, 0, -g[i]);
+        star.add(0, n, g[i]);
+        star.add(n, n, -g[i]);
+        star.add(n, 0, g[i]);
+    }
+    EXPECT_TRUE(star.diagonallyDominant());
+
+    // A negative conductance breaks it
+    SparseLinearSystem negative(2);
+    negative.add(0, 0, 1.0);
+    negative.add(0, 1, -1.0);
+    negative.add(0, 1, -1.0);
+    negative.add(1, 1, 1.0);
+    EXPECT_FALSE(negative.diagonallyDominant());
+}
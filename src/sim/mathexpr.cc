@@ -165,6 +165,53 @@ MathExpr::eval(const Node *n, EvalCallback fn) const {
     return 0;
 }
 
+bool
+MathExpr::compile(BindCallback fn)
+{
+    program.clear();
+
+    unsigned depth = 0, max_depth = 0;
+    bool ok = compile(root, fn, depth, max_depth);
+    assert(depth == 1);
+
+    stack.resize(max_depth);
+    return ok;
+}
+
+bool
+MathExpr::compile(const Node *n, BindCallback &fn, unsigned &depth,
+                  unsigned &max_depth)
+{
+    Insn insn {n->op, nullptr, 0, -1};
+    bool ok = true;
+
+    if (n->op == sValue) {
+        insn.value = n->value;
+    } else if (n->op == sVariable) {
+        insn.slot = fn(n->variable);
+        ok = insn.slot >= 0;
+    } else if (n->op == uNeg) {
+        // The operand is replaced in place
+        ok = compile(n->r, fn, depth, max_depth);
+        program.push_back(insn);
+        return ok;
+    } else {
+        for (auto & opt : ops)
+            if (opt.op == n->op)
+                insn.fn = opt.fn;
+        panic_if(!insn.fn, "Invalid node!\n");
+
+        ok = compile(n->l, fn, depth, max_depth);
+        ok = compile(n->r, fn, depth, max_depth) && ok;
+        // Two operands are replaced by the result
+        depth -= 2;
+    }
+
+    program.push_back(insn);
+    max_depth = std::max(max_depth, ++depth);
+    return ok;
+}
+
 std::string
 MathExpr::toStr(Node *n, std::string prefix) const {
     std::string ret;
@@ -42,8 +42,10 @@
 
 #include <algorithm>
 #include <array>
+#include <cassert>
 #include <functional>
 #include <string>
+#include <vector>
 
 class MathExpr {
   public:
@@ -52,6 +54,12 @@ class MathExpr {
 
     typedef std::function<double(std::string)> EvalCallback;
 
+    /**
+     * Callback used to bind variables when compiling, returning the slot
+     * a variable should be read from or a negative value if it is unknown.
+     */
+    typedef std::function<int(const std::string &)> BindCallback;
+
     /**
      * Prints an ASCII representation of the expression tree
      *
@@ -68,6 +76,51 @@ class MathExpr {
      */
     double eval(EvalCallback fn) const { return eval(root, fn); }
 
+    /**
+     * Compiles the expression into a flat program in reverse polish
+     * notation. Every variable is bound to a slot once, so evaluating the
+     * compiled program involves neither a tree walk nor name lookups.
+     *
+     * @param fn A callback function to bind variables to slots
+     *
+     * @return False if any variable could not be bound
+     */
+    bool compile(BindCallback fn);
+
+    /**
+     * Evaluates the compiled expression
+     *
+     * @param fn A callable returning the value of a variable given its slot
+     *
+     * @return The value for this expression
+     */
+    template <typename F>
+    double
+    evalCompiled(F fn) const
+    {
+        assert(!program.empty());
+
+        double *sp = stack.data();
+        for (const auto &insn : program) {
+            switch (insn.op) {
+              case sValue:
+                *sp++ = insn.value;
+                break;
+              case sVariable:
+                *sp++ = fn(insn.slot);
+                break;
+              case uNeg:
+                sp[-1] = -sp[-1];
+                break;
+              default:
+                sp--;
+                sp[-1] = insn.fn(sp[-1], sp[0]);
+                break;
+            }
+        }
+        return stack[0];
+    }
+
   private:
     enum Operator {
         bAdd, bSub, bMul, bDiv, bPow, uNeg, sValue, sVariable, nInvalid
@@ -113,6 +166,24 @@ class MathExpr {
     /** Root node */
     Node * root;
 
+    /** A step of the compiled program */
+    struct Insn {
+        Operator op;
+        binOp fn;
+        double value;
+        int slot;
+    };
+
+    /** Compiled program, in evaluation order */
+    std::vector<Insn> program;
+
+    /** Operand stack for the compiled program, sized by compile() */
+    mutable std::vector<double> stack;
+
+    /** Append the program for a node, tracking the stack depth */
+    bool compile(const Node *n, BindCallback &fn, unsigned &depth,
+                 unsigned &max_depth);
+
     /** Parse and create nodes from string */
     Node *parse(std::string expr);
 
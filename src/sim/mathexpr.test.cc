@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2026 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "sim/mathexpr.hh"
+
+namespace {
+
+/** Variables available to the expressions under test */
+const std::map<std::string, double> values = {
+    {"a", 3.0}, {"b", -2.5}, {"c", 0.5}, {"sys.cpu.numCycles", 1000.0},
+};
+
+/**
+ * Evaluate an expression both by walking the tree and through the
+ * compiled program, binding every variable to its own slot.
+ */
+void
+checkCompiled(const std::string &str)
+{
+    MathExpr expr(str);
+
+    const double expected = expr.eval([](std::string name) {
+            return values.at(name);
+        });
+
+    std::vector<std::string> names;
+    ASSERT_TRUE(expr.compile([&names](const std::string &name) {
+            if (values.find(name) == values.end())
+                return -1;
+            auto it = std::find(names.begin(), names.end(), name);
+            if (it == names.end())
+                it = names.insert(it, name);
+            return int(it - names.begin());
+        })) << str;
+
+    const double actual = expr.evalCompiled([&names](int slot) {
+            return values.at(names[slot]);
+        });
+
+    EXPECT_DOUBLE_EQ(expected, actual) << str;
+}
+
+} // anonymous namespace
+
+TEST(MathExprTest, Constant)
+{
+    checkCompiled("42");
+    checkCompiled("1.5e3");
+}
+
+TEST(MathExprTest, Arithmetic)
+{
+    checkCompiled("a + b * c");
+    checkCompiled("(a + b) * c");
+    checkCompiled("a - b - c");
+    checkCompiled("a / b / c");
+}
+
+TEST(MathExprTest, UnaryMinus)
+{
+    checkCompiled("-a");
+    checkCompiled("-a * b");
+    checkCompiled("a - -b");
+    checkCompiled("-(a + b) / -c");
+}
+
+TEST(MathExprTest, Power)
+{
+    checkCompiled("a ^ 2");
+    checkCompiled("a ^ c + 1");
+    checkCompiled("2 ^ -c");
+    checkCompiled("(a - b) ^ 2 * c");
+}
+
+TEST(MathExprTest, RepeatedVariables)
+{
+    checkCompiled("a * a + a");
+    checkCompiled("(a + b) * (a - b) + b ^ a");
+    checkCompiled("sys.cpu.numCycles * c + sys.cpu.numCycles / a");
+}
+
+TEST(MathExprTest, UnknownVariable)
+{
+    MathExpr expr("a + unknown");
+    EXPECT_FALSE(expr.compile([](const std::string &name) {
+            return values.find(name) == values.end() ? -1 : 0;
+        }));
+}
@@ -48,7 +48,7 @@
 #include "sim/sim_object.hh"
 
 MathExprPowerModel::MathExprPowerModel(const Params *p)
-    : PowerModelState(p), dyn_expr(p->dyn), st_expr(p->st), failed(false)
+    : PowerModelState(p), dyn_expr(p->dyn), st_expr(p->st)
 {
     // Calculate the name of the object we belong to
     std::vector<std::string> path;
@@ -74,11 +74,12 @@ MathExprPowerModel::startup()
         }
     }
 
-    tryEval(st_expr);
-    const bool st_failed = failed;
-
-    tryEval(dyn_expr);
-    const bool dyn_failed = failed;
+    // Resolve all variables once, so sampling power doesn't have to look
+    // anything up by name
+    auto bind = std::bind(&MathExprPowerModel::bindVariable,
+                          this, std::placeholders::_1);
+    const bool st_failed = !st_expr.compile(bind);
+    const bool dyn_failed = !dyn_expr.compile(bind);
 
     if (st_failed || dyn_failed) {
         const auto *p = dynamic_cast<const Params *>(params());
@@ -94,61 +95,72 @@ MathExprPowerModel::startup()
 double
 MathExprPowerModel::eval(const MathExpr &expr) const
 {
-    const double value = tryEval(expr);
-
-    // This shouldn't happen unless something went wrong the equations
-    // were verified in startup().
-    panic_if(failed, "Failed to evaluate power expression '%s'\n",
-             expr.toStr());
-
-    return value;
+    return expr.evalCompiled([this](int slot) {
+            return getSlotValue(slot);
+        });
 }
 
-double
-MathExprPowerModel::tryEval(const MathExpr &expr) const
+int
+MathExprPowerModel::bindVariable(const std::string &name)
 {
-    failed = false;
-    const double value = expr.eval(
-        std::bind(&MathExprPowerModel::getStatValue,
-                  this, std::placeholders::_1)
-        );
+    using namespace Stats;
 
-    return value;
-}
+    const auto sit = slots.find(name);
+    if (sit != slots.end())
+        return sit->second;
 
+    Binding binding {Binding::Temp, nullptr};
+
+    // Automatic variables:
+    if (name == "temp") {
+        binding.kind = Binding::Temp;
+    } else if (name == "voltage") {
+        binding.kind = Binding::Voltage;
+    } else if (name == "clock_period") {
+        binding.kind = Binding::ClockPeriod;
+    } else {
+        // Try to cast the stat, only these are supported right now
+        const auto it = stats_map.find(name);
+        if (it == stats_map.cend()) {
+            warn("Failed to find stat '%s'\n", name);
+            return -1;
+        }
+
+        binding.info = it->second;
+        if (dynamic_cast<const ScalarInfo *>(binding.info))
+            binding.kind = Binding::Scalar;
+        else if (dynamic_cast<const FormulaInfo *>(binding.info))
+            binding.kind = Binding::Formula;
+        else
+            panic("Unknown stat type!\n");
+    }
+
+    const int slot = bindings.size();
+    bindings.push_back(binding);
+    slots[name] = slot;
+    return slot;
+}
 
 double
-MathExprPowerModel::getStatValue(const std::string &name) const
+MathExprPowerModel::getSlotValue(int slot) const
 {
     using namespace Stats;
 
-    // Automatic variables:
-    if (name == "temp") {
+    const Binding &binding = bindings[slot];
+    switch (binding.kind) {
+      case Binding::Temp:
         return _temp;
-    } else if (name == "voltage") {
+      case Binding::Voltage:
         return clocked_object->voltage();
-    } else if (name=="clock_period") {
+      case Binding::ClockPeriod:
         return clocked_object->clockPeriod();
-    } 
-
-    // Try to cast the stat, only these are supported right now
-    const auto it = stats_map.find(name);
-    if (it == stats_map.cend()) {
-        warn("Failed to find stat '%s'\n", name);
-        failed = true;
-        return 0;
+      case Binding::Scalar:
+        return static_cast<const ScalarInfo *>(binding.info)->value();
+      case Binding::Formula:
+        return static_cast<const FormulaInfo *>(binding.info)->total();
+      default:
+        panic("Unknown binding!\n");
     }
-
-    const Info *info = it->second;
-
-    auto si = dynamic_cast<const ScalarInfo *>(info);
-    if (si)
-        return si->value();
-    auto fi = dynamic_cast<const FormulaInfo *>(info);
-    if (fi)
-        return fi->total();
-
-    panic("Unknown stat type!\n");
 }
 
 void
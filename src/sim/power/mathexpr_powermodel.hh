@@ -41,6 +41,7 @@
 #define __SIM_MATHEXPR_POWERMODEL_PM_HH__
 
 #include <unordered_map>
+#include <vector>
 
 #include "params/MathExprPowerModel.hh"
 #include "sim/mathexpr.hh"
@@ -75,23 +76,13 @@ class MathExprPowerModel : public PowerModelState
      */
     double getStaticPower() const { return eval(st_expr); }
 
-    /**
-     * Get the value for a variable (maps to a stat)
-     *
-     * @param name Name of the variable to retrieve the value from
-     *
-     * @return Power (Watts) consumed by this object (static component)
-     */
-    double getStatValue(const std::string & name) const;
-
     void startup();
 
     void regStats();
 
   private:
     /**
-     * Evaluate an expression in the context of this object, fatal if
-     * evaluation fails.
+     * Evaluate a compiled expression in the context of this object.
      *
      * @param expr Expression to evaluate
      * @return Value of expression.
@@ -99,13 +90,27 @@ class MathExprPowerModel : public PowerModelState
     double eval(const MathExpr &expr) const;
 
     /**
-     * Evaluate an expression in the context of this object, set
-     * failed if evaluation failed.
+     * Bind a variable to a slot, sharing slots between expressions.
      *
-     * @param expr Expression to evaluate
-     * @return Value of expression.
+     * @param name Name of the variable
+     * @return Slot of the variable, or -1 if it can't be resolved
+     */
+    int bindVariable(const std::string &name);
+
+    /** Where the value of a bound variable comes from */
+    struct Binding {
+        enum Kind { Temp, Voltage, ClockPeriod, Scalar, Formula };
+        Kind kind;
+        const Stats::Info *info;
+    };
+
+    /**
+     * Get the current value of a bound variable.
+     *
+     * @param slot Slot the variable was bound to
+     * @return Value of the variable
      */
-    double tryEval(const MathExpr &expr) const;
+    double getSlotValue(int slot) const;
 
     // Math expressions for dynamic and static power
     MathExpr dyn_expr, st_expr;
@@ -116,9 +121,9 @@ class MathExprPowerModel : public PowerModelState
     // Map that contains relevant stats for this power model
     std::unordered_map<std::string, Stats::Info*> stats_map;
 
-    // Did the expression fail to evaluate (e.g., because a stat value
-    // can't be resolved)
-    mutable bool failed;
+    // Variables used by the expressions, indexed by slot
+    std::vector<Binding> bindings;
+    std::unordered_map<std::string, int> slots;
 };
 
 #endif
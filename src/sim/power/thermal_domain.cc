@@ -109,12 +109,12 @@ ThermalDomain::unserialize(CheckpointIn &cp)
 }
 
 
-LinearEquation
-ThermalDomain::getEquation(ThermalNode * tn, unsigned n, double step) const
+void
+ThermalDomain::addConstants(std::vector<double> &cnt, double step) const
 {
-    LinearEquation eq(n);
+    // The power is the current injected into our node
+    if (node->isref)
+        return;
     double power = subsystem->getDynamicPower() + subsystem->getStaticPower();
-    if (tn == node)
-        eq[eq.cnt()] = power;
-    return eq;
+    cnt[node->id] -= power;
 }
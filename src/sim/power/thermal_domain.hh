@@ -81,9 +81,11 @@ class ThermalDomain : public SimObject, public ThermalEntity
     void setNode(ThermalNode * n) { node = n; }
     ThermalNode * getNode() const { return node; }
 
-    /** Get nodal equation imposed by this node */
-    LinearEquation getEquation(ThermalNode * tn, unsigned n,
-                               double step) const override;
+    /** Add to the nodal equations imposed by this node */
+    void addCoefficients(SparseLinearSystem &ls,
+                         double step) const override {}
+    void addConstants(std::vector<double> &cnt,
+                      double step) const override;
 
     /**
       *  Emit a temperature update through probe points interface
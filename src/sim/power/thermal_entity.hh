@@ -40,9 +40,11 @@
 #ifndef __SIM_THERMAL_ENTITY_HH__
 #define __SIM_THERMAL_ENTITY_HH__
 
+#include <vector>
+
 #include "sim/sim_object.hh"
 
-class LinearEquation;
+class SparseLinearSystem;
 class ThermalNode;
 
 /**
@@ -53,9 +55,20 @@ class ThermalNode;
 class ThermalEntity
 {
   public:
-    // Get the equation given a node and a step in seconds (assuming N nodes)
-    virtual LinearEquation getEquation(ThermalNode *tn, unsigned n,
-                                       double step) const = 0;
+    // The nodal equations are sum(coefficient * temperature) = constant,
+    // with one equation and one unknown per node without a fixed
+    // temperature, indexed by node id.
+
+    // Add the coefficients of this entity to the nodal equations given a
+    // step in seconds. These only depend on the network, so this is only
+    // done once.
+    virtual void addCoefficients(SparseLinearSystem &ls,
+                                 double step) const = 0;
+
+    // Add the constant terms of this entity to the nodal equations given
+    // a step in seconds, based on the current temperatures
+    virtual void addConstants(std::vector<double> &cnt,
+                              double step) const = 0;
 };
 
 
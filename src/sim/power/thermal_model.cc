@@ -74,11 +74,50 @@ ThermalReference::unserialize(CheckpointIn &cp)
     UNSERIALIZE_SCALAR(_temperature);
 }
 
-LinearEquation
-ThermalReference::getEquation(ThermalNode * n, unsigned nnodes,
-                              double step) const {
-    // Just return an empty equation
-    return LinearEquation(nnodes);
+void
+ThermalReference::addCoefficients(SparseLinearSystem &ls, double step) const
+{
+    // References have no nodal equation
+}
+
+void
+ThermalReference::addConstants(std::vector<double> &cnt, double step) const
+{
+}
+
+/**
+ * Add the coefficients for a conductance g between two nodes, with the
+ * current into n1 being g * (Tn2 - Tn1) and the opposite into n2.
+ */
+static void
+addConductance(SparseLinearSystem &ls, const ThermalNode *n1,
+               const ThermalNode *n2, double g)
+{
+    if (!n1->isref) {
+        ls.add(n1->id, n1->id, -g);
+        if (!n2->isref)
+            ls.add(n1->id, n2->id, g);
+    }
+
+    if (!n2->isref) {
+        ls.add(n2->id, n2->id, -g);
+        if (!n1->isref)
+            ls.add(n2->id, n1->id, g);
+    }
+}
+
+/**
+ * Add the constant terms for a conductance g between two nodes, which
+ * come from the fixed temperature of the other node if it is a reference.
+ */
+static void
+addConductanceConstants(std::vector<double> &cnt, const ThermalNode *n1,
+                        const ThermalNode *n2, double g)
+{
+    if (!n1->isref && n2->isref)
+        cnt[n1->id] -= g * n2->temp;
+    if (!n2->isref && n1->isref)
+        cnt[n2->id] -= g * n1->temp;
 }
 
 /**
@@ -107,31 +146,17 @@ ThermalResistor::unserialize(CheckpointIn &cp)
     UNSERIALIZE_SCALAR(_resistance);
 }
 
-LinearEquation
-ThermalResistor::getEquation(ThermalNode * n, unsigned nnodes,
-                             double step) const
+void
+ThermalResistor::addCoefficients(SparseLinearSystem &ls, double step) const
 {
-    // i[n] = (Vn2 - Vn1)/R
-    LinearEquation eq(nnodes);
-
-    if (n != node1 && n != node2)
-        return eq;
-
-    if (node1->isref)
-        eq[eq.cnt()] += -node1->temp / _resistance;
-    else
-        eq[node1->id] += -1.0f / _resistance;
-
-    if (node2->isref)
-        eq[eq.cnt()] += node2->temp / _resistance;
-    else
-        eq[node2->id] += 1.0f / _resistance;
-
-    // We've assumed n was node1, reverse if necessary
-    if (n == node2)
-        eq *= -1.0f;
+    // i[n1] = (Vn2 - Vn1)/R
+    addConductance(ls, node1, node2, 1.0 / _resistance);
+}
 
-    return eq;
+void
+ThermalResistor::addConstants(std::vector<double> &cnt, double step) const
+{
+    addConductanceConstants(cnt, node1, node2, 1.0 / _resistance);
 }
 
 /**
@@ -160,34 +185,25 @@ ThermalCapacitor::unserialize(CheckpointIn &cp)
     UNSERIALIZE_SCALAR(_capacitance);
 }
 
-LinearEquation
-ThermalCapacitor::getEquation(ThermalNode * n, unsigned nnodes,
-                              double step) const
+void
+ThermalCapacitor::addCoefficients(SparseLinearSystem &ls, double step) const
 {
     // i(t) = C * d(Vn2 - Vn1)/dt
-    // i[n] = C/step * (Vn2 - Vn1 - Vn2[n-1] + Vn1[n-1])
-    LinearEquation eq(nnodes);
-
-    if (n != node1 && n != node2)
-        return eq;
-
-    eq[eq.cnt()] += _capacitance / step * (node1->temp - node2->temp);
-
-    if (node1->isref)
-        eq[eq.cnt()] += _capacitance / step * (-node1->temp);
-    else
-        eq[node1->id] += -1.0f * _capacitance / step;
-
-    if (node2->isref)
-        eq[eq.cnt()] += _capacitance / step * (node2->temp);
-    else
-        eq[node2->id] += 1.0f * _capacitance / step;
-
-    // We've assumed n was node1, reverse if necessary
-    if (n == node2)
-        eq *= -1.0f;
+    // i[n1] = C/step * (Vn2 - Vn1 - Vn2[n-1] + Vn1[n-1])
+    addConductance(ls, node1, node2, _capacitance / step);
+}
 
-    return eq;
+void
+ThermalCapacitor::addConstants(std::vector<double> &cnt, double step) const
+{
+    const double g = _capacitance / step;
+    addConductanceConstants(cnt, node1, node2, g);
+
+    // The previous temperatures (Vn1[n-1] - Vn2[n-1]) are known
+    if (!node1->isref)
+        cnt[node1->id] -= g * (node1->temp - node2->temp);
+    if (!node2->isref)
+        cnt[node2->id] -= g * (node2->temp - node1->temp);
 }
 
 /**
@@ -220,20 +236,14 @@ void
 ThermalModel::doStep()
 {
     // Calculate new temperatures!
-    // For each node in the system, create the kirchhoff nodal equation
-    LinearSystem ls(eq_nodes.size());
-    for (unsigned i = 0; i < eq_nodes.size(); i++) {
-        auto n = eq_nodes[i];
-        LinearEquation node_equation (eq_nodes.size());
-        for (auto e : entities) {
-            LinearEquation eq = e->getEquation(n, eq_nodes.size(), _step);
-            node_equation = node_equation + eq;
-        }
-        ls[i] = node_equation;
-    }
+    // The coefficients of the kirchhoff nodal equations don't change, so
+    // only their constant terms need to be gathered from the entities.
+    std::vector <double> cnt(eq_nodes.size(), 0.0);
+    for (auto e : entities)
+        e->addConstants(cnt, _step);
 
     // Get temperatures for this iteration
-    std::vector <double> temps = ls.solve();
+    std::vector <double> temps = equations.solve(cnt);
     for (unsigned i = 0; i < eq_nodes.size(); i++)
         eq_nodes[i]->temp = temps[i];
 
@@ -274,6 +284,17 @@ ThermalModel::startup()
     for (unsigned i = 0; i < eq_nodes.size(); i++)
         eq_nodes[i]->id = i;
 
+    // Build the nodal equations and factorize them once, the network
+    // and the step don't change during the simulation
+    equations = SparseLinearSystem(eq_nodes.size());
+    for (auto e : entities)
+        e->addCoefficients(equations, _step);
+    fatal_if(!equations.diagonallyDominant(),
+             "%s: The thermal network equations are not diagonally "
+             "dominant, check for negative resistances or capacitances\n",
+             name());
+    equations.factorize();
+
     // Schedule first thermal update
     schedule(stepEvent, curTick() + SimClock::Int::s * _step);
 }
@@ -47,6 +47,7 @@
 #include "params/ThermalReference.hh"
 #include "params/ThermalResistor.hh"
 #include "sim/clocked_object.hh"
+#include "sim/linear_solver.hh"
 #include "sim/power/thermal_domain.hh"
 #include "sim/power/thermal_entity.hh"
 #include "sim/power/thermal_node.hh"
@@ -72,8 +73,10 @@ class ThermalResistor : public SimObject, public ThermalEntity
         node2 = n2;
     }
 
-    LinearEquation getEquation(ThermalNode * tn, unsigned n,
-                               double step) const override;
+    void addCoefficients(SparseLinearSystem &ls,
+                         double step) const override;
+    void addConstants(std::vector<double> &cnt,
+                      double step) const override;
 
   private:
     /* Resistance value in K/W */
@@ -96,8 +99,10 @@ class ThermalCapacitor : public SimObject, public ThermalEntity
     void serialize(CheckpointOut &cp) const override;
     void unserialize(CheckpointIn &cp) override;
 
-    LinearEquation getEquation(ThermalNode * tn, unsigned n,
-                               double step) const override;
+    void addCoefficients(SparseLinearSystem &ls,
+                         double step) const override;
+    void addConstants(std::vector<double> &cnt,
+                      double step) const override;
 
     void setNodes(ThermalNode * n1, ThermalNode * n2) {
         node1 = n1;
@@ -125,8 +130,10 @@ class ThermalReference : public SimObject, public ThermalEntity
         node = n;
     }
 
-    LinearEquation getEquation(ThermalNode * tn, unsigned n,
-                               double step) const override;
+    void addCoefficients(SparseLinearSystem &ls,
+                         double step) const override;
+    void addConstants(std::vector<double> &cnt,
+                      double step) const override;
 
     void serialize(CheckpointOut &cp) const override;
     void unserialize(CheckpointIn &cp) override;
@@ -180,6 +187,9 @@ class ThermalModel : public ClockedObject
     std::vector <ThermalNode*> nodes;
     std::vector <ThermalNode*> eq_nodes;
 
+    /** Nodal equations, factorized once in startup() */
+    SparseLinearSystem equations;
+
     /** Stepping event to update the model values */
     EventFunctionWrapper stepEvent;
 
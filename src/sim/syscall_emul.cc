@@ -46,6 +46,7 @@
 #include "base/trace.hh"
 #include "config/the_isa.hh"
 #include "cpu/thread_context.hh"
+#include "dev/iommu.hh"
 #include "dev/net/dist_iface.hh"
 #include "mem/page_table.hh"
 #include "sim/byteswap.hh"
@@ -776,6 +777,12 @@ fcntlAladdinHandler(Process *process, ThreadContext *tc)
           mapping.request_code,
           mapping.array_name, sim_base_addr, mapping.size);
 
+    // With an IOMMU, the accelerator can also translate on demand through
+    // the page table of the process. The datapath still translates its
+    // accesses through its own TLB, so the mappings are installed anyway.
+    if (IOMMU *iommu = process->system->getIOMMU())
+        iommu->bindAccelerator(mapping.request_code, process);
+
     // Set up all mappings, taking into account straddling page boundaries.
     Addr starting_page_offset = sim_base_addr & (TheISA::PageBytes - 1);
     int num_pages = ceil(
@@ -794,6 +801,13 @@ fcntlAladdinHandler(Process *process, ThreadContext *tc)
     delete string_buf;
 }
 
+void
+invalidateAcceleratorMappings(const Process *process, Addr vaddr, Addr size)
+{
+    if (IOMMU *iommu = process->system->getIOMMU())
+        iommu->invalidate(process, vaddr, size);
+}
+
 SyscallReturn
 fcntlFunc(SyscallDesc *desc, int num, Process *p, ThreadContext *tc)
 {
@@ -294,6 +294,11 @@ SyscallReturn fcntl64Func(SyscallDesc *desc, int num,
 // Aladdin handler function shared between 32-bit and 64-bit fcntl emulations.
 void fcntlAladdinHandler(Process *process, ThreadContext *tc);
 
+// Drops the IOMMU translations of a range of virtual addresses of a
+// process, if the system has an IOMMU, e.g. when the range is unmapped.
+void invalidateAcceleratorMappings(const Process *process, Addr vaddr,
+                                   Addr size);
+
 /// Target setuid() handler.
 SyscallReturn setuidFunc(SyscallDesc *desc, int num,
                          Process *p, ThreadContext *tc);
@@ -1150,6 +1155,7 @@ mremapFunc(SyscallDesc *desc, int callnum, Process *process, ThreadContext *tc)
                 }
 
                 process->pTable->remap(start, old_length, new_start);
+                invalidateAcceleratorMappings(process, start, old_length);
                 warn("mremapping to new vaddr %08p-%08p, adding %d\n",
                      new_start, new_start + new_length,
                      new_length - old_length);
@@ -1174,6 +1180,7 @@ mremapFunc(SyscallDesc *desc, int callnum, Process *process, ThreadContext *tc)
         if (use_provided_address && provided_address != start)
             process->pTable->remap(start, new_length, provided_address);
         process->pTable->unmap(start + new_length, old_length - new_length);
+        invalidateAcceleratorMappings(process, start, old_length);
         return use_provided_address ? provided_address : start;
     }
 }
@@ -1594,27 +1601,38 @@ readvFunc(SyscallDesc *desc, int callnum, Process *p, ThreadContext *tc)
     SETranslatingPortProxy &prox = tc->getMemProxy();
     uint64_t tiov_base = p->getSyscallArg(tc, index);
     size_t count = p->getSyscallArg(tc, index);
-    typename OS::tgt_iovec tiov[count];
+
+    // Read the whole iovec array at once and receive into one host
+    // buffer, which is then scattered to the target buffers.
+    std::vector<typename OS::tgt_iovec> tiov(count);
+    prox.readBlob(tiov_base, (uint8_t *)tiov.data(),
+                  count * sizeof(typename OS::tgt_iovec));
+
+    std::vector<SETranslatingPortProxy::IoVec> iov(count);
+    size_t total = 0;
+    for (size_t i = 0; i < count; ++i) {
+        iov[i].base = TheISA::gtoh(tiov[i].iov_base);
+        iov[i].len = TheISA::gtoh(tiov[i].iov_len);
+        total += iov[i].len;
+    }
+
+    std::vector<uint8_t> buf(total);
     struct iovec hiov[count];
+    size_t offset = 0;
     for (size_t i = 0; i < count; ++i) {
-        prox.readBlob(tiov_base + (i * sizeof(typename OS::tgt_iovec)),
-                      (uint8_t*)&tiov[i], sizeof(typename OS::tgt_iovec));
-        hiov[i].iov_len = TheISA::gtoh(tiov[i].iov_len);
-        hiov[i].iov_base = new char [hiov[i].iov_len];
+        hiov[i].iov_base = buf.data() + offset;
+        hiov[i].iov_len = iov[i].len;
+        offset += iov[i].len;
     }
 
     int result = readv(sim_fd, hiov, count);
-    int local_errno = errno;
+    if (result == -1)
+        return -errno;
 
-    for (size_t i = 0; i < count; ++i) {
-        if (result != -1) {
-            prox.writeBlob(TheISA::htog(tiov[i].iov_base),
-                           (uint8_t*)hiov[i].iov_base, hiov[i].iov_len);
-        }
-        delete [] (char *)hiov[i].iov_base;
-    }
+    if (!prox.tryWritev(iov, buf.data(), result))
+        return -EFAULT;
 
-    return (result == -1) ? -local_errno : result;
+    return result;
 }
 
 /// Target writev() handler.
@@ -1633,23 +1651,35 @@ writevFunc(SyscallDesc *desc, int callnum, Process *p, ThreadContext *tc)
     SETranslatingPortProxy &prox = tc->getMemProxy();
     uint64_t tiov_base = p->getSyscallArg(tc, index);
     size_t count = p->getSyscallArg(tc, index);
+
+    // Read the whole iovec array at once and gather the target buffers
+    // into one host buffer.
+    std::vector<typename OS::tgt_iovec> tiov(count);
+    prox.readBlob(tiov_base, (uint8_t *)tiov.data(),
+                  count * sizeof(typename OS::tgt_iovec));
+
+    std::vector<SETranslatingPortProxy::IoVec> iov(count);
+    size_t total = 0;
+    for (size_t i = 0; i < count; ++i) {
+        iov[i].base = TheISA::gtoh(tiov[i].iov_base);
+        iov[i].len = TheISA::gtoh(tiov[i].iov_len);
+        total += iov[i].len;
+    }
+
+    std::vector<uint8_t> buf(total);
+    if (!prox.tryReadv(iov, buf.data()))
+        return -EFAULT;
+
     struct iovec hiov[count];
+    size_t offset = 0;
     for (size_t i = 0; i < count; ++i) {
-        typename OS::tgt_iovec tiov;
-
-        prox.readBlob(tiov_base + i*sizeof(typename OS::tgt_iovec),
-                      (uint8_t*)&tiov, sizeof(typename OS::tgt_iovec));
-        hiov[i].iov_len = TheISA::gtoh(tiov.iov_len);
-        hiov[i].iov_base = new char [hiov[i].iov_len];
-        prox.readBlob(TheISA::gtoh(tiov.iov_base), (uint8_t *)hiov[i].iov_base,
-                      hiov[i].iov_len);
+        hiov[i].iov_base = buf.data() + offset;
+        hiov[i].iov_len = iov[i].len;
+        offset += iov[i].len;
     }
 
     int result = writev(sim_fd, hiov, count);
 
-    for (size_t i = 0; i < count; ++i)
-        delete [] (char *)hiov[i].iov_base;
-
     return (result == -1) ? -errno : result;
 }
 
@@ -1890,6 +1920,7 @@ munmapFunc(SyscallDesc *desc, int num, Process *p, ThreadContext *tc)
 
     // Remove entries from the page table.
     p->pTable->unmap(addr, len);
+    invalidateAcceleratorMappings(p, addr, len);
 
     // TODO: With mmap more fully implemented, we might actually be able to
     // reclaim the memory.
@@ -48,6 +48,7 @@
 #include "sim/system.hh"
 
 #include <algorithm>
+#include <iterator>
 
 #include "arch/remote_gdb.hh"
 #include "arch/utility.hh"
@@ -90,6 +91,7 @@ int System::numSystemsRunning = 0;
 System::System(Params *p)
     : MemObject(p), _systemPort("system_port", this),
       multiThread(p->multi_thread),
+      iommu(nullptr),
       pagePtr(0),
       init_param(p->init_param),
       physProxy(_systemPort, p->cache_line_size),
@@ -296,6 +298,38 @@ System::numRunningContexts()
     );
 }
 
+void
+System::registerArrayLabelRegion(int id, const std::string &array_label,
+                                 Addr sim_vaddr, size_t size)
+{
+    if (size == 0)
+        return;
+
+    // Drop the stale regions that the new mapping overlaps: the one that
+    // holds its base, if any, and those that start within it
+    auto it = arrayLabelRegions.upper_bound(sim_vaddr);
+    if (it != arrayLabelRegions.begin() &&
+        std::prev(it)->second.contains(sim_vaddr)) {
+        arrayLabelRegions.erase(std::prev(it));
+    }
+    while (it != arrayLabelRegions.end() && it->first - sim_vaddr < size)
+        it = arrayLabelRegions.erase(it);
+
+    arrayLabelRegions[sim_vaddr] = {id, array_label, sim_vaddr, size};
+    DPRINTF(Aladdin, "Array %s of accelerator %d mapped to [%#x, %#x)\n",
+            array_label, id, sim_vaddr, sim_vaddr + size);
+}
+
+const System::ArrayLabelRegion *
+System::findArrayLabelRegion(Addr vaddr) const
+{
+    auto it = arrayLabelRegions.upper_bound(vaddr);
+    if (it == arrayLabelRegions.begin())
+        return nullptr;
+    --it;
+    return it->second.contains(vaddr) ? &it->second : nullptr;
+}
+
 void
 System::initState()
 {
@@ -47,6 +47,7 @@
 #ifndef __SYSTEM_HH__
 #define __SYSTEM_HH__
 
+#include <map>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -79,6 +80,7 @@
 #endif
 
 class BaseRemoteGDB;
+class IOMMU;
 class KvmVM;
 class ObjectFile;
 class ThreadContext;
@@ -234,6 +236,9 @@ class System : public MemObject
      */
     std::map<int, AccelData*> accelerators;
 
+    /* The IOMMU of the accelerators, if any. */
+    IOMMU *iommu;
+
     /* Returns the number of accelerators that are currently registered and
      * running in the system.
      */
@@ -305,6 +310,19 @@ class System : public MemObject
         scheduleAccelerator(accel_id, 1);
     }
 
+    /* Registers the IOMMU that accelerators can translate through. The
+     * mappings of the arrays are still installed into the datapath TLB up
+     * front.
+     */
+    void registerIOMMU(IOMMU *_iommu)
+    {
+        if (iommu)
+            fatal("Unable to register IOMMU: an IOMMU is already registered.");
+        iommu = _iommu;
+    }
+
+    IOMMU *getIOMMU() const { return iommu; }
+
     /* Add an address tranlation into the datapath TLB for the specified array. */
     void insertAddressTranslationMapping(int id, Addr sim_vaddr, Addr sim_paddr) {
         if (accelerators.find(id) == accelerators.end())
@@ -322,8 +340,36 @@ class System : public MemObject
                   id);
         Gem5Datapath *datapath = accelerators[id]->datapath;
       datapath->insertArrayLabelToVirtual(array_label, sim_vaddr, size);
+        registerArrayLabelRegion(id, array_label, sim_vaddr, size);
     }
 
+    /* A range of simulated virtual addresses that an accelerator has mapped
+     * to one of its array labels.
+     */
+    struct ArrayLabelRegion {
+        int accelId;
+        std::string label;
+        Addr base;
+        size_t size;
+
+        bool contains(Addr vaddr) const
+        {
+            return vaddr >= base && vaddr - base < size;
+        }
+    };
+
+    /* Records the address range of a labelled array so that the memory
+     * system (e.g. array-aware prefetchers) can look it up. A new mapping
+     * replaces any older region that it overlaps.
+     */
+    void registerArrayLabelRegion(int id, const std::string &array_label,
+                                  Addr sim_vaddr, size_t size);
+
+    /* Returns the labelled array containing the given simulated virtual
+     * address, or nullptr if it does not belong to any array.
+     */
+    const ArrayLabelRegion *findArrayLabelRegion(Addr vaddr) const;
+
     /* Get the base trace address of of the array for the specified accelerator. */
     Addr getArrayBaseAddress(int id, const char* array_name) {
         if (accelerators.find(id) == accelerators.end())
@@ -337,6 +383,11 @@ class System : public MemObject
      * system.  These threads could be Active or Suspended. */
     int numRunningContexts();
 
+  protected:
+    /* Labelled array regions, keyed by their base virtual address. */
+    std::map<Addr, ArrayLabelRegion> arrayLabelRegions;
+
+  public:
     Addr pagePtr;
 
     uint64_t init_param;
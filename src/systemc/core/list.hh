@@ -104,8 +104,23 @@ struct NodeList : public ListNode
         prevListNode = t;
     }
 
-    T *getNext() { return dynamic_cast<T *>(nextListNode); }
-    bool empty() { return getNext() == nullptr; }
+    // The list head is the only node which isn't a T, so comparing against
+    // it is enough to tell the end of the list from an element.
+    T *
+    getNext()
+    {
+        return nextListNode == this ?
+            nullptr : static_cast<T *>(nextListNode);
+    }
+
+    T *
+    getLast()
+    {
+        return prevListNode == this ?
+            nullptr : static_cast<T *>(prevListNode);
+    }
+
+    bool empty() { return nextListNode == this; }
 };
 
 } // namespace sc_gem5
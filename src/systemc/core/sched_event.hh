@@ -31,24 +31,23 @@
 #define __SYSTEMC_CORE_SCHED_EVENT_HH__
 
 #include <functional>
-#include <list>
 
 #include "base/types.hh"
+#include "systemc/core/list.hh"
 
 namespace sc_gem5
 {
 
 class ScEvent;
 
-typedef std::list<ScEvent *> ScEvents;
+typedef NodeList<ScEvent> ScEvents;
 
-class ScEvent
+class ScEvent : public ListNode
 {
   private:
     std::function<void()> work;
     Tick _when;
     ScEvents *_events;
-    ScEvents::iterator _it;
 
     friend class Scheduler;
 
@@ -58,16 +57,14 @@ class ScEvent
         when(w);
         assert(!scheduled());
         _events = &events;
-        _events->push_back(this);
-        _it = _events->end();
-        _it--;
+        _events->pushLast(this);
     }
 
     void
     deschedule()
     {
         assert(scheduled());
-        _events->erase(_it);
+        popListNode();
         _events = nullptr;
     }
   public:
@@ -60,6 +60,9 @@ Scheduler::~Scheduler()
     // Clear out everything that belongs to us to make sure nobody tries to
     // clear themselves out after the scheduler goes away.
     clear();
+
+    for (TimeSlot *ts: timeSlotPool)
+        delete ts;
 }
 
 void
@@ -67,14 +70,14 @@ Scheduler::clear()
 {
     // Delta notifications.
     while (!deltas.empty())
-        deltas.front()->deschedule();
+        deltas.getNext()->deschedule();
 
     // Timed notifications.
-    for (auto &tsp: timeSlots) {
-        TimeSlot *&ts = tsp.second;
+    for (TimeSlot *ts: timeSlots) {
         while (!ts->events.empty())
-            ts->events.front()->deschedule();
+            ts->events.getNext()->deschedule();
         deschedule(ts);
+        freeTimeSlot(ts);
     }
     timeSlots.clear();
 
@@ -277,6 +280,19 @@ Scheduler::scheduleStarvationEvent()
 
 void
 Scheduler::runReady()
+{
+    // As long as the next delta cycle would be the very next thing the
+    // event queue ran, start it here and save the round trip through the
+    // queue. Anything else due at this time, like a pause, stop, or gem5
+    // event, will be at the head of the queue instead and stop the batch.
+    while (runDeltaCycle() && readyEvent.scheduled() &&
+            eq->getHead() == &readyEvent) {
+        eq->deschedule(&readyEvent);
+    }
+}
+
+bool
+Scheduler::runDeltaCycle()
 {
     scheduleTimeAdvancesEvent();
 
@@ -297,7 +313,7 @@ Scheduler::runReady()
 
     if (_stopNow) {
         status(StatusOther);
-        return;
+        return false;
     }
 
     runUpdate();
@@ -312,6 +328,7 @@ Scheduler::runReady()
         schedulePause();
 
     status(StatusOther);
+    return true;
 }
 
 void
@@ -338,7 +355,7 @@ Scheduler::runDelta()
 
     try {
         while (!deltas.empty())
-            deltas.back()->run();
+            deltas.getLast()->run();
     } catch (...) {
         throwToScMain();
     }
@@ -30,6 +30,8 @@
 #ifndef __SYSTEMC_CORE_SCHEDULER_HH__
 #define __SYSTEMC_CORE_SCHEDULER_HH__
 
+#include <algorithm>
+#include <deque>
 #include <functional>
 #include <map>
 #include <set>
@@ -103,16 +105,23 @@ typedef NodeList<Channel> ChannelList;
  *
  * If any processes became runnable during the delta notification phase, the
  * readyEvent will have been scheduled and will be waiting and ready to run
- * again, effectively starting the next delta cycle.
+ * again, effectively starting the next delta cycle. If nothing else in the
+ * event queue would run before it, the readyEvent starts that delta cycle
+ * immediately rather than going back through the event queue.
  *
  * TIMED NOTIFICATION PHASE
  *
  * If no processes became runnable, the event queue will continue to process
  * events until it comes across an event which represents all the timed
  * notifications which are supposed to happen at a particular time. The object
- * which tracks them will execute all those notifications, and then destroy
- * itself. If the readyEvent is now ready to run, the next delta cycle will
- * start.
+ * which tracks them will execute all those notifications, and then go back
+ * to the scheduler's pool of time slots to be reused. If the readyEvent is
+ * now ready to run, the next delta cycle will start.
+ *
+ * Pending time slots are kept in a deque sorted by time. New notifications
+ * are almost always for the latest time or a time which already has a slot,
+ * and slots are always retired from the front, so this avoids the node
+ * allocations and rebalancing a map would do for every time step.
  *
  * PAUSE/STOP
  *
@@ -147,18 +156,17 @@ typedef NodeList<Channel> ChannelList;
 class Scheduler
 {
   public:
-    typedef std::list<ScEvent *> ScEvents;
-
     class TimeSlot : public ::Event
     {
       public:
-        TimeSlot() : ::Event(Default_Pri, AutoDelete) {}
+        TimeSlot() : ::Event(Default_Pri), tick(MaxTick) {}
 
+        Tick tick;
         ScEvents events;
         void process();
     };
 
-    typedef std::map<Tick, TimeSlot *> TimeSlots;
+    typedef std::deque<TimeSlot *> TimeSlots;
 
     Scheduler();
     ~Scheduler();
@@ -249,10 +257,18 @@ class Scheduler
         }
 
         // Timed notification/timeout.
-        TimeSlot *&ts = timeSlots[tick];
-        if (!ts) {
-            ts = new TimeSlot;
-            schedule(ts, tick);
+        TimeSlot *ts;
+        if (timeSlots.empty() || timeSlots.back()->tick < tick) {
+            ts = allocTimeSlot(tick);
+            timeSlots.push_back(ts);
+        } else {
+            auto tsit = findTimeSlot(tick);
+            if (tsit == timeSlots.end() || (*tsit)->tick != tick) {
+                ts = allocTimeSlot(tick);
+                timeSlots.insert(tsit, ts);
+            } else {
+                ts = *tsit;
+            }
         }
         event->schedule(ts->events, tick);
     }
@@ -269,10 +285,10 @@ class Scheduler
         }
 
         // Timed notification/timeout.
-        auto tsit = timeSlots.find(event->when());
-        panic_if(tsit == timeSlots.end(),
+        auto tsit = findTimeSlot(event->when());
+        panic_if(tsit == timeSlots.end() || (*tsit)->tick != event->when(),
                 "Descheduling event at time with no events.");
-        TimeSlot *ts = tsit->second;
+        TimeSlot *ts = *tsit;
         ScEvents &events = ts->events;
         assert(on == &events);
         event->deschedule();
@@ -281,14 +297,16 @@ class Scheduler
         if (events.empty()) {
             deschedule(ts);
             timeSlots.erase(tsit);
+            freeTimeSlot(ts);
         }
     }
 
     void
     completeTimeSlot(TimeSlot *ts)
     {
-        assert(ts == timeSlots.begin()->second);
-        timeSlots.erase(timeSlots.begin());
+        assert(!timeSlots.empty() && ts == timeSlots.front());
+        timeSlots.pop_front();
+        freeTimeSlot(ts);
         if (!runToTime && starved())
             scheduleStarvationEvent();
         scheduleTimeAdvancesEvent();
@@ -323,7 +341,7 @@ class Scheduler
         if (pendingCurr())
             return 0;
         if (pendingFuture())
-            return timeSlots.begin()->first - getCurTick();
+            return timeSlots.front()->tick - getCurTick();
         return MaxTick - getCurTick();
     }
 
@@ -407,6 +425,41 @@ class Scheduler
 
     ScEvents deltas;
     TimeSlots timeSlots;
+    std::vector<TimeSlot *> timeSlotPool;
+
+    // Find the first pending time slot at or after tick.
+    TimeSlots::iterator
+    findTimeSlot(Tick tick)
+    {
+        return std::lower_bound(timeSlots.begin(), timeSlots.end(), tick,
+                [](const TimeSlot *ts, Tick t) { return ts->tick < t; });
+    }
+
+    // Get a time slot for tick, reusing a retired one if possible, and
+    // schedule it. The caller is responsible for putting it in timeSlots.
+    TimeSlot *
+    allocTimeSlot(Tick tick)
+    {
+        TimeSlot *ts;
+        if (timeSlotPool.empty()) {
+            ts = new TimeSlot;
+        } else {
+            ts = timeSlotPool.back();
+            timeSlotPool.pop_back();
+        }
+        ts->tick = tick;
+        schedule(ts, tick);
+        return ts;
+    }
+
+    // Return a time slot which is no longer scheduled to the pool.
+    void
+    freeTimeSlot(TimeSlot *ts)
+    {
+        assert(ts->events.empty());
+        ts->tick = MaxTick;
+        timeSlotPool.push_back(ts);
+    }
 
     Process *
     getNextReady()
@@ -416,6 +469,7 @@ class Scheduler
     }
 
     void runReady();
+    bool runDeltaCycle();
     EventWrapper<Scheduler, &Scheduler::runReady> readyEvent;
     void scheduleReadyEvent();
 
@@ -431,7 +485,7 @@ class Scheduler
     {
         return (readyListMethods.empty() && readyListThreads.empty() &&
                 updateList.empty() && deltas.empty() &&
-                (timeSlots.empty() || timeSlots.begin()->first > maxTick) &&
+                (timeSlots.empty() || timeSlots.front()->tick > maxTick) &&
                 initList.empty());
     }
     EventWrapper<Scheduler, &Scheduler::pause> starvationEvent;
@@ -499,7 +553,7 @@ Scheduler::TimeSlot::process()
 
     try {
         while (!events.empty())
-            events.front()->run();
+            events.getNext()->run();
     } catch (...) {
         if (events.empty())
             scheduler.completeTimeSlot(this);
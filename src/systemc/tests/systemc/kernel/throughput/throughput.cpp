@@ -0,0 +1,146 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * A throughput benchmark for the SystemC kernel. A set of timers with
+ * periods from 1 to 8 ns keeps many time slots pending at once, and a chain
+ * of signals driven once per ns forces a long run of back to back delta
+ * cycles at every time step. Only the activity counts go to stdout so the
+ * output can be checked against the golden log. The time the kernel took is
+ * reported on stderr.
+ */
+
+#include <chrono>
+
+#include "systemc.h"
+
+static const int NumTimers = 64;
+static const int ChainDepth = 16;
+static const int Iterations = 100;
+// The least common multiple of all the timer periods, so every timer runs
+// a whole number of times.
+static const int RunNs = 840 * Iterations;
+
+SC_MODULE(Timer)
+{
+    SC_HAS_PROCESS(Timer);
+    Timer(sc_module_name name, int period) : period(period), count(0)
+    {
+        SC_METHOD(tick);
+        sensitive << ev;
+    }
+
+    void
+    tick()
+    {
+        count++;
+        ev.notify(period, SC_NS);
+    }
+
+    sc_event ev;
+    int period;
+    unsigned long count;
+};
+
+SC_MODULE(Stage)
+{
+    SC_CTOR(Stage) : count(0)
+    {
+        SC_METHOD(propagate);
+        sensitive << in;
+        dont_initialize();
+    }
+
+    void
+    propagate()
+    {
+        count++;
+        out.write(in.read());
+    }
+
+    sc_in<int> in;
+    sc_out<int> out;
+    unsigned long count;
+};
+
+SC_MODULE(Driver)
+{
+    SC_CTOR(Driver)
+    {
+        SC_THREAD(drive);
+    }
+
+    void
+    drive()
+    {
+        for (;;) {
+            out.write(out.read() + 1);
+            wait(1, SC_NS);
+        }
+    }
+
+    sc_out<int> out;
+};
+
+int
+sc_main(int argc, char *argv[])
+{
+    Timer *timers[NumTimers];
+    for (int i = 0; i < NumTimers; i++) {
+        timers[i] = new Timer(sc_gen_unique_name("timer"), (i % 8) + 1);
+    }
+
+    sc_signal<int> chain[ChainDepth + 1];
+    Driver driver("driver");
+    driver.out(chain[0]);
+    Stage *stages[ChainDepth];
+    for (int i = 0; i < ChainDepth; i++) {
+        stages[i] = new Stage(sc_gen_unique_name("stage"));
+        stages[i]->in(chain[i]);
+        stages[i]->out(chain[i + 1]);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    sc_start(RunNs, SC_NS);
+    auto end = std::chrono::steady_clock::now();
+
+    unsigned long timer_count = 0;
+    for (int i = 0; i < NumTimers; i++)
+        timer_count += timers[i]->count;
+    unsigned long stage_count = 0;
+    for (int i = 0; i < ChainDepth; i++)
+        stage_count += stages[i]->count;
+
+    cout << "timer activations: " << timer_count << endl;
+    cout << "stage activations: " << stage_count << endl;
+    cout << "chain output: " << chain[ChainDepth].read() << endl;
+
+    double secs = std::chrono::duration<double>(end - start).count();
+    cerr << "delta cycles: " << sc_delta_count() << endl;
+    cerr << "kernel time: " << secs << " s, " <<
+        (timer_count + stage_count) / secs << " activations/s" << endl;
+
+    return 0;
+}
@@ -0,0 +1,76 @@
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+
+'''
+Runs a program with an IOMMUTester bound to its process. The tester
+translates addresses of the process through the IOMMU and exits once
+IOTLB hits, page walks, walk coalescing, faults and invalidations all
+behaved as expected.
+'''
+
+from __future__ import print_function
+
+import argparse
+
+import m5
+from m5.objects import *
+
+parser = argparse.ArgumentParser()
+parser.add_argument('--cmd', required=True, help='Binary to run')
+args = parser.parse_args()
+
+system = System()
+system.clk_domain = SrcClockDomain(clock='1GHz',
+                                   voltage_domain=VoltageDomain())
+system.mem_mode = 'timing'
+system.mem_ranges = [AddrRange('512MB')]
+
+system.cpu = TimingSimpleCPU()
+system.membus = SystemXBar()
+system.cpu.icache_port = system.membus.slave
+system.cpu.dcache_port = system.membus.slave
+
+system.cpu.createInterruptController()
+if m5.defines.buildEnv['TARGET_ISA'] == 'x86':
+    system.cpu.interrupts[0].pio = system.membus.master
+    system.cpu.interrupts[0].int_master = system.membus.slave
+    system.cpu.interrupts[0].int_slave = system.membus.master
+
+system.mem_ctrl = SimpleMemory(range=system.mem_ranges[0])
+system.mem_ctrl.port = system.membus.master
+system.system_port = system.membus.slave
+
+process = Process(cmd=[args.cmd])
+system.cpu.workload = process
+system.cpu.createThreads()
+
+# Fewer walkers than pages, so some walks have to wait for a walker
+system.iommu = IOMMU(num_walkers=2)
+system.iommu_tester = IOMMUTester(iommu=system.iommu, workload=process)
+
+root = Root(full_system=False, system=system)
+m5.instantiate()
+exit_event = m5.simulate()
+print('Exiting @ tick %i because %s' % (m5.curTick(),
+                                        exit_event.getCause()))
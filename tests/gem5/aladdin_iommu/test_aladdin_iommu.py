@@ -0,0 +1,78 @@
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+
+'''
+Drives the IOMMU with an IOMMUTester next to hello, checking its
+translations against the page table of the process.
+
+Also runs the Aladdin with-cpu integration tests with an IOMMU in the
+system. The accelerators must still get their arrays mapped into their
+TLBs and run to completion. The tests live in the aladdin submodule, and
+their binaries must have been built (make gem5-accel) beforehand.
+'''
+import os
+
+from testlib import *
+
+for isa in ('x86', 'arm'):
+    hello_program = DownloadedProgram(
+            os.path.join('hello', 'bin', isa, 'linux'), 'hello64-static')
+
+    gem5_verify_config(
+            name='test_iommu_tester_' + isa,
+            fixtures=(hello_program,),
+            verifiers=(verifier.MatchRegex(
+                'Exiting @ tick [0-9]+ because IOMMU test passed'),),
+            config=joinpath(getcwd(), 'iommu_tester.py'),
+            config_args=['--cmd', hello_program.path],
+            valid_isas=(isa.upper(),),
+    )
+
+tests_dir = joinpath(config.base_dir, 'src', 'aladdin', 'integration-test',
+                     'with-cpu')
+
+for test_name in ('test_load_store', 'test_dma_load_store'):
+    test_dir = joinpath(tests_dir, test_name)
+    binary = joinpath(test_dir, test_name + '-gem5-accel')
+    if not os.path.exists(binary):
+        continue
+
+    verifiers = (
+            verifier.MatchRegex(
+                'Exiting @ tick [0-9]+ because exiting with last active '
+                'thread context'),
+    )
+
+    gem5_verify_config(
+            name='test_' + test_name + '_iommu',
+            verifiers=verifiers,
+            config=joinpath(config.base_dir, 'configs', 'aladdin',
+                            'aladdin_se.py'),
+            config_args=['--num-cpus=1', '--mem-size=4GB',
+                         '--cpu-type=TimingSimpleCPU', '--caches',
+                         '--cacheline_size=32', '--iommu',
+                         '--accel_cfg_file=' + joinpath(test_dir, 'gem5.cfg'),
+                         '-c', binary],
+            valid_isas=('X86',),
+    )
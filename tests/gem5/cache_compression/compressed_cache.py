@@ -0,0 +1,120 @@
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+
+'''
+Runs a program on a system with a compressed L1 data cache, then checks
+that the sizes reported by the compressor are consistent: every compressed
+block fits in a block, the size histogram accounts for every compression,
+and data that is mostly zeros is actually compressed.
+'''
+
+from __future__ import print_function
+
+import argparse
+import os
+import re
+import sys
+
+import m5
+from m5.objects import *
+
+parser = argparse.ArgumentParser()
+parser.add_argument('--cmd', required=True, help='Binary to run')
+parser.add_argument('--compressor', required=True,
+                    choices=('BDI', 'FPC', 'CPack'), help='Cache compressor')
+args = parser.parse_args()
+
+system = System()
+system.clk_domain = SrcClockDomain(clock='1GHz',
+                                   voltage_domain=VoltageDomain())
+system.mem_mode = 'timing'
+system.mem_ranges = [AddrRange('512MB')]
+system.cache_line_size = 64
+
+system.cpu = TimingSimpleCPU()
+system.membus = SystemXBar()
+
+system.cpu.dcache = Cache(size='4kB', assoc=4, tag_latency=2,
+                          data_latency=2, response_latency=2, mshrs=4,
+                          tgts_per_mshr=20, tags=CompressedTags(),
+                          compressor=getattr(m5.objects, args.compressor)())
+system.cpu.dcache_port = system.cpu.dcache.cpu_side
+system.cpu.dcache.mem_side = system.membus.slave
+system.cpu.icache_port = system.membus.slave
+
+system.cpu.createInterruptController()
+if m5.defines.buildEnv['TARGET_ISA'] == 'x86':
+    system.cpu.interrupts[0].pio = system.membus.master
+    system.cpu.interrupts[0].int_master = system.membus.slave
+    system.cpu.interrupts[0].int_slave = system.membus.master
+
+system.mem_ctrl = SimpleMemory(range=system.mem_ranges[0])
+system.mem_ctrl.port = system.membus.master
+system.system_port = system.membus.slave
+
+process = Process(cmd=[args.cmd])
+system.cpu.workload = process
+system.cpu.createThreads()
+
+root = Root(full_system=False, system=system)
+m5.instantiate()
+m5.simulate()
+m5.stats.dump()
+
+# Gather the compressor's stats
+prefix = 'system.cpu.dcache.compressor.'
+stats = {}
+with open(os.path.join(m5.options.outdir, 'stats.txt')) as stats_file:
+    for line in stats_file:
+        fields = line.split()
+        if len(fields) >= 2 and fields[0].startswith(prefix):
+            stats[fields[0][len(prefix):]] = float(fields[1])
+
+def check(condition, message):
+    if not condition:
+        print('Compressed size check failed: %s' % message)
+        sys.exit(1)
+
+block_bits = system.cache_line_size.value * 8
+compressions = stats.get('compressions', 0)
+check(compressions > 0, 'no block was compressed')
+
+histogram = {}
+for name, value in stats.items():
+    match = re.match(r'compression_size::(\d+)$', name)
+    if match:
+        histogram[int(match.group(1))] = value
+check(all(size <= block_bits for size in histogram),
+      'a block was compressed to more than %d bits' % block_bits)
+check(sum(histogram.values()) == compressions,
+      'the size histogram does not account for every compression')
+
+total_bits = stats['compression_size_bits']
+check(total_bits <= compressions * block_bits,
+      'the total compressed size exceeds the uncompressed size')
+check(any(size < block_bits for size in histogram),
+      'no block was compressed below the block size')
+
+print('Compressed sizes of %s verified: %d compressions, %.1f bits on '
+      'average' % (args.compressor, compressions, total_bits / compressions))
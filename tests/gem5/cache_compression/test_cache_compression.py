@@ -0,0 +1,52 @@
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+
+'''
+Runs hello with a compressed data cache for every compressor and checks
+the compressed sizes the compressor reports.
+'''
+from testlib import *
+
+compressors = ('BDI', 'FPC', 'CPack')
+
+for isa in ('x86', 'arm'):
+    import os
+    path = os.path.join('hello', 'bin', isa, 'linux')
+    hello_program = DownloadedProgram(path, 'hello64-static')
+
+    for compressor in compressors:
+        verifiers = (
+                verifier.MatchRegex(
+                    '^Compressed sizes of %s verified' % compressor),
+        )
+
+        gem5_verify_config(
+                name='test_compressed_cache_' + compressor + '_' + isa,
+                fixtures=(hello_program,),
+                verifiers=verifiers,
+                config=joinpath(getcwd(), 'compressed_cache.py'),
+                config_args=['--cmd', hello_program.path,
+                             '--compressor', compressor],
+                valid_isas=(isa.upper(),),
+        )
@@ -0,0 +1,85 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Translation heavy microbenchmark for the TLB organizations. It
+ * touches one byte on each of a number of pages, in a sequential, a
+ * strided and a pseudo-random order, so that nearly every access needs
+ * a translation. Run it in SE mode with X86TLB.assoc set to 0 and to a
+ * set-associative configuration, and compare the host time and the TLB
+ * stats of the two runs.
+ *
+ * usage: tlb-stress [pages [rounds]]
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define PAGE_SIZE 4096
+
+int main(int argc, char* argv[])
+{
+    unsigned long pages = argc > 1 ? strtoul(argv[1], NULL, 0) : 4096;
+    unsigned long rounds = argc > 2 ? strtoul(argv[2], NULL, 0) : 16;
+    unsigned long i, r;
+    uint64_t sum = 0, lfsr = 1;
+
+    if (pages == 0 || (pages & (pages - 1))) {
+        fprintf(stderr, "The number of pages must be a power of 2\n");
+        return 1;
+    }
+
+    volatile unsigned char *buf = malloc(pages * PAGE_SIZE);
+    if (!buf) {
+        fprintf(stderr, "Could not allocate %lu pages\n", pages);
+        return 1;
+    }
+
+    for (i = 0; i < pages; i++)
+        buf[i * PAGE_SIZE] = (unsigned char)i;
+
+    for (r = 0; r < rounds; r++) {
+        // sequential pages
+        for (i = 0; i < pages; i++)
+            sum += buf[i * PAGE_SIZE];
+
+        // a stride of 17 pages visits every page once
+        for (i = 0; i < pages; i++)
+            sum += buf[((i * 17) & (pages - 1)) * PAGE_SIZE];
+
+        // pseudo-random pages
+        for (i = 0; i < pages; i++) {
+            lfsr ^= lfsr << 13;
+            lfsr ^= lfsr >> 7;
+            lfsr ^= lfsr << 17;
+            sum += buf[(lfsr & (pages - 1)) * PAGE_SIZE];
+        }
+    }
+
+    printf("%lu pages, %lu rounds, checksum %llu\n", pages, rounds,
+           (unsigned long long)sum);
+    return 0;
+}
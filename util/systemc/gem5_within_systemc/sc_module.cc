@@ -80,7 +80,7 @@ setTickFrequency()
 }
 
 Module::Module(sc_core::sc_module_name name) : sc_core::sc_channel(name),
-    in_simulate(false)
+    in_simulate(false), quantum(0)
 {
     SC_METHOD(eventLoop);
     sensitive << eventLoopEnterEvent;
@@ -118,11 +118,13 @@ Module::catchup()
     Tick systemc_time = sc_core::sc_time_stamp().value();
     Tick gem5_time = curTick();
 
-    /* gem5 time *must* lag SystemC as SystemC is the master */
-    fatal_if(gem5_time > systemc_time, "gem5 time must lag SystemC time"
-        " gem5: %d SystemC: %d", gem5_time, systemc_time);
+    /* gem5 time *must* lag SystemC as SystemC is the master, unless it
+     * is running ahead within the decoupling quantum */
+    fatal_if(gem5_time > systemc_time + quantum, "gem5 time must lag"
+        " SystemC time gem5: %d SystemC: %d", gem5_time, systemc_time);
 
-    eventq->setCurTick(systemc_time);
+    if (gem5_time < systemc_time)
+        eventq->setCurTick(systemc_time);
 
     if (!eventq->empty()) {
         Tick next_event_time M5_VAR_USED = eventq->nextTick();
@@ -208,16 +210,23 @@ Module::eventLoop()
         catchup();
 
         Tick gem5_time = curTick();
+        Tick systemc_time = sc_core::sc_time_stamp().value();
 
         /* Woken up early */
-        if (wait_exit_time > sc_core::sc_time_stamp().value()) {
+        if (wait_exit_time > systemc_time) {
             DPRINTF(Event, "Woken up early\n");
-            wait_exit_time = sc_core::sc_time_stamp().value();
+            wait_exit_time = systemc_time;
         }
 
-        if (gem5_time < next_event_time) {
-            Tick wait_period = next_event_time - gem5_time;
-            wait_exit_time = gem5_time + wait_period;
+        /* Without decoupling only events at the current time are due,
+         * otherwise everything up to the end of the current quantum is */
+        Tick horizon = systemc_time;
+        if (quantum)
+            horizon += quantum - systemc_time % quantum - 1;
+
+        if (next_event_time > horizon) {
+            Tick wait_period = next_event_time - systemc_time;
+            wait_exit_time = next_event_time;
 
             DPRINTF(Event, "Waiting for %d ticks for next gem5 event\n",
                 wait_period);
@@ -229,8 +238,6 @@ Module::eventLoop()
 
             return;
         } else if (gem5_time > next_event_time) {
-            Tick systemc_time = sc_core::sc_time_stamp().value();
-
             /* Missed event, for some reason the above test didn't work
              *  or an event was scheduled in the past */
             fatal("Missed an event at time %d gem5: %d, SystemC: %d",
@@ -81,6 +81,12 @@ namespace Gem5SystemC
  *  curTick can lag SystemC time, be exactly the same time but *never*
  *  lead SystemC time.
  *
+ *  The exception is temporal decoupling. If a quantum is set, gem5
+ *  services all its events up to the end of the current quantum without
+ *  yielding, like a SystemC initiator using a quantum keeper. curTick can
+ *  then lead SystemC time by up to the quantum and callers into gem5 have
+ *  to treat the difference as a local time offset.
+ *
  *  This functionality is wrapped in an sc_module as its intended that
  *  the a class representing top level simulation control should be derived
  *  from this class. */
@@ -104,6 +110,10 @@ class Module : public sc_core::sc_channel
      *  the simulate loop */
     bool in_simulate;
 
+    /** Temporal decoupling quantum, 0 if gem5 never runs ahead of
+     *  SystemC */
+    Tick quantum;
+
     /** Placeholder base class for a variant event queue if this becomes
      *  useful */
     class SCEventQueue : public EventQueue
@@ -139,6 +149,9 @@ class Module : public sc_core::sc_channel
     /** Catch gem5 time up with SystemC */
     void catchup();
 
+    /** Set the temporal decoupling quantum */
+    void setQuantum(Tick q) { quantum = q; }
+
     /** Notify an externalSchedulingEvent at the given time from the
      *  current SystemC time */
     void notify(sc_core::sc_time time_from_now = sc_core::SC_ZERO_TIME);
@@ -97,6 +97,7 @@ SCMasterPort::SCMasterPort(const std::string& name_,
 {
     system =
         dynamic_cast<const ExternalMasterParams*>(owner_.params())->system;
+    system->getPhysMem().addWriteObserver(this);
 }
 
 void
@@ -128,6 +129,8 @@ SCMasterPort::bindToTransactor(Gem5MasterTransactor* transactor)
 
     transactor->socket.register_transport_dbg(this,
                                               &SCMasterPort::transport_dbg);
+    transactor->socket.register_get_direct_mem_ptr(this,
+                                    &SCMasterPort::get_direct_mem_ptr);
 }
 
 void
@@ -287,6 +290,7 @@ SCMasterPort::b_transport(tlm::tlm_generic_payload& trans,
     if (extension != nullptr)
         destroyPacket(pkt);
 
+    trans.set_dmi_allowed(dmiAllowed(trans.get_address()));
     trans.set_response_status(tlm::TLM_OK_RESPONSE);
 }
 
@@ -314,9 +318,79 @@ bool
 SCMasterPort::get_direct_mem_ptr(tlm::tlm_generic_payload& trans,
                                tlm::tlm_dmi& dmi_data)
 {
+    Addr addr = trans.get_address();
+
+    if (!dmiAllowed(addr))
+        return false;
+
+    for (const auto& entry : system->getPhysMem().getBackingStore()) {
+        if (!entry.inAddrMap || !entry.range.contains(addr))
+            continue;
+
+        // Accesses to gem5 memories take no time in atomic mode, so the
+        // latencies are left at zero.
+        dmi_data.set_dmi_ptr(entry.pmem);
+        dmi_data.set_start_address(entry.range.start());
+        dmi_data.set_end_address(entry.range.end());
+        dmi_data.allow_read_write();
+
+        bool granted = false;
+        for (const auto& range : dmiRanges)
+            granted = granted || range.start() == entry.range.start();
+        if (!granted)
+            dmiRanges.push_back(entry.range);
+
+        return true;
+    }
+
     return false;
 }
 
+bool
+SCMasterPort::dmiAllowed(Addr addr)
+{
+    // Host pointers bypass the gem5 memory system, so they can only be
+    // handed out while no cache may hold a copy of the data. Regions
+    // granted earlier are revoked when gem5 resumes from a drain.
+    return system->bypassCaches() && system->getPhysMem().isMemAddr(addr);
+}
+
+void
+SCMasterPort::invalidateDmi(Addr start, Addr end)
+{
+    AddrRange range(start, end);
+
+    auto it = dmiRanges.begin();
+    while (it != dmiRanges.end()) {
+        if (it->intersects(range)) {
+            transactor->socket->invalidate_direct_mem_ptr(it->start(),
+                                                          it->end());
+            it = dmiRanges.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void
+SCMasterPort::memWrite(PacketPtr pkt)
+{
+    // Writes through this port come from the initiators, which know
+    // about them
+    if (dmiRanges.empty() || pkt->req->masterId() == owner.masterId)
+        return;
+
+    invalidateDmi(pkt->getAddr(), pkt->getAddr() + pkt->getSize() - 1);
+}
+
+void
+SCMasterPort::drainResume()
+{
+    // gem5 only switches memory modes while drained, so the regions
+    // granted so far may no longer bypass the caches
+    invalidateDmi();
+}
+
 bool
 SCMasterPort::recvTimingResp(PacketPtr pkt)
 {
@@ -370,6 +444,7 @@ SCMasterPort::sendBeginResp(tlm::tlm_generic_payload& trans,
 {
     tlm::tlm_phase phase = tlm::BEGIN_RESP;
 
+    trans.set_dmi_allowed(dmiAllowed(trans.get_address()));
     trans.set_response_status(tlm::TLM_OK_RESPONSE);
 
     auto status = transactor->socket->nb_transport_bw(trans, phase, delay);
@@ -408,6 +483,9 @@ SCMasterPort::recvReqRetry()
 void
 SCMasterPort::recvRangeChange()
 {
+    // Granted regions may no longer map to the same memory
+    invalidateDmi();
+
     SC_REPORT_WARNING("SCMasterPort",
                       "received address range change but ignored it");
 }
@@ -39,9 +39,13 @@
 
 #include <systemc>
 #include <tlm>
+#include <vector>
 
+#include "base/addr_range.hh"
+#include "mem/abstract_mem.hh"
 #include "mem/external_master.hh"
 #include "sc_peq.hh"
+#include "sim/drain.hh"
 #include "sim_control.hh"
 
 namespace Gem5SystemC
@@ -72,8 +76,17 @@ class Gem5MasterTransactor;
  * interface. Then, the transactor automatically translated blocking requests.
  * It is assumed that the mode (atomic/timing) does not change during
  * execution.
+ *
+ * When gem5 bypasses its caches (atomic_noncaching), the port grants direct
+ * memory interface (DMI) pointers into the backing store of gem5's memories.
+ * To let initiators drop derived state (e.g. decoded instructions), the port
+ * observes the writes to gem5's memories and invalidates any granted region
+ * that another gem5 master writes to. All regions are also invalidated when
+ * the address map changes and whenever gem5 resumes from a drain, which is
+ * when its memory mode can change.
  */
-class SCMasterPort : public ExternalMaster::Port
+class SCMasterPort : public ExternalMaster::Port, public MemWriteObserver,
+                     public Drainable
 {
   private:
     struct TlmSenderState : public Packet::SenderState
@@ -101,6 +114,9 @@ class SCMasterPort : public ExternalMaster::Port
 
     Gem5SimControl& simControl;
 
+    /** Regions of the backing store handed out through DMI */
+    std::vector<AddrRange> dmiRanges;
+
   protected:
     // payload event call back
     void peq_cb(tlm::tlm_generic_payload& trans, const tlm::tlm_phase& phase);
@@ -119,6 +135,13 @@ class SCMasterPort : public ExternalMaster::Port
     void recvReqRetry();
     void recvRangeChange();
 
+    // Invalidate DMI on writes by other masters
+    void memWrite(PacketPtr pkt) override;
+
+    // Drainable interface
+    DrainState drain() override { return DrainState::Drained; }
+    void drainResume() override;
+
   public:
     SCMasterPort(const std::string& name_,
                  const std::string& systemc_name,
@@ -141,6 +164,13 @@ class SCMasterPort : public ExternalMaster::Port
     void destroyPacket(PacketPtr pkt);
 
     void checkTransaction(tlm::tlm_generic_payload& trans);
+
+    /** Can DMI be granted for this address? */
+    bool dmiAllowed(Addr addr);
+    /** Invalidate all granted regions overlapping [start, end] */
+    void invalidateDmi(Addr start, Addr end);
+    /** Invalidate all granted regions */
+    void invalidateDmi() { invalidateDmi(0, MaxAddr); }
 };
 
 class SCMasterPortHandler : public ExternalMaster::Handler
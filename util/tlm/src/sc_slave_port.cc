@@ -86,7 +86,6 @@ packet2payload(PacketPtr packet, tlm::tlm_generic_payload &trans)
 Tick
 SCSlavePort::recvAtomic(PacketPtr packet)
 {
-    CAUGHT_UP;
     SC_REPORT_INFO("SCSlavePort", "recvAtomic hasn't been tested much");
 
     panic_if(packet->cacheResponding(), "Should not see packets where cache "
@@ -96,8 +95,15 @@ SCSlavePort::recvAtomic(PacketPtr packet)
              "Should only see read and writes at TLM memory\n");
 
 
-    sc_core::sc_time delay = sc_core::SC_ZERO_TIME;
-
+    /*
+     * With temporal decoupling gem5 may be ahead of SystemC. Pass the
+     * difference on as the local time offset of the transaction, just like
+     * an initiator using a quantum keeper would.
+     */
+    Tick systemc_time = sc_core::sc_time_stamp().value();
+    sc_assert(curTick() >= systemc_time);
+    auto offset = sc_core::sc_time::from_value(curTick() - systemc_time);
+    sc_core::sc_time delay = offset;
 
     /* Prepare the transaction */
     tlm::tlm_generic_payload * trans = mm.allocate();
@@ -127,7 +133,11 @@ SCSlavePort::recvAtomic(PacketPtr packet)
 
     trans->release();
 
-    return delay.value();
+    /*
+     * sc_time is unsigned, so a target that lowered the annotated delay
+     * below the offset it was given must not wrap to a huge latency.
+     */
+    return delay > offset ? (delay - offset).value() : 0;
 }
 
 /**
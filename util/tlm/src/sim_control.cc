@@ -67,7 +67,8 @@ Gem5SimControl::Gem5SimControl(sc_core::sc_module_name name,
                                uint64_t simulationEnd,
                                const std::string& gem5DebugFlags)
   : Gem5SystemC::Module(name),
-    simulationEnd(simulationEnd)
+    simulationEnd(simulationEnd),
+    tlmQuantum(0)
 {
     SC_THREAD(run);
 
@@ -148,6 +149,35 @@ Gem5SimControl::end_of_elaboration()
             << e.name << ": " << e.message << "\n";
         std::exit(EXIT_FAILURE);
     }
+
+    /*
+     * Let gem5 run ahead of SystemC by up to the TLM global quantum, like
+     * any other loosely timed initiator. This only works when transactions
+     * cross the bridge with blocking transport, as the non-blocking
+     * protocol needs gem5 and SystemC to agree on the current time.
+     */
+    tlmQuantum = tlm::tlm_global_quantum::instance().get().value();
+    updateQuantum();
+    if (tlmQuantum != 0 && quantum == 0)
+        warn("gem5 is not in atomic mode, ignoring the TLM quantum");
+}
+
+void
+Gem5SimControl::updateQuantum()
+{
+    if (tlmQuantum == 0)
+        return;
+
+    bool atomic = true;
+    for (auto *system : System::systemList)
+        atomic = atomic && system->isAtomicMode();
+
+    if (atomic) {
+        setQuantum(tlmQuantum);
+    } else if (quantum != 0) {
+        warn("gem5 left atomic mode, ignoring the TLM quantum");
+        setQuantum(0);
+    }
 }
 
 void
@@ -59,7 +59,8 @@ namespace Gem5SystemC
  * While it is mandatory to have one instance of this class for running a gem5
  * simulation in SystemC, it is not allowed to have multiple instances!
  */
-class Gem5SimControl : public Module, public Gem5SimControlInterface
+class Gem5SimControl : public Module, public Gem5SimControlInterface,
+                       public Drainable
 {
   protected:
     CxxConfigManager* config_manager;
@@ -67,6 +68,19 @@ class Gem5SimControl : public Module, public Gem5SimControlInterface
 
     Tick simulationEnd;
 
+    /** TLM global quantum gem5 may run ahead of SystemC by in atomic mode */
+    Tick tlmQuantum;
+
+    /**
+     * Use the TLM quantum while every system is in atomic mode, and keep
+     * gem5 in lockstep with SystemC otherwise.
+     */
+    void updateQuantum();
+
+    // Drainable interface. gem5 only changes memory modes while drained.
+    DrainState drain() override { return DrainState::Drained; }
+    void drainResume() override { updateQuantum(); }
+
     /*
      * Keep track of the slave and master ports that are created by gem5
      * according to the config file.